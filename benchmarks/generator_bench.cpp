@@ -0,0 +1,126 @@
+#include "zlcoro/core/chunked_generator.hpp"
+#include "zlcoro/core/generator.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <span>
+
+using namespace zlcoro;
+
+// =============================================================================
+// Generator<int> 与 ChunkedGenerator<int> 逐元素开销对比
+// =============================================================================
+//
+// items_per_second 的倒数就是每个元素的均摊开销。
+
+static Generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+static ChunkedGenerator<int> chunked_iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+// 先填充本地块再整块产生：循环不经过 co_yield
+static ChunkedGenerator<int> chunked_iota_blocks(int n) {
+    std::array<int, 256> block;
+    for (int base = 0; base < n; base += static_cast<int>(block.size())) {
+        int count = std::min(n - base, static_cast<int>(block.size()));
+        std::iota(block.begin(), block.begin() + count, base);
+        co_yield std::span<const int>(block.data(), static_cast<size_t>(count));
+    }
+}
+
+static constexpr int elements = 1 << 20;
+
+static void BM_GeneratorSum(benchmark::State& state) {
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (int x : iota(elements)) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_GeneratorSum);
+
+static void BM_ChunkedGeneratorIterate(benchmark::State& state) {
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (int x : chunked_iota(elements)) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_ChunkedGeneratorIterate);
+
+static void BM_ChunkedGeneratorReduce(benchmark::State& state) {
+    for (auto _ : state) {
+        auto sum = chunked_iota(elements).reduce(int64_t{0},
+                                                 [](int64_t acc, int x) { return acc + x; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_ChunkedGeneratorReduce);
+
+static void BM_ChunkedGeneratorSpanReduce(benchmark::State& state) {
+    for (auto _ : state) {
+        auto sum = chunked_iota_blocks(elements).reduce(
+            int64_t{0}, [](int64_t acc, int x) { return acc + x; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_ChunkedGeneratorSpanReduce);
+
+// transform + filter：Generator 逐元素，ChunkedGenerator 块上融合
+static void BM_GeneratorPipeline(benchmark::State& state) {
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (int x : iota(elements)) {
+            int y = x * 3;
+            if (y & 1) {
+                sum += y;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_GeneratorPipeline);
+
+static void BM_ChunkedGeneratorPipeline(benchmark::State& state) {
+    for (auto _ : state) {
+        auto sum = chunked_iota(elements)
+                       .transform([](int x) { return x * 3; })
+                       .filter([](int x) { return (x & 1) != 0; })
+                       .reduce(int64_t{0}, [](int64_t acc, int x) { return acc + x; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_ChunkedGeneratorPipeline);
+
+static void BM_ChunkedGeneratorSpanPipeline(benchmark::State& state) {
+    for (auto _ : state) {
+        auto sum = chunked_iota_blocks(elements)
+                       .transform([](int x) { return x * 3; })
+                       .filter([](int x) { return (x & 1) != 0; })
+                       .reduce(int64_t{0}, [](int64_t acc, int x) { return acc + x; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_ChunkedGeneratorSpanPipeline);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,139 @@
+#include "zlcoro/io.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace zlcoro;
+
+// =============================================================================
+// EventLoop 定时器增删
+// =============================================================================
+
+// 添加后立即取消（超时重置的典型模式）；range(0) 为同时存在的定时器数
+static void BM_TimerAddCancel(benchmark::State& state) {
+    EventLoop loop;
+    std::vector<EventLoop::TimerId> background;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        background.push_back(loop.add_timer(static_cast<int>(1000 + i % 60000), [] {}));
+    }
+    int delay = 0;
+    for (auto _ : state) {
+        auto id = loop.add_timer(1 + (delay++ & 4095), [] {});
+        benchmark::DoNotOptimize(loop.cancel_timer(id));
+    }
+    for (auto id : background) {
+        loop.cancel_timer(id);
+    }
+}
+BENCHMARK(BM_TimerAddCancel)->Arg(0)->Arg(10000)->Arg(1000000);
+
+// 添加 timers 个立即到期的定时器并运行事件循环直到全部触发
+static void BM_TimerFire(benchmark::State& state) {
+    constexpr int timers = 10000;
+    for (auto _ : state) {
+        EventLoop loop;
+        int fired = 0;
+        for (int i = 0; i < timers; ++i) {
+            loop.add_timer(0, [&] {
+                if (++fired == timers) {
+                    loop.stop();
+                }
+            });
+        }
+        loop.run();
+    }
+    state.SetItemsProcessed(state.iterations() * timers);
+}
+BENCHMARK(BM_TimerFire)->UseRealTime();
+
+// =============================================================================
+// 回环 TCP 回显：QPS 与 p50 / p99 延迟
+// =============================================================================
+//
+// range(0) 个客户端连接，各自发送 requests_per_connection 个 64 字节请求
+// （一问一答），服务端和客户端在同一个事件循环中。延迟以微秒为单位
+// 写入 counters，items_per_second 即 QPS。
+
+static constexpr int echo_port = 12360;
+static constexpr int requests_per_connection = 200;
+
+static double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    auto index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index),
+                     samples.end());
+    return samples[index];
+}
+
+static void BM_SocketEcho(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    const auto connections = static_cast<int>(state.range(0));
+    std::vector<double> latencies_us;
+
+    for (auto _ : state) {
+        EventLoop loop;
+        AsyncSocket listener(loop);
+        listener.create();
+        listener.set_reuse_addr(true);
+        listener.bind("127.0.0.1", echo_port);
+        listener.listen(connections);
+
+        // 客户端和服务端协程全部结束后停止事件循环
+        int finished = 0;
+        auto finish = [&] {
+            if (++finished == 2 * connections) {
+                loop.stop();
+            }
+        };
+        auto serve = [&](AsyncSocket conn) -> Task<void> {
+            while (true) {
+                std::string data = co_await conn.read();
+                if (data.empty()) {
+                    break;
+                }
+                co_await conn.write(data);
+            }
+            finish();
+        };
+        auto acceptor = [&]() -> Task<void> {
+            for (int i = 0; i < connections; ++i) {
+                loop.spawn(serve(co_await listener.accept()));
+            }
+        };
+        auto client = [&]() -> Task<void> {
+            AsyncSocket sock(loop);
+            sock.create();
+            co_await sock.connect("127.0.0.1", echo_port);
+            const std::string request(64, 'x');
+            for (int i = 0; i < requests_per_connection; ++i) {
+                auto start = Clock::now();
+                co_await sock.write(request);
+                size_t received = 0;
+                while (received < request.size()) {
+                    received += (co_await sock.read(request.size() - received)).size();
+                }
+                latencies_us.push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+            sock.close();
+            finish();
+        };
+
+        loop.spawn(acceptor());
+        for (int i = 0; i < connections; ++i) {
+            loop.spawn(client());
+        }
+        loop.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * connections * requests_per_connection);
+    state.counters["p50_us"] = percentile(latencies_us, 0.50);
+    state.counters["p99_us"] = percentile(latencies_us, 0.99);
+}
+BENCHMARK(BM_SocketEcho)->Arg(1)->Arg(16)->Arg(64)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,106 @@
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/scheduler/async.hpp"
+#include "zlcoro/scheduler/scheduler.hpp"
+#include "zlcoro/scheduler/thread_pool.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace zlcoro;
+
+// =============================================================================
+// ThreadPool 提交吞吐量与工作线程数的关系
+// =============================================================================
+//
+// 每次迭代从外部线程提交 tasks_per_iteration 个任务并等待全部执行完，
+// range(0) 为工作线程数。
+
+static constexpr int tasks_per_iteration = 10000;
+
+static void wait_for(const std::atomic<int>& counter, int expected) {
+    while (counter.load(std::memory_order_acquire) < expected) {
+        std::this_thread::yield();
+    }
+}
+
+// 普通可调用对象（慢速通道）
+static void BM_ThreadPoolSubmitClosure(benchmark::State& state) {
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::atomic<int> done{0};
+        for (int i = 0; i < tasks_per_iteration; ++i) {
+            pool.submit([&done] { done.fetch_add(1, std::memory_order_release); });
+        }
+        wait_for(done, tasks_per_iteration);
+    }
+    state.SetItemsProcessed(state.iterations() * tasks_per_iteration);
+}
+BENCHMARK(BM_ThreadPoolSubmitClosure)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+// 协程句柄（无锁注入队列）
+static void BM_ThreadPoolSubmitCoroutine(benchmark::State& state) {
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    std::atomic<int> done{0};
+    auto body = [&done]() -> Task<void> {
+        done.fetch_add(1, std::memory_order_release);
+        co_return;
+    };
+
+    std::vector<Task<void>> tasks;
+    tasks.reserve(tasks_per_iteration);
+    for (auto _ : state) {
+        state.PauseTiming();
+        tasks.clear();
+        for (int i = 0; i < tasks_per_iteration; ++i) {
+            tasks.push_back(body());
+        }
+        done.store(0, std::memory_order_relaxed);
+        state.ResumeTiming();
+
+        for (auto& task : tasks) {
+            pool.submit(task.handle());
+        }
+        wait_for(done, tasks_per_iteration);
+    }
+    state.SetItemsProcessed(state.iterations() * tasks_per_iteration);
+}
+BENCHMARK(BM_ThreadPoolSubmitCoroutine)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+// =============================================================================
+// co_await yield()：经过调度器的一次挂起 / 恢复
+// =============================================================================
+
+static void BM_ScheduleYield(benchmark::State& state) {
+    constexpr int yields = 1000;
+    auto body = []() -> Task<void> {
+        for (int i = 0; i < yields; ++i) {
+            co_await yield();
+        }
+    };
+    for (auto _ : state) {
+        async_run(body()).get();
+    }
+    state.SetItemsProcessed(state.iterations() * yields);
+}
+BENCHMARK(BM_ScheduleYield)->UseRealTime();
+
+// =============================================================================
+// 已在工作线程上的 co_await schedule()：不挂起
+// =============================================================================
+
+static void BM_ScheduleOnWorker(benchmark::State& state) {
+    constexpr int hops = 1000;
+    auto body = []() -> Task<void> {
+        for (int i = 0; i < hops; ++i) {
+            co_await schedule();
+        }
+    };
+    for (auto _ : state) {
+        async_run(body()).get();
+    }
+    state.SetItemsProcessed(state.iterations() * hops);
+}
+BENCHMARK(BM_ScheduleOnWorker)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,115 @@
+#include "zlcoro/sync.hpp"
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/scheduler/async.hpp"
+#include "zlcoro/scheduler/scheduler.hpp"
+#include "zlcoro/scheduler/when_all.hpp"
+#include <benchmark/benchmark.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace zlcoro;
+
+// =============================================================================
+// 无竞争：单线程加锁 / 解锁
+// =============================================================================
+
+static void BM_StdMutexUncontended(benchmark::State& state) {
+    std::mutex mutex;
+    int64_t counter = 0;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        benchmark::DoNotOptimize(++counter);
+    }
+}
+BENCHMARK(BM_StdMutexUncontended);
+
+static void BM_AsyncMutexUncontended(benchmark::State& state) {
+    AsyncMutex mutex;
+    int64_t counter = 0;
+    auto loop = [&]() -> Task<void> {
+        for (auto _ : state) {
+            auto lock = co_await mutex.scoped_lock();
+            benchmark::DoNotOptimize(++counter);
+        }
+    };
+    loop().sync_wait();
+}
+BENCHMARK(BM_AsyncMutexUncontended);
+
+// =============================================================================
+// 有竞争：range(0) 个执行者各自加锁 range(1) 次
+// =============================================================================
+//
+// std::mutex 使用独立线程；AsyncMutex 使用调度器上的协程，临界区内
+// co_await yield() 模拟持锁期间的挂起（std::mutex 对应 std::this_thread::yield）。
+
+static void BM_StdMutexContended(benchmark::State& state) {
+    const auto workers = static_cast<int>(state.range(0));
+    const auto iterations = static_cast<int>(state.range(1));
+    for (auto _ : state) {
+        std::mutex mutex;
+        int64_t counter = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < workers; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < iterations; ++i) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ++counter;
+                    std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * workers * iterations);
+}
+BENCHMARK(BM_StdMutexContended)->Args({4, 1000})->Args({16, 1000})->UseRealTime();
+
+static void BM_AsyncMutexContended(benchmark::State& state) {
+    const auto workers = static_cast<int>(state.range(0));
+    const auto iterations = static_cast<int>(state.range(1));
+    for (auto _ : state) {
+        AsyncMutex mutex;
+        int64_t counter = 0;
+        auto worker = [&]() -> Task<void> {
+            for (int i = 0; i < iterations; ++i) {
+                auto lock = co_await mutex.scoped_lock();
+                ++counter;
+                co_await yield();
+            }
+        };
+        auto all = [&]() -> Task<void> {
+            std::vector<Task<void>> tasks;
+            for (int t = 0; t < workers; ++t) {
+                tasks.push_back(worker());
+            }
+            co_await when_all(std::move(tasks));
+        };
+        async_run(all()).get();
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * workers * iterations);
+}
+BENCHMARK(BM_AsyncMutexContended)->Args({4, 1000})->Args({16, 1000})->UseRealTime();
+
+// =============================================================================
+// AsyncSemaphore 快速路径
+// =============================================================================
+
+static void BM_AsyncSemaphoreUncontended(benchmark::State& state) {
+    AsyncSemaphore semaphore(1);
+    auto loop = [&]() -> Task<void> {
+        for (auto _ : state) {
+            co_await semaphore.acquire();
+            semaphore.release();
+        }
+    };
+    loop().sync_wait();
+}
+BENCHMARK(BM_AsyncSemaphoreUncontended);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/core/inline_task.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <new>
+
+using namespace zlcoro;
+
+// =============================================================================
+// 全局 operator new 计数：帧缓存命中时协程链不应该调用 operator new
+// =============================================================================
+
+static size_t g_allocations = 0;  // benchmark 在单线程中运行
+
+[[gnu::noinline]] void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// 每次迭代的 operator new 调用次数
+static void report_allocations(benchmark::State& state, size_t before) {
+    state.counters["allocs_per_iter"] = benchmark::Counter(
+        static_cast<double>(g_allocations - before), benchmark::Counter::kAvgIterations);
+}
+
+// =============================================================================
+// Task 创建 / 销毁 / 嵌套 co_await
+// =============================================================================
+
+static Task<int> answer() {
+    co_return 42;
+}
+
+// depth 层嵌套 co_await：每层一次对称转移进入、一次返回
+static Task<int> chain(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return 1 + co_await chain(depth - 1);
+}
+
+static InlineTask<int> inline_chain(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return 1 + co_await inline_chain(depth - 1);
+}
+
+static Task<int> inline_root(int depth) {
+    co_return co_await inline_chain(depth);
+}
+
+// 只创建和销毁（initial_suspend 后从未恢复）
+static void BM_TaskCreateDestroy(benchmark::State& state) {
+    for (auto _ : state) {
+        auto task = answer();
+        benchmark::DoNotOptimize(task);
+    }
+}
+BENCHMARK(BM_TaskCreateDestroy);
+
+// 创建、恢复到结束、取结果、销毁
+static void BM_TaskCreateRun(benchmark::State& state) {
+    for (auto _ : state) {
+        auto task = answer();
+        task.handle().resume();
+        benchmark::DoNotOptimize(task.result());
+    }
+}
+BENCHMARK(BM_TaskCreateRun);
+
+// 对称转移链：items_per_second 的倒数是每层的开销
+static void BM_SymmetricTransferChain(benchmark::State& state) {
+    const auto depth = static_cast<int>(state.range(0));
+    const size_t before = g_allocations;
+    for (auto _ : state) {
+        auto task = chain(depth);
+        task.handle().resume();
+        benchmark::DoNotOptimize(task.result());
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+    report_allocations(state, before);
+}
+BENCHMARK(BM_SymmetricTransferChain)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// 同样的链，子协程为 InlineTask：帧压在 FrameStack 上
+static void BM_InlineTaskChain(benchmark::State& state) {
+    const auto depth = static_cast<int>(state.range(0));
+    const size_t before = g_allocations;
+    for (auto _ : state) {
+        auto task = inline_root(depth);
+        task.handle().resume();
+        benchmark::DoNotOptimize(task.result());
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+    report_allocations(state, before);
+}
+BENCHMARK(BM_InlineTaskChain)->Arg(1)->Arg(10)->Arg(100);
+
+BENCHMARK_MAIN();
@@ -38,8 +38,10 @@ Task<void> example_file_io() {
 // 示例 2: 多个文件并发操作
 // =============================================================================
 
-Task<void> write_multiple_files() {
-    std::vector<std::future<void>> futures;
+// 注意：JoinHandle::get() 会阻塞线程，只能在协程之外等待
+void example_concurrent_files() {
+    std::cout << "\n=== 示例 2: 并发文件操作 ===\n";
+    std::vector<JoinHandle<void>> futures;
     
     for (int i = 0; i < 5; ++i) {
         auto task = [i]() -> Task<void> {
@@ -58,13 +60,6 @@ Task<void> write_multiple_files() {
     for (auto& future : futures) {
         future.get();
     }
-    
-    co_return;
-}
-
-Task<void> example_concurrent_files() {
-    std::cout << "\n=== 示例 2: 并发文件操作 ===\n";
-    co_await write_multiple_files();
 }
 
 // =============================================================================
@@ -99,23 +94,23 @@ Task<void> example_large_file() {
 // =============================================================================
 
 Task<void> copy_file(const std::string& src, const std::string& dst) {
-    // 同步复制文件（在线程池中执行）
     AsyncFile src_file(src, AsyncFile::ReadOnly);
     AsyncFile dst_file(dst, AsyncFile::WriteOnly | AsyncFile::Create | AsyncFile::Truncate, 0644);
     
-    // 分块复制
-    const size_t chunk_size = 8192;
+    // 分块复制：复用同一块缓冲区，按偏移读写
+    char chunk[8192];
+    off_t offset = 0;
     while (true) {
-        std::string chunk = src_file.read(chunk_size);
-        if (chunk.empty()) {
+        size_t n = co_await src_file.read_at(offset, chunk);
+        if (n == 0) {
             break;
         }
         
-        dst_file.write(chunk);
+        co_await dst_file.write_at(offset, std::span<const char>(chunk, n));
+        offset += static_cast<off_t>(n);
     }
     
-    dst_file.sync();
-    co_return;
+    co_await dst_file.fsync();
 }
 
 Task<void> example_file_copy() {
@@ -214,10 +209,7 @@ int main() {
         }
         
         // 示例 2: 并发文件操作
-        {
-            auto future = async_run(example_concurrent_files());
-            future.get();
-        }
+        example_concurrent_files();
         
         // 示例 3: 大文件操作
         {
@@ -0,0 +1,297 @@
+#pragma once
+
+#include "zlcoro/core/frame_allocator.hpp"
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace zlcoro {
+
+// =============================================================================
+// AsyncGenerator<T> - 异步生成器协程类型
+// =============================================================================
+//
+// 与 Generator<T> 一样惰性地产生值序列，但生成器体内可以 co_await
+// （socket 读取、schedule()、sleep_for 等），消费者也通过 co_await 取值：
+//
+//   AsyncGenerator<std::string> lines(AsyncSocket& socket) {
+//       std::string pending;
+//       while (true) {
+//           auto chunk = co_await socket.read();
+//           if (chunk.empty()) break;
+//           pending += chunk;
+//           size_t pos;
+//           while ((pos = pending.find('\n')) != std::string::npos) {
+//               co_yield pending.substr(0, pos);
+//               pending.erase(0, pos + 1);
+//           }
+//       }
+//   }
+//
+//   auto gen = lines(socket);
+//   while (std::string* line = co_await gen.next()) {
+//       handle(*line);
+//   }
+//
+//   // 或者迭代器形式（相当于 for co_await）
+//   for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it) {
+//       handle(*it);
+//   }
+//
+// 核心特性:
+// - 生成器和消费者之间通过对称转移切换，不经过调度器
+// - co_yield 不拷贝值：只保存地址，值在消费者下一次 co_await next()
+//   之前一直有效（可以被消费者移动走）
+// - 生成器体内的异常在消费者的 co_await 处重新抛出
+// - 生成器体在哪个线程恢复（例如事件循环），消费者就在哪个线程继续
+// =============================================================================
+
+template <typename T>
+class AsyncGenerator {
+public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference = std::conditional_t<std::is_reference_v<T>, T, T&>;
+    using pointer = std::add_pointer_t<reference>;
+
+    class promise_type : public detail::FrameAllocated {
+    public:
+        AsyncGenerator get_return_object() noexcept {
+            return AsyncGenerator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        // 惰性：第一次 co_await next() 时才开始执行
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        // co_yield 和结束时都把控制权交还给等待的消费者
+        struct YieldAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<promise_type> coro) noexcept {
+                return coro.promise().consumer_;
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        YieldAwaiter final_suspend() noexcept {
+            value_ = nullptr;
+            return {};
+        }
+
+        // co_yield 表达式中的临时对象一直存活到生成器被恢复，可以直接保存地址
+        YieldAwaiter yield_value(std::remove_reference_t<T>& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        YieldAwaiter yield_value(std::remove_reference_t<T>&& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            exception_ = std::current_exception();
+        }
+
+        // 消费者恢复后调用：生成器结束时返回 nullptr（有异常则抛出）
+        pointer current() {
+            if (exception_) {
+                std::rethrow_exception(std::exchange(exception_, nullptr));
+            }
+            return value_;
+        }
+
+        void set_consumer(std::coroutine_handle<> consumer) noexcept {
+            consumer_ = consumer;
+        }
+
+    private:
+        std::remove_reference_t<T>* value_ = nullptr;
+        std::coroutine_handle<> consumer_;
+        std::exception_ptr exception_;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    // =========================================================================
+    // NextAwaiter - co_await next()：恢复生成器直到下一个 co_yield 或结束
+    // =========================================================================
+
+    class NextAwaiter {
+    public:
+        explicit NextAwaiter(handle_type handle) noexcept : handle_(handle) {}
+
+        bool await_ready() const noexcept {
+            return !handle_ || handle_.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+            handle_.promise().set_consumer(consumer);
+            return handle_;  // 对称转移到生成器
+        }
+
+        pointer await_resume() {
+            if (!handle_) {
+                return nullptr;
+            }
+            return handle_.promise().current();
+        }
+
+    private:
+        handle_type handle_;
+    };
+
+    // =========================================================================
+    // Iterator - co_await begin() / co_await ++it 形式的迭代
+    // =========================================================================
+
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = AsyncGenerator::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = AsyncGenerator::pointer;
+        using reference = AsyncGenerator::reference;
+
+        // 默认构造: 表示 end() 迭代器
+        Iterator() noexcept = default;
+
+        Iterator(handle_type handle, pointer value) noexcept
+            : handle_(handle), value_(value) {}
+
+        // co_await ++it：取下一个值，结束后 it == end()
+        class IncrementAwaiter {
+        public:
+            explicit IncrementAwaiter(Iterator& it) noexcept : it_(it), next_(it.handle_) {}
+
+            bool await_ready() const noexcept {
+                return next_.await_ready();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+                return next_.await_suspend(consumer);
+            }
+
+            Iterator& await_resume() {
+                it_.value_ = next_.await_resume();
+                return it_;
+            }
+
+        private:
+            Iterator& it_;
+            NextAwaiter next_;
+        };
+
+        IncrementAwaiter operator++() noexcept {
+            return IncrementAwaiter{*this};
+        }
+
+        reference operator*() const noexcept {
+            return static_cast<reference>(*value_);
+        }
+
+        pointer operator->() const noexcept {
+            return value_;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.value_ == rhs.value_;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class IncrementAwaiter;
+
+        handle_type handle_;
+        pointer value_ = nullptr;   // 为空表示已结束
+    };
+
+    class BeginAwaiter {
+    public:
+        explicit BeginAwaiter(handle_type handle) noexcept : handle_(handle), next_(handle) {}
+
+        bool await_ready() const noexcept {
+            return next_.await_ready();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+            return next_.await_suspend(consumer);
+        }
+
+        Iterator await_resume() {
+            return Iterator{handle_, next_.await_resume()};
+        }
+
+    private:
+        handle_type handle_;
+        NextAwaiter next_;
+    };
+
+    // =========================================================================
+    // AsyncGenerator 构造和析构
+    // =========================================================================
+
+    AsyncGenerator() noexcept = default;
+
+    explicit AsyncGenerator(handle_type handle) noexcept : handle_(handle) {}
+
+    AsyncGenerator(const AsyncGenerator&) = delete;
+    AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+
+    AsyncGenerator(AsyncGenerator&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    AsyncGenerator& operator=(AsyncGenerator&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    // 生成器只能在挂起状态下销毁（不能在另一个线程的 co_await next() 期间）
+    ~AsyncGenerator() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    // co_await next()：返回指向下一个值的指针，结束时返回 nullptr
+    [[nodiscard]] NextAwaiter next() noexcept {
+        return NextAwaiter{handle_};
+    }
+
+    // co_await begin()：开始迭代
+    [[nodiscard]] BeginAwaiter begin() noexcept {
+        return BeginAwaiter{handle_};
+    }
+
+    Iterator end() noexcept {
+        return Iterator{};
+    }
+
+    // 生成器是否已经结束
+    bool done() const noexcept {
+        return !handle_ || handle_.done();
+    }
+
+private:
+    handle_type handle_;
+};
+
+} // namespace zlcoro
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "zlcoro/core/task.hpp"
+#include <coroutine>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+namespace zlcoro {
+
+// =============================================================================
+// 结构化取消（std::stop_token）
+// =============================================================================
+//
+// 使用方式:
+//   std::stop_source stop;
+//   auto task = handle(conn);
+//   task.set_stop_token(stop.get_token());
+//   loop.spawn(std::move(task));
+//   ...
+//   stop.request_stop();   // 任意线程
+//
+//   Task<void> handle(AsyncSocket& conn) {
+//       auto data = co_await conn.read();   // 取消时抛出 OperationCancelled
+//       auto token = co_await get_stop_token();
+//       if (token.stop_requested()) { ... }
+//   }
+//
+// - 令牌保存在 Task 的 promise 中，co_await 子任务（以及 when_all）时
+//   沿调用链向下传递
+// - EventLoop 的 fd 就绪等待、sleep_for 和 io_uring 操作在挂起时注册
+//   std::stop_callback：请求停止后等待被撤销，协程在事件循环中恢复并
+//   抛出 OperationCancelled（io_uring 操作以 -ECANCELED 完成）
+// - 挂起之前令牌已经被请求停止时不挂起，直接抛出
+// - 取消回调只在事件循环线程中挂起的等待上注册；在其他线程中等待
+//   sleep_for 或提交 io_uring 操作时只检查挂起前的状态
+// =============================================================================
+
+// 操作因取消令牌被请求停止而结束时抛出
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled() : std::runtime_error("operation cancelled") {}
+};
+
+// co_await get_stop_token()：取出当前 Task 的取消令牌，不挂起
+class GetStopTokenAwaiter {
+public:
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    // 返回 false：只借用 await_suspend 拿到 promise，协程立即继续执行
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> coro) noexcept {
+        token_ = detail::stop_token_of(coro);
+        return false;
+    }
+
+    std::stop_token await_resume() noexcept {
+        return std::move(token_);
+    }
+
+private:
+    std::stop_token token_;
+};
+
+inline GetStopTokenAwaiter get_stop_token() noexcept {
+    return {};
+}
+
+} // namespace zlcoro
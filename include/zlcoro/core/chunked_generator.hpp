@@ -0,0 +1,422 @@
+#pragma once
+
+#include "zlcoro/core/frame_allocator.hpp"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// ChunkedGenerator<T, ChunkSize> - 按块产生值的生成器
+// =============================================================================
+//
+// Generator<T> 每个元素都要恢复一次协程，并且需要一次指针间接访问和
+// 一次 done() 检查。对于大量小元素的数值流水线，这些开销占了主导。
+//
+// ChunkedGenerator 的写法与 Generator 相同（co_yield 单个值），但值被
+// 追加到 promise 中大小为 ChunkSize 的缓冲区里，只有缓冲区满时协程才
+// 真正挂起。消费者每次拿到一个 std::span<const T>：
+// - 恢复开销按 ChunkSize 均摊
+// - 块内是连续数组上的普通循环，编译器可以向量化
+//
+// 使用方式:
+//   ChunkedGenerator<int> iota(int n) {
+//       for (int i = 0; i < n; ++i) {
+//           co_yield i;           // 大多数情况下不挂起
+//       }
+//   }
+//
+//   for (int x : iota(100)) { ... }                    // 逐元素（按块缓冲）
+//
+//   iota(100).for_each_chunk([](std::span<const int> chunk) { ...; return true; });
+//
+//   // 适配器在块上融合：每一级对整个块做一次紧凑循环
+//   auto v = iota(1000)
+//                .transform([](int x) { return x * x; })
+//                .filter([](int x) { return x % 3 == 0; })
+//                .take(10)
+//                .to_vector();
+//
+// 生成器体也可以 co_yield std::span<const T>，整段数据不经过缓冲区，
+// 直接按 ChunkSize 切分交给消费者。逐个 co_yield 时循环变量保存在协程帧
+// 中（GCC 会在每次迭代读写内存），最热的生产者适合先填充本地数组再整块产生。
+//
+// 注意：
+// - T 需要可默认构造、可赋值（缓冲区是 std::array<T, ChunkSize>）
+// - 块只在下一次恢复生成器之前有效
+// - 适配器按值持有上游（ChunkedGenerator 是仅移动类型，需要 std::move）
+// =============================================================================
+
+template <typename T, size_t ChunkSize>
+class ChunkedGenerator;
+
+namespace detail {
+
+// =============================================================================
+// ChunkedViewBase - 块源的公共接口（CRTP）
+// =============================================================================
+//
+// 派生类实现推送式接口：
+//   template <typename Sink> void for_each_chunk(Sink&& sink);
+// sink 以 std::span<const value_type> 调用，返回 false 表示停止。
+// =============================================================================
+
+template <typename Derived>
+class ChunkedViewBase;
+
+template <typename Source, typename F>
+class ChunkedTransformView;
+
+template <typename Source, typename Pred>
+class ChunkedFilterView;
+
+template <typename Source>
+class ChunkedTakeView;
+
+template <typename Derived>
+class ChunkedViewBase {
+public:
+    // 对每个元素调用 f；内层是块上的普通循环
+    template <typename F>
+    void for_each(F&& f) && {
+        derived().for_each_chunk([&](auto chunk) {
+            for (const auto& value : chunk) {
+                f(value);
+            }
+            return true;
+        });
+    }
+
+    // 收集所有元素
+    auto to_vector() && {
+        using value_type = typename Derived::value_type;
+        std::vector<value_type> result;
+        derived().for_each_chunk([&](std::span<const value_type> chunk) {
+            result.insert(result.end(), chunk.begin(), chunk.end());
+            return true;
+        });
+        return result;
+    }
+
+    // 以 op 从 init 开始折叠所有元素
+    template <typename Acc, typename Op>
+    Acc reduce(Acc init, Op&& op) && {
+        derived().for_each_chunk([&](auto chunk) {
+            for (const auto& value : chunk) {
+                init = op(std::move(init), value);
+            }
+            return true;
+        });
+        return init;
+    }
+
+    // 每个元素映射为 f(x)
+    template <typename F>
+    ChunkedTransformView<Derived, std::decay_t<F>> transform(F&& f) && {
+        return {std::move(derived()), std::forward<F>(f)};
+    }
+
+    // 只保留 pred(x) 为 true 的元素
+    template <typename Pred>
+    ChunkedFilterView<Derived, std::decay_t<Pred>> filter(Pred&& pred) && {
+        return {std::move(derived()), std::forward<Pred>(pred)};
+    }
+
+    // 只取前 count 个元素，之后不再恢复上游
+    ChunkedTakeView<Derived> take(size_t count) && {
+        return {std::move(derived()), count};
+    }
+
+private:
+    Derived& derived() noexcept {
+        return static_cast<Derived&>(*this);
+    }
+};
+
+template <typename Source, typename F>
+class ChunkedTransformView : public ChunkedViewBase<ChunkedTransformView<Source, F>> {
+    using input_type = typename Source::value_type;
+
+public:
+    using value_type = std::remove_cvref_t<std::invoke_result_t<F&, const input_type&>>;
+    static constexpr size_t chunk_size = Source::chunk_size;
+
+    ChunkedTransformView(Source source, F f) : source_(std::move(source)), f_(std::move(f)) {}
+
+    template <typename Sink>
+    void for_each_chunk(Sink&& sink) {
+        std::array<value_type, chunk_size> out;
+        source_.for_each_chunk([&](std::span<const input_type> in) {
+            const size_t n = in.size();
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = f_(in[i]);
+            }
+            return sink(std::span<const value_type>(out.data(), n));
+        });
+    }
+
+private:
+    Source source_;
+    F f_;
+};
+
+template <typename Source, typename Pred>
+class ChunkedFilterView : public ChunkedViewBase<ChunkedFilterView<Source, Pred>> {
+public:
+    using value_type = typename Source::value_type;
+    static constexpr size_t chunk_size = Source::chunk_size;
+
+    ChunkedFilterView(Source source, Pred pred)
+        : source_(std::move(source)), pred_(std::move(pred)) {}
+
+    template <typename Sink>
+    void for_each_chunk(Sink&& sink) {
+        std::array<value_type, chunk_size> out;
+        source_.for_each_chunk([&](std::span<const value_type> in) {
+            // 无分支压缩：先写入，再按谓词决定是否前进
+            size_t kept = 0;
+            for (const auto& value : in) {
+                out[kept] = value;
+                kept += static_cast<size_t>(static_cast<bool>(pred_(value)));
+            }
+            return kept == 0 || sink(std::span<const value_type>(out.data(), kept));
+        });
+    }
+
+private:
+    Source source_;
+    Pred pred_;
+};
+
+template <typename Source>
+class ChunkedTakeView : public ChunkedViewBase<ChunkedTakeView<Source>> {
+public:
+    using value_type = typename Source::value_type;
+    static constexpr size_t chunk_size = Source::chunk_size;
+
+    ChunkedTakeView(Source source, size_t count) : source_(std::move(source)), count_(count) {}
+
+    template <typename Sink>
+    void for_each_chunk(Sink&& sink) {
+        size_t remaining = count_;
+        if (remaining == 0) {
+            return;
+        }
+        source_.for_each_chunk([&](std::span<const value_type> in) {
+            auto part = in.first(std::min(remaining, in.size()));
+            remaining -= part.size();
+            return sink(part) && remaining > 0;
+        });
+    }
+
+private:
+    Source source_;
+    size_t count_;
+};
+
+} // namespace detail
+
+template <typename T, size_t ChunkSize = 256>
+class ChunkedGenerator : public detail::ChunkedViewBase<ChunkedGenerator<T, ChunkSize>> {
+    static_assert(ChunkSize > 0, "ChunkSize must be positive");
+    static_assert(std::is_default_constructible_v<T>, "ChunkedGenerator requires a default-constructible T");
+
+public:
+    using value_type = T;
+    static constexpr size_t chunk_size = ChunkSize;
+
+    class promise_type : public detail::FrameAllocated {
+    public:
+        ChunkedGenerator get_return_object() noexcept {
+            return ChunkedGenerator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        // 缓冲区未满时 await_ready 为 true，协程不挂起
+        struct YieldAwaiter {
+            bool full;
+
+            bool await_ready() const noexcept {
+                return !full;
+            }
+
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+
+            void await_resume() const noexcept {}
+        };
+
+        template <typename U>
+            requires std::assignable_from<T&, U&&>
+        YieldAwaiter yield_value(U&& value) noexcept(std::is_nothrow_assignable_v<T&, U&&>) {
+            buffer_[count_] = std::forward<U>(value);
+            return YieldAwaiter{++count_ == ChunkSize};
+        }
+
+        // 整块产生：不拷贝，消费者直接按 ChunkSize 切分 values
+        // （values 指向的数据在协程下一次恢复之前必须保持有效）
+        std::suspend_always yield_value(std::span<const T> values) noexcept {
+            pending_ = values;
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            exception_ = std::current_exception();
+        }
+
+        // 丢弃当前块，返回下一块（结束时为空）：
+        // 先取完整块产生的数据，再恢复协程
+        std::span<const T> next_chunk() {
+            count_ = 0;
+            auto handle = std::coroutine_handle<promise_type>::from_promise(*this);
+            while (pending_.empty()) {
+                if (handle.done()) {
+                    return {};
+                }
+                handle.resume();
+                if (exception_) {
+                    std::rethrow_exception(std::exchange(exception_, nullptr));
+                }
+                if (count_ > 0) {
+                    return {buffer_.data(), count_};  // 整块之前缓冲的单个值
+                }
+            }
+            auto chunk = pending_.first(std::min(pending_.size(), ChunkSize));
+            pending_ = pending_.subspan(chunk.size());
+            return chunk;
+        }
+
+    private:
+        std::array<T, ChunkSize> buffer_{};
+        size_t count_ = 0;
+        std::span<const T> pending_;   // co_yield span 产生、尚未交给消费者的部分
+        std::exception_ptr exception_;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    // =========================================================================
+    // Iterator - 逐元素迭代；只有块边界才恢复协程
+    // =========================================================================
+
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        Iterator() noexcept = default;
+
+        explicit Iterator(handle_type handle) : handle_(handle) {
+            refill();
+        }
+
+        Iterator& operator++() {
+            if (++current_ == last_) {
+                refill();
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            ++(*this);
+        }
+
+        reference operator*() const noexcept {
+            return *current_;
+        }
+
+        pointer operator->() const noexcept {
+            return current_;
+        }
+
+        friend bool operator==(const Iterator& it, std::default_sentinel_t) noexcept {
+            return it.current_ == nullptr;
+        }
+
+    private:
+        void refill() {
+            auto chunk = handle_.promise().next_chunk();
+            if (chunk.empty()) {
+                current_ = last_ = nullptr;
+            } else {
+                current_ = chunk.data();
+                last_ = chunk.data() + chunk.size();
+            }
+        }
+
+        handle_type handle_;
+        const T* current_ = nullptr;
+        const T* last_ = nullptr;
+    };
+
+    explicit ChunkedGenerator(handle_type handle) noexcept : handle_(handle) {}
+
+    ChunkedGenerator(const ChunkedGenerator&) = delete;
+    ChunkedGenerator& operator=(const ChunkedGenerator&) = delete;
+
+    ChunkedGenerator(ChunkedGenerator&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    ChunkedGenerator& operator=(ChunkedGenerator&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~ChunkedGenerator() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    Iterator begin() {
+        return handle_ ? Iterator{handle_} : Iterator{};
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+    // 对每个块调用 sink(std::span<const T>)，sink 返回 false 时停止
+    template <typename Sink>
+    void for_each_chunk(Sink&& sink) {
+        if (!handle_) {
+            return;
+        }
+        while (true) {
+            auto chunk = handle_.promise().next_chunk();
+            if (chunk.empty() || !sink(chunk)) {
+                return;
+            }
+        }
+    }
+
+private:
+    handle_type handle_;
+};
+
+} // namespace zlcoro
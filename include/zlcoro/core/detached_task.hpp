@@ -0,0 +1,55 @@
+#pragma once
+
+#include "zlcoro/core/frame_allocator.hpp"
+#include "zlcoro/core/task.hpp"
+#include <coroutine>
+#include <utility>
+
+namespace zlcoro {
+namespace detail {
+
+// =============================================================================
+// DetachedTask - 自我销毁的协程
+// =============================================================================
+//
+// 用于在某个执行器（EventLoop、Scheduler）上启动一个不需要等待结果的 Task。
+// - 创建后挂起，调用者负责通过 handle() 把它交给执行器恢复
+// - 结束时 final_suspend 返回 suspend_never，帧自动销毁
+// - 与 fire_and_forget 一致：协程中未捕获的异常被忽略
+//
+// 注意：DetachedTask 对象不拥有协程帧，创建后必须被恢复，否则帧会泄漏。
+// =============================================================================
+
+class DetachedTask {
+public:
+    struct promise_type : FrameAllocated {
+        DetachedTask get_return_object() noexcept {
+            return DetachedTask{
+                std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+
+    explicit DetachedTask(std::coroutine_handle<promise_type> coro) noexcept
+        : coro_(coro) {}
+
+    std::coroutine_handle<> handle() const noexcept {
+        return coro_;
+    }
+
+private:
+    std::coroutine_handle<promise_type> coro_;
+};
+
+// 包装一个 Task：等待它完成后自动销毁自身（连同 Task 的帧）
+template <typename T>
+DetachedTask make_detached(Task<T> task) {
+    co_await task;
+}
+
+} // namespace detail
+} // namespace zlcoro
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <coroutine>
+#include <utility>
+
+namespace zlcoro {
+
+// =============================================================================
+// Executor - 可以恢复协程的执行上下文（ThreadPool / EventLoop）
+// =============================================================================
+//
+// ThreadPool 的工作线程和 EventLoop::run() 在运行期间把自己登记为当前
+// 线程的执行器。Awaiter 据此判断是否真的需要切换线程：
+//   co_await resume_on(loop);   // 已经在 loop 的线程上时不挂起
+//   co_await yield();           // 总是挂起，排到当前执行器的队列尾部
+// =============================================================================
+
+class Executor {
+public:
+    // 把 coro 排到执行器队列的尾部（任意线程都可以调用）
+    virtual void execute(std::coroutine_handle<> coro) = 0;
+
+    // 当前线程正在运行的执行器（不在任何执行器中时返回 nullptr）
+    static Executor* current() noexcept {
+        return current_;
+    }
+
+    // 当前线程是否在运行本执行器
+    bool is_current() const noexcept {
+        return current_ == this;
+    }
+
+protected:
+    ~Executor() = default;
+
+    // 在作用域内把 executor 登记为当前线程的执行器，退出时恢复原值
+    class CurrentScope {
+    public:
+        explicit CurrentScope(Executor* executor) noexcept
+            : previous_(std::exchange(current_, executor)) {}
+
+        CurrentScope(const CurrentScope&) = delete;
+        CurrentScope& operator=(const CurrentScope&) = delete;
+
+        ~CurrentScope() {
+            current_ = previous_;
+        }
+
+    private:
+        Executor* previous_;
+    };
+
+private:
+    static inline thread_local Executor* current_ = nullptr;
+};
+
+// =============================================================================
+// ResumeOnAwaiter - co_await resume_on(executor)：在 executor 上继续执行
+// =============================================================================
+
+class ResumeOnAwaiter {
+public:
+    explicit ResumeOnAwaiter(Executor& executor) noexcept : executor_(&executor) {}
+
+    // 已经在目标执行器上：不切换
+    bool await_ready() const noexcept {
+        return executor_->is_current();
+    }
+
+    void await_suspend(std::coroutine_handle<> coro) {
+        executor_->execute(coro);
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    Executor* executor_;
+};
+
+inline ResumeOnAwaiter resume_on(Executor& executor) noexcept {
+    return ResumeOnAwaiter{executor};
+}
+
+} // namespace zlcoro
@@ -0,0 +1,525 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 在 AddressSanitizer 下默认关闭帧缓存，避免掩盖 use-after-free
+#if !defined(ZLCORO_NO_FRAME_POOL)
+#  if defined(__SANITIZE_ADDRESS__)
+#    define ZLCORO_NO_FRAME_POOL
+#  elif defined(__has_feature)
+#    if __has_feature(address_sanitizer)
+#      define ZLCORO_NO_FRAME_POOL
+#    endif
+#  endif
+#endif
+
+namespace zlcoro {
+
+// =============================================================================
+// FramePool - 协程帧的线程本地分级缓存
+// =============================================================================
+//
+// 协程帧默认通过全局 operator new 分配。对于大量短命的 Task，
+// 这会让 malloc 成为热点。FramePool 按 64 字节粒度划分大小级别，
+// 每个线程维护一组空闲链表：
+// - 分配：优先从本线程对应级别的空闲链表取
+// - 释放：放回当前线程的空闲链表（可能与分配线程不同），超过上限则归还系统
+// - 超过 max_pooled_size 的帧直接走全局 operator new
+//
+// 定义 ZLCORO_NO_FRAME_POOL 可以关闭缓存（ASan 构建下自动关闭）。
+// =============================================================================
+
+class FramePool {
+public:
+    static constexpr size_t granularity = 64;           // 大小级别粒度
+    static constexpr size_t max_pooled_size = 2048;     // 可缓存的最大帧
+    static constexpr size_t max_cached_per_class = 256; // 每级别每线程最多缓存块数
+
+    static void* allocate(size_t size) {
+#if !defined(ZLCORO_NO_FRAME_POOL)
+        if (size <= max_pooled_size) {
+            if (ThreadCache* cache = local_cache()) {
+                FreeList& list = cache->lists[size_class(size)];
+                if (Node* node = list.head) {
+                    list.head = node->next;
+                    --list.count;
+                    return node;
+                }
+                return ::operator new(class_size(size_class(size)));
+            }
+            return ::operator new(class_size(size_class(size)));
+        }
+#endif
+        return ::operator new(size);
+    }
+
+    static void deallocate(void* ptr, size_t size) noexcept {
+#if !defined(ZLCORO_NO_FRAME_POOL)
+        if (size <= max_pooled_size) {
+            if (ThreadCache* cache = local_cache()) {
+                FreeList& list = cache->lists[size_class(size)];
+                if (list.count < max_cached_per_class) {
+                    Node* node = ::new (ptr) Node{list.head};
+                    list.head = node;
+                    ++list.count;
+                    return;
+                }
+            }
+        }
+#else
+        (void)size;
+#endif
+        ::operator delete(ptr);
+    }
+
+    // 当前线程缓存的空闲块数量（调试/测试用）
+    static size_t cached_blocks() noexcept {
+        size_t total = 0;
+#if !defined(ZLCORO_NO_FRAME_POOL)
+        if (ThreadCache* cache = local_cache()) {
+            for (const auto& list : cache->lists) {
+                total += list.count;
+            }
+        }
+#endif
+        return total;
+    }
+
+    // 是否启用了缓存
+    static constexpr bool enabled() noexcept {
+#if defined(ZLCORO_NO_FRAME_POOL)
+        return false;
+#else
+        return true;
+#endif
+    }
+
+private:
+    static constexpr size_t num_classes = max_pooled_size / granularity;
+
+    struct Node {
+        Node* next;
+    };
+
+    struct FreeList {
+        Node* head = nullptr;
+        size_t count = 0;
+    };
+
+    enum class CacheState : uint8_t { Uninitialized, Alive, Destroyed };
+
+    struct ThreadCache {
+        FreeList lists[num_classes];
+
+        ThreadCache() noexcept {
+            state() = CacheState::Alive;
+        }
+
+        ~ThreadCache() {
+            for (auto& list : lists) {
+                while (Node* node = list.head) {
+                    list.head = node->next;
+                    ::operator delete(node);
+                }
+                list.count = 0;
+            }
+            // 线程退出后仍可能有帧被释放（例如 thread_local 对象持有 Task），
+            // 之后的分配/释放直接走全局 operator new/delete
+            state() = CacheState::Destroyed;
+        }
+    };
+
+    // 可平凡析构的状态标记，线程退出后依然可以安全读取
+    static CacheState& state() noexcept {
+        static thread_local CacheState s = CacheState::Uninitialized;
+        return s;
+    }
+
+    static ThreadCache* local_cache() noexcept {
+        if (state() == CacheState::Destroyed) {
+            return nullptr;
+        }
+        static thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    static constexpr size_t size_class(size_t size) noexcept {
+        return size == 0 ? 0 : (size - 1) / granularity;
+    }
+
+    static constexpr size_t class_size(size_t cls) noexcept {
+        return (cls + 1) * granularity;
+    }
+};
+
+// =============================================================================
+// FrameStack - InlineTask 协程帧的线程本地栈
+// =============================================================================
+//
+// 直接被父协程 co_await 的叶子协程和函数调用一样按 LIFO 顺序创建、销毁。
+// FrameStack 给每个线程一块连续内存：分配只移动栈顶，释放栈顶的帧时回退，
+// 父协程的帧之上紧挨着子协程的帧。
+// - 不在栈顶的帧（挂起期间其他协程压入了新帧）只标记为已释放，
+//   上面的帧都释放后一起回退
+// - 在其他线程释放的帧也只做标记（原子操作），由所属线程回退
+// - 栈空间不足或线程退出后的分配退化到 FramePool
+//
+// 每个帧前有一个 Header：
+//   [ Header | 协程帧 ][ Header | 协程帧 ] ... 栈顶
+// =============================================================================
+
+class FrameStack {
+public:
+    static constexpr size_t capacity = 64 * 1024;  // 每个线程的栈大小
+
+    static void* allocate(size_t size) {
+        const size_t total = sizeof(Header) + align_up(size);
+#if !defined(ZLCORO_NO_FRAME_POOL)
+        if (FrameStack* stack = local_stack()) {
+            if (stack->top_ + total > capacity) {
+                stack->pop_freed();  // 回收在其他线程释放的栈顶帧后再试一次
+            }
+            if (stack->top_ + total <= capacity) {
+                return stack->push(total);
+            }
+        }
+#endif
+        auto* header = ::new (FramePool::allocate(total)) Header{nullptr, total, npos, {false}};
+        return header + 1;
+    }
+
+    static void deallocate(void* frame) noexcept {
+        Header* header = static_cast<Header*>(frame) - 1;
+        FrameStack* owner = header->owner;
+        if (!owner) {
+            FramePool::deallocate(header, header->size);
+            return;
+        }
+        if (owner != local_stack()) {
+            header->freed.store(true, std::memory_order_release);  // 由所属线程回退
+            return;
+        }
+        if (reinterpret_cast<std::byte*>(header) != owner->base_ + owner->last_) {
+            header->freed.store(true, std::memory_order_relaxed);  // 不在栈顶：留下空洞
+            return;
+        }
+        owner->top_ = owner->last_;
+        owner->last_ = header->prev;
+        owner->pop_freed();
+    }
+
+    // 当前线程栈上已占用的字节数（含已释放但还没有回退的帧，调试/测试用）
+    static size_t used() noexcept {
+#if !defined(ZLCORO_NO_FRAME_POOL)
+        if (FrameStack* stack = local_stack()) {
+            return stack->top_;
+        }
+#endif
+        return 0;
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct alignas(std::max_align_t) Header {
+        FrameStack* owner;        // 为空时帧来自 FramePool
+        size_t size;              // 含 Header 的块大小
+        size_t prev;              // 下面一个块的偏移（npos 表示栈底）
+        std::atomic<bool> freed;
+    };
+
+    FrameStack() noexcept {
+        state() = State::Alive;
+    }
+
+    ~FrameStack() {
+        // 还有帧没有释放（例如被其他线程持有）时保留内存，之后只会被标记
+        if (last_ == npos) {
+            ::operator delete(base_, std::align_val_t{alignof(std::max_align_t)});
+        }
+        state() = State::Destroyed;
+    }
+
+    static constexpr size_t align_up(size_t n) noexcept {
+        return (n + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    }
+
+    void* push(size_t total) {
+        if (!base_) {
+            base_ = static_cast<std::byte*>(
+                ::operator new(capacity, std::align_val_t{alignof(std::max_align_t)}));
+        }
+        auto* header = ::new (base_ + top_) Header{this, total, last_, {false}};
+        last_ = top_;
+        top_ += total;
+        return header + 1;
+    }
+
+    void pop_freed() noexcept {
+        while (last_ != npos) {
+            auto* header = reinterpret_cast<Header*>(base_ + last_);
+            if (!header->freed.load(std::memory_order_acquire)) {
+                break;
+            }
+            top_ = last_;
+            last_ = header->prev;
+        }
+    }
+
+    enum class State : uint8_t { Uninitialized, Alive, Destroyed };
+
+    static State& state() noexcept {
+        static thread_local State s = State::Uninitialized;
+        return s;
+    }
+
+    static FrameStack* local_stack() noexcept {
+        if (state() == State::Destroyed) {
+            return nullptr;
+        }
+        static thread_local FrameStack stack;
+        return &stack;
+    }
+
+    std::byte* base_ = nullptr;  // 第一次分配时申请
+    size_t top_ = 0;             // 栈顶偏移
+    size_t last_ = npos;         // 最上面一个块的偏移
+};
+
+// =============================================================================
+// FrameArena - 按请求分配的协程帧内存池
+// =============================================================================
+//
+// 一个请求的所有协程帧从同一块连续内存中顺序分配（bump pointer），
+// 释放是空操作，整块内存在 FrameArena 析构或 reset() 时统一回收。
+//
+// 通过 allocator_arg 约定传给协程：
+//   Task<int> handle(std::allocator_arg_t, ArenaAllocator<std::byte> alloc, int x);
+//
+//   FrameArena arena;
+//   auto task = handle(std::allocator_arg, arena.allocator(), 42);
+//
+// 注意：FrameArena 必须比从它分配的所有协程活得更久，且不是线程安全的。
+// =============================================================================
+
+template <typename T>
+class ArenaAllocator;
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t block_size = 4096) : block_size_(block_size) {}
+
+    // 禁止拷贝和移动（分配器持有指向 arena 的指针）
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    ~FrameArena() {
+        release();
+    }
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        size_t offset = align_up(offset_, alignment);
+        if (blocks_.empty() || offset + size > current_size_) {
+            new_block(size + alignment);
+            offset = align_up(offset_, alignment);
+        }
+        void* ptr = blocks_.back() + offset;
+        offset_ = offset + size;
+        bytes_used_ += size;
+        return ptr;
+    }
+
+    // 单个帧的释放是空操作，内存在 reset() / 析构时统一回收
+    void deallocate(void*, size_t) noexcept {}
+
+    // 释放所有内存块（调用者需保证所有帧都已销毁）
+    void reset() noexcept {
+        release();
+    }
+
+    // 已分配的字节数（不含对齐填充）
+    size_t bytes_used() const noexcept {
+        return bytes_used_;
+    }
+
+    ArenaAllocator<std::byte> allocator() noexcept;
+
+private:
+    static size_t align_up(size_t n, size_t alignment) noexcept {
+        return (n + alignment - 1) & ~(alignment - 1);
+    }
+
+    void new_block(size_t min_size) {
+        size_t size = min_size > block_size_ ? min_size : block_size_;
+        blocks_.push_back(static_cast<std::byte*>(
+            ::operator new(size, std::align_val_t{alignof(std::max_align_t)})));
+        current_size_ = size;
+        offset_ = 0;
+    }
+
+    void release() noexcept {
+        for (std::byte* block : blocks_) {
+            ::operator delete(block, std::align_val_t{alignof(std::max_align_t)});
+        }
+        blocks_.clear();
+        current_size_ = 0;
+        offset_ = 0;
+        bytes_used_ = 0;
+    }
+
+private:
+    size_t block_size_;
+    std::vector<std::byte*> blocks_;
+    size_t current_size_ = 0;
+    size_t offset_ = 0;
+    size_t bytes_used_ = 0;
+};
+
+// 满足标准 Allocator 要求的 FrameArena 适配器
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) noexcept : arena_(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        arena_->deallocate(ptr, n * sizeof(T));
+    }
+
+    FrameArena* arena() const noexcept {
+        return arena_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+
+private:
+    FrameArena* arena_;
+};
+
+inline ArenaAllocator<std::byte> FrameArena::allocator() noexcept {
+    return ArenaAllocator<std::byte>(*this);
+}
+
+namespace detail {
+
+// =============================================================================
+// FrameAllocated - 为 Promise 类型提供 operator new / operator delete
+// =============================================================================
+//
+// 帧尾部追加一个释放函数指针：
+// - 默认路径：指针为空，帧来自 FramePool
+// - allocator_arg 路径：指针指向对应分配器的释放函数，分配器副本紧随其后
+//
+//   [ 协程帧 | 释放函数指针 | (分配器副本) ]
+// =============================================================================
+
+class FrameAllocated {
+    using DeallocFn = void (*)(void* frame, size_t frame_size) noexcept;
+
+    // 与默认 new 对齐一致的分配单元，用于 rebind 标准分配器
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Block {
+        std::byte bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+    };
+
+    static constexpr size_t align_up(size_t n, size_t alignment) noexcept {
+        return (n + alignment - 1) & ~(alignment - 1);
+    }
+
+    static constexpr size_t fn_offset(size_t frame_size) noexcept {
+        return align_up(frame_size, alignof(DeallocFn));
+    }
+
+    template <typename Alloc>
+    static constexpr size_t alloc_offset(size_t frame_size) noexcept {
+        return align_up(fn_offset(frame_size) + sizeof(DeallocFn), alignof(Alloc));
+    }
+
+    template <typename Alloc>
+    static constexpr size_t block_count(size_t frame_size) noexcept {
+        return (alloc_offset<Alloc>(frame_size) + sizeof(Alloc) + sizeof(Block) - 1)
+               / sizeof(Block);
+    }
+
+    static DeallocFn& dealloc_fn(void* frame, size_t frame_size) noexcept {
+        return *reinterpret_cast<DeallocFn*>(
+            static_cast<std::byte*>(frame) + fn_offset(frame_size));
+    }
+
+    template <typename Alloc>
+    static void* allocate_with(const Alloc& alloc, size_t size) {
+        using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+        BlockAlloc block_alloc(alloc);
+
+        void* frame = std::allocator_traits<BlockAlloc>::allocate(
+            block_alloc, block_count<BlockAlloc>(size));
+        ::new (static_cast<std::byte*>(frame) + alloc_offset<BlockAlloc>(size))
+            BlockAlloc(std::move(block_alloc));
+        dealloc_fn(frame, size) = &deallocate_with<BlockAlloc>;
+        return frame;
+    }
+
+    template <typename BlockAlloc>
+    static void deallocate_with(void* frame, size_t size) noexcept {
+        auto* stored = std::launder(reinterpret_cast<BlockAlloc*>(
+            static_cast<std::byte*>(frame) + alloc_offset<BlockAlloc>(size)));
+        BlockAlloc block_alloc(std::move(*stored));
+        std::destroy_at(stored);
+        std::allocator_traits<BlockAlloc>::deallocate(
+            block_alloc, static_cast<Block*>(frame), block_count<BlockAlloc>(size));
+    }
+
+public:
+    // 默认路径：线程本地分级缓存
+    static void* operator new(size_t size) {
+        void* frame = FramePool::allocate(fn_offset(size) + sizeof(DeallocFn));
+        dealloc_fn(frame, size) = nullptr;
+        return frame;
+    }
+
+    // allocator_arg 约定（自由函数协程）
+    // 两个模板重载强制内联：协程帧总是由下面的非模板 operator delete 释放，
+    // 不内联时 GCC 会把"模板 operator new + 非模板 operator delete"误报为
+    // -Wmismatched-new-delete（编译器从不调用配对的 placement delete，添加它也消不掉）
+    template <typename Alloc, typename... Args>
+    [[gnu::always_inline]] static void* operator new(size_t size, std::allocator_arg_t,
+                                                     const Alloc& alloc, const Args&...) {
+        return allocate_with(alloc, size);
+    }
+
+    // allocator_arg 约定（成员函数协程，第一个参数是 *this）
+    template <typename This, typename Alloc, typename... Args>
+    [[gnu::always_inline]] static void* operator new(size_t size, const This&,
+                                                     std::allocator_arg_t,
+                                                     const Alloc& alloc, const Args&...) {
+        return allocate_with(alloc, size);
+    }
+
+    static void operator delete(void* frame, size_t size) noexcept {
+        if (DeallocFn fn = dealloc_fn(frame, size)) {
+            fn(frame, size);
+        } else {
+            FramePool::deallocate(frame, fn_offset(size) + sizeof(DeallocFn));
+        }
+    }
+};
+
+} // namespace detail
+
+} // namespace zlcoro
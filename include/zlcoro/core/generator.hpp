@@ -1,9 +1,12 @@
 #pragma once
 
+#include "zlcoro/core/frame_allocator.hpp"
 #include <coroutine>
 #include <exception>
 #include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <utility>
 
 namespace zlcoro {
 
@@ -37,7 +40,8 @@ public:
     // =========================================================================
     // Promise Type - 定义 Generator 协程的行为
     // =========================================================================
-    class promise_type {
+    // 继承 FrameAllocated：协程帧走 FramePool，也支持 allocator_arg 约定
+    class promise_type : public detail::FrameAllocated {
     public:
         // 构造时不需要存储值
         promise_type() noexcept : value_ptr_(nullptr) {}
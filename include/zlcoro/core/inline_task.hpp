@@ -0,0 +1,152 @@
+#pragma once
+
+#include "zlcoro/core/frame_allocator.hpp"
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/core/trace.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace zlcoro {
+
+template <typename T>
+class InlineTask;
+
+// =============================================================================
+// InlineTask<T> - 帧分配在线程本地 FrameStack 上的 Task
+// =============================================================================
+//
+// 与 Task<T> 的行为相同（惰性启动、对称转移、异常传播、继承取消令牌），
+// 区别在于协程帧的位置：Task 的帧来自 FramePool（按大小级别的空闲链表），
+// InlineTask 的帧压在 FrameStack 上，紧挨着父协程的子帧，分配和释放只是
+// 移动栈顶，适合被直接 co_await 的小叶子协程：
+//   InlineTask<size_t> parse_header(std::string_view line);
+//
+//   Task<void> handle(...) {
+//       size_t len = co_await parse_header(line);   // 不经过 FramePool
+//   }
+//
+// 注意：
+// - 只能 co_await（没有 sync_wait / spawn），应该在创建它的完整表达式中等待
+// - 不支持 allocator_arg 约定
+// - 可以挂起、在其他线程完成；在其他线程释放的帧由创建线程回收
+// =============================================================================
+
+namespace detail {
+
+template <typename T>
+class InlineTaskPromise : public TaskPromise<T> {
+public:
+    InlineTask<T> get_return_object() noexcept;
+
+    static void* operator new(size_t size) {
+        return FrameStack::allocate(size);
+    }
+
+    static void operator delete(void* frame) noexcept {
+        FrameStack::deallocate(frame);
+    }
+};
+
+} // namespace detail
+
+template <typename T = void>
+class ZLCORO_CORO_AWAIT_ELIDABLE InlineTask {
+public:
+    using promise_type = detail::InlineTaskPromise<T>;
+    using value_type = T;
+
+    explicit InlineTask(std::coroutine_handle<promise_type> coro) noexcept : coro_(coro) {}
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    InlineTask(InlineTask&& other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+
+    InlineTask& operator=(InlineTask&& other) noexcept {
+        if (this != &other) {
+            if (coro_) {
+                coro_.destroy();
+            }
+            coro_ = std::exchange(other.coro_, {});
+        }
+        return *this;
+    }
+
+    ~InlineTask() {
+        if (coro_) {
+            coro_.destroy();
+        }
+    }
+
+    bool valid() const noexcept {
+        return coro_ != nullptr;
+    }
+
+    // 与 Task<T>::Awaiter 相同
+    struct Awaiter {
+        std::coroutine_handle<promise_type> coro_;
+        std::coroutine_handle<> awaiting_ = nullptr;   // 只在启用追踪时记录
+
+        bool await_ready() const noexcept {
+            return !coro_ || coro_.done();
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<Promise> awaiting_coro) noexcept {
+            coro_.promise().set_continuation(awaiting_coro);
+            detail::inherit_stop_token(coro_.promise(), awaiting_coro);
+            if constexpr (tracing_enabled) {
+                awaiting_ = awaiting_coro;
+                detail::trace_suspend(awaiting_coro.address(), "co_await inline task");
+                detail::trace_start(coro_.address(), awaiting_coro.address());
+            }
+            return coro_;
+        }
+
+        decltype(auto) await_resume() {
+            if constexpr (tracing_enabled) {
+                if (awaiting_) {
+                    detail::trace_resume(awaiting_.address(), "co_await inline task");
+                }
+            }
+            if constexpr (std::is_void_v<T>) {
+                coro_.promise().result();
+                return;
+            } else if constexpr (std::is_reference_v<T>) {
+                return coro_.promise().result();
+            } else {
+                return std::move(coro_.promise()).result();
+            }
+        }
+    };
+
+    auto operator co_await() const& noexcept {
+        return Awaiter{coro_};
+    }
+
+    auto operator co_await() const&& noexcept {
+        return Awaiter{coro_};
+    }
+
+    // 获取底层协程句柄（高级用法）
+    std::coroutine_handle<promise_type> handle() const noexcept {
+        return coro_;
+    }
+
+private:
+    std::coroutine_handle<promise_type> coro_;
+};
+
+namespace detail {
+
+template <typename T>
+InlineTask<T> InlineTaskPromise<T>::get_return_object() noexcept {
+    return InlineTask<T>{std::coroutine_handle<InlineTaskPromise<T>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+} // namespace zlcoro
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace zlcoro {
+
+// =============================================================================
+// 运行时指标（ThreadPool / EventLoop 内置计数器）
+// =============================================================================
+//
+// - 每个计数器只有一个写者（所属的工作线程或事件循环线程），递增是
+//   relaxed 的 load + store，不需要带 lock 前缀的原子指令
+// - 任意线程可以随时读取快照（relaxed load，数值之间不保证一致）
+// - 定义 ZLCORO_DISABLE_METRICS（CMake: -DZLCORO_ENABLE_METRICS=OFF）后
+//   所有记录都编译为空操作，计时用的 steady_clock::now() 也不会调用
+//
+// 快照可以用 append_prometheus_*() 转成 Prometheus 文本格式。
+// =============================================================================
+
+#if defined(ZLCORO_DISABLE_METRICS)
+inline constexpr bool metrics_enabled = false;
+#else
+inline constexpr bool metrics_enabled = true;
+#endif
+
+// 单写者计数器
+class MetricCounter {
+public:
+    void add(uint64_t n = 1) noexcept {
+        if constexpr (metrics_enabled) {
+            value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t load() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// 单写者瞬时值
+class MetricGauge {
+public:
+    void set(uint64_t value) noexcept {
+        if constexpr (metrics_enabled) {
+            value_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t load() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// 直方图快照：第 i 个桶统计 (2^(i-1), 2^i] 范围内的值（第 0 个桶为 0 和 1）
+struct HistogramSnapshot {
+    static constexpr size_t bucket_count = 40;
+
+    std::array<uint64_t, bucket_count> buckets{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+
+    // 第 i 个桶的上界
+    static constexpr uint64_t upper_bound(size_t bucket) noexcept {
+        return uint64_t{1} << bucket;
+    }
+
+    // 分位数的近似值（所在桶的上界），p 取 [0, 1]
+    uint64_t quantile(double p) const noexcept {
+        if (count == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return upper_bound(i);
+            }
+        }
+        return upper_bound(bucket_count - 1);
+    }
+};
+
+// 单写者以 2 为底的对数直方图（固定 40 个桶，纳秒时最大约 9 分钟）
+class MetricHistogram {
+public:
+    void record(uint64_t value) noexcept {
+        if constexpr (metrics_enabled) {
+            size_t bucket = value <= 1 ? 0 : static_cast<size_t>(std::bit_width(value - 1));
+            if (bucket >= HistogramSnapshot::bucket_count) {
+                bucket = HistogramSnapshot::bucket_count - 1;
+            }
+            bump(buckets_[bucket], 1);
+            bump(count_, 1);
+            bump(sum_, value);
+        }
+    }
+
+    // 记录一段时间（纳秒）
+    void record(std::chrono::steady_clock::duration elapsed) noexcept {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record(static_cast<uint64_t>(ns > 0 ? ns : 0));
+    }
+
+    HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot result;
+        for (size_t i = 0; i < HistogramSnapshot::bucket_count; ++i) {
+            result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        result.count = count_.load(std::memory_order_relaxed);
+        result.sum = sum_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::bucket_count> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+};
+
+// 启用指标时返回当前时间，否则返回默认值（不读时钟）
+inline std::chrono::steady_clock::time_point metrics_now() noexcept {
+    if constexpr (metrics_enabled) {
+        return std::chrono::steady_clock::now();
+    } else {
+        return {};
+    }
+}
+
+// =============================================================================
+// Prometheus 文本格式输出
+// =============================================================================
+//
+// 同一个指标族只能有一行 # TYPE：先调用 append_prometheus_header，
+// 再为每组标签（形如 worker="0"，可以为空）追加样本。
+
+inline void append_prometheus_header(std::string& out, std::string_view name,
+                                     std::string_view type) {
+    out += "# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+namespace detail {
+
+inline std::string format_metric_value(uint64_t value) {
+    return std::to_string(value);
+}
+
+inline std::string format_metric_value(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+} // namespace detail
+
+template <typename Value>
+void append_prometheus_sample(std::string& out, std::string_view name, std::string_view suffix,
+                              std::string_view labels, Value value) {
+    out += name;
+    out += suffix;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += detail::format_metric_value(value);
+    out += '\n';
+}
+
+// 追加直方图的 _bucket / _sum / _count 样本；
+// scale 把记录的原始值换算到导出单位（例如纳秒导出为秒时 scale = 1e-9）
+inline void append_prometheus_histogram(std::string& out, std::string_view name,
+                                        std::string_view labels,
+                                        const HistogramSnapshot& histogram, double scale = 1.0) {
+    std::string prefix(labels);
+    if (!prefix.empty()) {
+        prefix += ',';
+    }
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < HistogramSnapshot::bucket_count; ++i) {
+        cumulative += histogram.buckets[i];
+        if (histogram.buckets[i] == 0 && cumulative != histogram.count) {
+            continue;  // 省略空桶（累计值不变）
+        }
+        double bound = static_cast<double>(HistogramSnapshot::upper_bound(i)) * scale;
+        append_prometheus_sample(out, name, "_bucket",
+                                 prefix + "le=\"" + detail::format_metric_value(bound) + "\"", cumulative);
+        if (cumulative == histogram.count) {
+            break;
+        }
+    }
+    append_prometheus_sample(out, name, "_bucket", prefix + "le=\"+Inf\"", histogram.count);
+    append_prometheus_sample(out, name, "_sum", labels, static_cast<double>(histogram.sum) * scale);
+    append_prometheus_sample(out, name, "_count", labels, histogram.count);
+}
+
+} // namespace zlcoro
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "zlcoro/core/frame_allocator.hpp"
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace zlcoro {
+
+template <typename T>
+class SharedTask;
+
+// =============================================================================
+// SharedTask<T> - 可以被多个协程同时等待的 Task
+// =============================================================================
+//
+// Task<T> 只有一个 continuation_，只能被 co_await 一次。SharedTask 可以拷贝，
+// 每个副本都可以 co_await：
+// - 第一个等待者启动协程（对称转移），之后的等待者挂到无锁等待链表上
+// - 协程结束时一次性取出链表，恢复所有等待者（最后一个通过对称转移）
+// - 已完成后再 co_await 不挂起，直接取结果
+// - 所有等待者拿到同一个结果：co_await 返回 const T&（T& 时返回 T&），
+//   异常会在每个等待者中重新抛出
+//
+// 使用方式:
+//   SharedTask<Config> config = load_config();   // 惰性：还没有开始执行
+//   // 多个请求协程并发等待，load_config 只执行一次
+//   const Config& c = co_await config;
+//
+// 协程帧按引用计数管理，最后一个副本析构时销毁。
+// 注意：共享的协程不继承任何等待者的取消令牌（一个等待者被取消不应
+// 取消其他等待者共享的工作）。
+// =============================================================================
+
+namespace detail {
+
+// 等待链表的节点（位于等待者的 Awaiter 中，即等待者的协程帧中）
+struct SharedTaskWaiter {
+    std::coroutine_handle<> continuation;
+    SharedTaskWaiter* next = nullptr;
+};
+
+// =============================================================================
+// SharedTaskPromiseBase - 等待链表与引用计数
+// =============================================================================
+//
+// state_ 为以下之一（两个哨兵是本对象两个成员的地址，不会与节点重合）：
+// - &state_：协程还没有启动
+// - &refs_：协程已经结束，结果可用
+// - 其他：等待链表头（启动时第一个等待者入链表，所以链表不会为空）
+// =============================================================================
+
+class SharedTaskPromiseBase : public FrameAllocated {
+public:
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        // 恢复所有等待者；被恢复的等待者可能销毁本协程，之后不能再访问 promise
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> coro) noexcept {
+            return coro.promise().release_waiters();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    bool is_ready() const noexcept {
+        return state_.load(std::memory_order_acquire) == static_cast<const void*>(&refs_);
+    }
+
+    // 把 waiter 挂到链表上，返回接下来要恢复的协程：
+    // 第一个等待者启动协程（self），已完成时恢复等待者自己，否则 noop
+    std::coroutine_handle<> add_waiter(SharedTaskWaiter* waiter,
+                                       std::coroutine_handle<> self) noexcept {
+        void* old = state_.load(std::memory_order_acquire);
+        while (true) {
+            if (old == ready()) {
+                return waiter->continuation;
+            }
+            const bool starting = old == not_started();
+            waiter->next = starting ? nullptr : static_cast<SharedTaskWaiter*>(old);
+            if (state_.compare_exchange_weak(old, waiter, std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+                return starting ? self : std::noop_coroutine();
+            }
+        }
+    }
+
+    void add_ref() noexcept {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 返回 true 表示这是最后一个引用
+    bool release() noexcept {
+        return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+private:
+    std::coroutine_handle<> release_waiters() noexcept {
+        void* old = state_.exchange(ready(), std::memory_order_acq_rel);
+        if (old == not_started() || old == nullptr) {
+            return std::noop_coroutine();
+        }
+        auto* waiter = static_cast<SharedTaskWaiter*>(old);
+        while (waiter->next) {
+            SharedTaskWaiter* next = waiter->next;  // 恢复之后节点可能已经失效
+            waiter->continuation.resume();
+            waiter = next;
+        }
+        return waiter->continuation;
+    }
+
+    void* not_started() noexcept {
+        return &state_;
+    }
+
+    void* ready() noexcept {
+        return &refs_;
+    }
+
+    std::atomic<void*> state_{&state_};
+    std::atomic<uint32_t> refs_{1};
+};
+
+template <typename T>
+class SharedTaskPromise : public SharedTaskPromiseBase {
+public:
+    SharedTask<T> get_return_object() noexcept;
+
+    template <typename U>
+        requires std::convertible_to<U, T>
+    void return_value(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    void unhandled_exception() noexcept {
+        exception_ = std::current_exception();
+    }
+
+    const T& result() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+        return *value_;
+    }
+
+private:
+    std::optional<T> value_;
+    std::exception_ptr exception_;
+};
+
+template <>
+class SharedTaskPromise<void> : public SharedTaskPromiseBase {
+public:
+    SharedTask<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+        exception_ = std::current_exception();
+    }
+
+    void result() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    std::exception_ptr exception_;
+};
+
+template <typename T>
+class SharedTaskPromise<T&> : public SharedTaskPromiseBase {
+public:
+    SharedTask<T&> get_return_object() noexcept;
+
+    void return_value(T& value) noexcept {
+        value_ = std::addressof(value);
+    }
+
+    void unhandled_exception() noexcept {
+        exception_ = std::current_exception();
+    }
+
+    T& result() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+        return *value_;
+    }
+
+private:
+    T* value_ = nullptr;
+    std::exception_ptr exception_;
+};
+
+} // namespace detail
+
+template <typename T = void>
+class SharedTask {
+public:
+    using promise_type = detail::SharedTaskPromise<T>;
+    using value_type = T;
+
+    SharedTask() noexcept = default;
+
+    explicit SharedTask(std::coroutine_handle<promise_type> coro) noexcept : coro_(coro) {}
+
+    SharedTask(const SharedTask& other) noexcept : coro_(other.coro_) {
+        if (coro_) {
+            coro_.promise().add_ref();
+        }
+    }
+
+    SharedTask(SharedTask&& other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+
+    SharedTask& operator=(SharedTask other) noexcept {
+        std::swap(coro_, other.coro_);
+        return *this;
+    }
+
+    ~SharedTask() {
+        if (coro_ && coro_.promise().release()) {
+            coro_.destroy();
+        }
+    }
+
+    bool valid() const noexcept {
+        return coro_ != nullptr;
+    }
+
+    // 协程是否已经结束（结果可用）
+    bool is_ready() const noexcept {
+        return !coro_ || coro_.promise().is_ready();
+    }
+
+    // ========================================================================
+    // Awaiter - 等待者在自己的帧中提供链表节点，不需要分配
+    // ========================================================================
+    class Awaiter : private detail::SharedTaskWaiter {
+    public:
+        explicit Awaiter(std::coroutine_handle<promise_type> coro) noexcept : coro_(coro) {}
+
+        bool await_ready() const noexcept {
+            return !coro_ || coro_.promise().is_ready();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            continuation = awaiting;
+            return coro_.promise().add_waiter(this, coro_);
+        }
+
+        decltype(auto) await_resume() const {
+            return coro_.promise().result();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> coro_;
+    };
+
+    Awaiter operator co_await() const noexcept {
+        return Awaiter{coro_};
+    }
+
+private:
+    std::coroutine_handle<promise_type> coro_;
+};
+
+namespace detail {
+
+template <typename T>
+SharedTask<T> SharedTaskPromise<T>::get_return_object() noexcept {
+    return SharedTask<T>{std::coroutine_handle<SharedTaskPromise<T>>::from_promise(*this)};
+}
+
+inline SharedTask<void> SharedTaskPromise<void>::get_return_object() noexcept {
+    return SharedTask<void>{std::coroutine_handle<SharedTaskPromise<void>>::from_promise(*this)};
+}
+
+template <typename T>
+SharedTask<T&> SharedTaskPromise<T&>::get_return_object() noexcept {
+    return SharedTask<T&>{std::coroutine_handle<SharedTaskPromise<T&>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+} // namespace zlcoro
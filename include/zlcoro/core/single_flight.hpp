@@ -0,0 +1,102 @@
+#pragma once
+
+#include "zlcoro/core/shared_task.hpp"
+#include "zlcoro/core/task.hpp"
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace zlcoro {
+
+// =============================================================================
+// SingleFlight<Key, T> - 合并同一个 key 的并发调用
+// =============================================================================
+//
+// 对同一个 key，同一时刻最多只有一次调用在执行：
+// - 没有进行中的调用时，run() 调用 make() 创建 Task 并以 SharedTask 执行
+// - 已有进行中的调用时，run() 挂到它的等待链表上，不调用 make()
+// - 调用结束（包括抛出异常）时从表中移除，之后的 run() 重新执行
+//
+// 只合并进行中的调用，不缓存结果。
+//
+// 使用方式:
+//   SingleFlight<std::string, std::string> flights;
+//
+//   Task<std::string> get_config(const std::string& path) {
+//       co_return co_await flights.run(path, [&] { return read_file(path); });
+//   }
+//
+// 注意：
+// - make() 在锁内调用，只应该创建惰性的 Task，不要在其中做耗时工作
+// - 每个调用者得到结果的一份拷贝（T 需要可拷贝）
+// - 等待者按结束顺序在执行该调用的线程中恢复
+// =============================================================================
+
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class SingleFlight {
+public:
+    SingleFlight() = default;
+
+    // 进行中的调用引用了 this，不能移动
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    // 执行或加入 key 对应的调用；make 是返回 Task<T> 的可调用对象
+    template <typename F>
+        requires std::is_same_v<std::invoke_result_t<F&>, Task<T>>
+    Task<T> run(Key key, F make) {
+        SharedTask<T> flight;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = flights_.find(key);
+            if (it != flights_.end()) {
+                flight = it->second;
+            } else {
+                flight = execute(key, make());
+                flights_.emplace(std::move(key), flight);
+            }
+        }
+
+        if constexpr (std::is_void_v<T>) {
+            co_await flight;
+        } else {
+            co_return co_await flight;
+        }
+    }
+
+    // 进行中的调用数
+    size_t in_flight() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return flights_.size();
+    }
+
+private:
+    // 结束时从表中移除（在恢复等待者之前）
+    struct Finish {
+        SingleFlight* self;
+        const Key* key;
+
+        ~Finish() {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            self->flights_.erase(*key);
+        }
+    };
+
+    SharedTask<T> execute(Key key, Task<T> task) {
+        Finish finish{this, &key};
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+        } else {
+            co_return co_await task;
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, SharedTask<T>, Hash, KeyEqual> flights_;
+};
+
+} // namespace zlcoro
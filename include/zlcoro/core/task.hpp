@@ -1,12 +1,29 @@
 #pragma once
 
+#include "zlcoro/core/frame_allocator.hpp"
+#include "zlcoro/core/trace.hpp"
+#include <atomic>
 #include <coroutine>
 #include <exception>
 #include <memory>
+#include <stop_token>
 #include <type_traits>
 #include <utility>
 #include <cassert>
 
+// Clang 的 HALO 提示：在协程中直接 co_await 返回该类型的调用（prvalue）时，
+// 允许编译器把被调协程的帧放进调用者的帧里，省掉一次分配。
+// Task 的临时对象在完整表达式结束时销毁，满足这个属性要求的生命周期。
+// 不支持的编译器上为空（GCC 不做 HALO，嵌套的小帧改用 InlineTask）。
+#if defined(__has_cpp_attribute)
+#  if __has_cpp_attribute(clang::coro_await_elidable)
+#    define ZLCORO_CORO_AWAIT_ELIDABLE [[clang::coro_await_elidable]]
+#  endif
+#endif
+#if !defined(ZLCORO_CORO_AWAIT_ELIDABLE)
+#  define ZLCORO_CORO_AWAIT_ELIDABLE
+#endif
+
 namespace zlcoro {
 
 // 前向声明
@@ -15,6 +32,18 @@ class Task;
 
 namespace detail {
 
+// ============================================================================
+// TaskCompletion - 代替延续协程的完成回调
+// ============================================================================
+// when_all / when_any 等组合器不为每个子任务创建包装协程，而是把一个
+// TaskCompletion 挂到子任务的 promise 上：子任务结束时调用 on_complete，
+// 返回值是接下来要恢复的协程（对称转移），通常是 noop 或等待的父协程。
+// ============================================================================
+struct TaskCompletion {
+    std::coroutine_handle<> (*on_complete)(TaskCompletion* self,
+                                           std::coroutine_handle<> task) noexcept;
+};
+
 // ============================================================================
 // TaskPromiseBase - Promise 类型的基类，处理公共逻辑
 // ============================================================================
@@ -23,8 +52,13 @@ namespace detail {
 // - final_suspend: 协程结束时是否挂起
 // - return_value/return_void: 如何处理返回值
 // - unhandled_exception: 如何处理异常
+// - operator new/delete: 协程帧从 FramePool 或 allocator_arg 传入的分配器分配
+//
+// promise 还携带一个 std::stop_token：co_await 子任务时，没有自己令牌的
+// 子任务继承父协程的令牌，I/O 和定时器的 Awaiter 从等待者的 promise 中
+// 取出令牌并注册取消回调（见 cancellation.hpp）。
 // ============================================================================
-class TaskPromiseBase {
+class TaskPromiseBase : public FrameAllocated {
 public:
     // 协程启动时立即挂起，等待调度器调度
     // suspend_always 表示总是挂起（惰性求值）
@@ -43,6 +77,12 @@ public:
         std::coroutine_handle<> await_suspend(
             std::coroutine_handle<Promise> coro) noexcept {
             auto& promise = coro.promise();
+            detail::trace_complete(coro.address(), promise.continuation_.address());
+            
+            // 组合器的完成回调（回调中可能销毁本协程，之后不能再访问 promise）
+            if (promise.completion_) {
+                return promise.completion_->on_complete(promise.completion_, coro);
+            }
             
             // 如果有协程在等待当前协程完成，恢复那个协程
             if (promise.continuation_) {
@@ -65,11 +105,52 @@ public:
         continuation_ = continuation;
     }
 
+    // 设置完成回调（代替延续协程）
+    void set_completion(TaskCompletion* completion) noexcept {
+        completion_ = completion;
+    }
+
+    // 设置取消令牌（在协程启动之前）
+    void set_stop_token(std::stop_token token) noexcept {
+        stop_token_ = std::move(token);
+    }
+
+    const std::stop_token& get_stop_token() const noexcept {
+        return stop_token_;
+    }
+
+    // 没有自己的令牌时继承 parent 的令牌（没有令牌的常见情况只读一个指针）
+    void inherit_stop_token(const TaskPromiseBase& parent) noexcept {
+        if (parent.stop_token_.stop_possible() && !stop_token_.stop_possible()) {
+            stop_token_ = parent.stop_token_;
+        }
+    }
+
 protected:
     // 存储延续协程的句柄
     std::coroutine_handle<> continuation_;
+    TaskCompletion* completion_ = nullptr;
+    std::stop_token stop_token_;
 };
 
+// 等待者协程的取消令牌（不是 Task 的协程没有令牌）
+template <typename Promise>
+std::stop_token stop_token_of(std::coroutine_handle<Promise> coro) noexcept {
+    if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>) {
+        return coro.promise().get_stop_token();
+    } else {
+        return {};
+    }
+}
+
+// 子任务继承父协程的取消令牌（父协程不是 Task 时什么也不做）
+template <typename Promise>
+void inherit_stop_token(TaskPromiseBase& child, std::coroutine_handle<Promise> parent) noexcept {
+    if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>) {
+        child.inherit_stop_token(parent.promise());
+    }
+}
+
 // ============================================================================
 // TaskPromise<T> - 有返回值的 Promise 实现
 // ============================================================================
@@ -195,6 +276,88 @@ private:
     std::exception_ptr exception_;
 };
 
+// ============================================================================
+// SyncWaitNotifier - sync_wait 的完成通知
+// ============================================================================
+// SyncWaitNotifier 是一个只包含 final_suspend 的协程，作为被等待 Task 的
+// 延续：Task 无论在哪个线程结束，都会通过对称转移恢复它，由它设置完成
+// 标志，阻塞的线程通过 atomic wait/notify 被唤醒（不忙等，也不会恢复别的
+// 线程正在持有的协程）。
+//
+// 完成标志位于通知协程的帧中，帧由 SyncWaitNotifier 和通知协程各持有一个
+// 引用：通知协程在 notify 之后才释放引用，阻塞的线程看到完成标志后立即
+// 返回并析构 SyncWaitNotifier 也不会销毁一个仍要被 notify 的帧。
+// ============================================================================
+class SyncWaitNotifier {
+public:
+    struct promise_type : FrameAllocated {
+        std::atomic<bool> done{false};
+        std::atomic<int> refs{2};   // SyncWaitNotifier + 通知协程
+
+        // 释放一个引用；返回 true 表示调用者负责销毁帧
+        bool release() noexcept {
+            return refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        SyncWaitNotifier get_return_object() noexcept {
+            return SyncWaitNotifier{
+                std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // 结束时设置完成标志并唤醒等待者，之后才释放引用
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> coro) noexcept {
+                auto& promise = coro.promise();
+                promise.done.store(true, std::memory_order_release);
+                promise.done.notify_one();
+                if (promise.release()) {
+                    coro.destroy();   // 等待者已经返回
+                }
+            }
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+
+    explicit SyncWaitNotifier(std::coroutine_handle<promise_type> coro) noexcept
+        : coro_(coro) {}
+
+    SyncWaitNotifier(const SyncWaitNotifier&) = delete;
+    SyncWaitNotifier& operator=(const SyncWaitNotifier&) = delete;
+
+    ~SyncWaitNotifier() {
+        // 没有启动过的通知协程不会释放它的引用
+        if (!started_ || coro_.promise().release()) {
+            coro_.destroy();
+        }
+    }
+
+    // 作为延续交出的句柄；交出后通知协程必须被恢复
+    std::coroutine_handle<> handle() noexcept {
+        started_ = true;
+        return coro_;
+    }
+
+    // 阻塞直到通知协程运行
+    void wait() const noexcept {
+        coro_.promise().done.wait(false, std::memory_order_acquire);
+    }
+
+private:
+    std::coroutine_handle<promise_type> coro_;
+    bool started_ = false;
+};
+
+inline SyncWaitNotifier make_sync_wait_notifier() {
+    co_return;
+}
+
 } // namespace detail
 
 // ============================================================================
@@ -211,7 +374,7 @@ private:
 //   }
 // ============================================================================
 template <typename T = void>
-class Task {
+class ZLCORO_CORO_AWAIT_ELIDABLE Task {
 public:
     using promise_type = detail::TaskPromise<T>;
     using value_type = T;
@@ -258,6 +421,7 @@ public:
     // ========================================================================
     struct Awaiter {
         std::coroutine_handle<promise_type> coro_;
+        std::coroutine_handle<> awaiting_ = nullptr;   // 只在启用追踪时记录
 
         // 如果任务已经完成，不需要挂起
         bool await_ready() const noexcept {
@@ -267,16 +431,28 @@ public:
         // 当前协程挂起，启动被等待的协程
         // awaiting_coro: 正在执行 co_await 的协程（等待者）
         // coro_: 被等待的协程（Task 持有的协程）
+        template <typename Promise>
         std::coroutine_handle<> await_suspend(
-            std::coroutine_handle<> awaiting_coro) noexcept {
+            std::coroutine_handle<Promise> awaiting_coro) noexcept {
             // 设置延续：当 coro_ 完成后，恢复 awaiting_coro
             coro_.promise().set_continuation(awaiting_coro);
+            detail::inherit_stop_token(coro_.promise(), awaiting_coro);
+            if constexpr (tracing_enabled) {
+                awaiting_ = awaiting_coro;
+                detail::trace_suspend(awaiting_coro.address(), "co_await task");
+                detail::trace_start(coro_.address(), awaiting_coro.address());
+            }
             // 返回 coro_，表示接下来要恢复被等待的协程
             return coro_;
         }
 
         // 被等待的协程完成后，返回结果
         decltype(auto) await_resume() {
+            if constexpr (tracing_enabled) {
+                if (awaiting_) {
+                    detail::trace_resume(awaiting_.address(), "co_await task");
+                }
+            }
             if constexpr (std::is_void_v<T>) {
                 coro_.promise().result();
                 return;
@@ -304,17 +480,18 @@ public:
     // 1. 测试代码
     // 2. main 函数中启动异步任务
     // 3. 从同步代码调用异步代码的边界
+    //
+    // 协程在当前线程中启动，挂起后由恢复它的线程（调度器、事件循环）继续
+    // 执行；当前线程阻塞等待完成通知。不要在协程依赖的工作线程或事件循环
+    // 线程中调用，否则会死锁。
     // ========================================================================
     decltype(auto) sync_wait() {
-        // 如果协程还没启动，启动它
+        // 如果协程还没启动，以通知协程为延续启动它
         if (!coro_.done()) {
+            auto notifier = detail::make_sync_wait_notifier();
+            coro_.promise().set_continuation(notifier.handle());
             coro_.resume();
-        }
-
-        // 持续恢复协程直到完成
-        // 注意：这是一个简化版本，实际调度器会更复杂
-        while (!coro_.done()) {
-            coro_.resume();
+            notifier.wait();
         }
 
         // 返回结果
@@ -328,6 +505,12 @@ public:
         }
     }
 
+    // 设置取消令牌：在 co_await / sync_wait 之前调用，子任务会继承它
+    // 令牌被请求停止时，正在等待的 I/O、定时器以 OperationCancelled 结束
+    void set_stop_token(std::stop_token token) noexcept {
+        coro_.promise().set_stop_token(std::move(token));
+    }
+
     // 获取底层协程句柄（高级用法）
     std::coroutine_handle<promise_type> handle() const noexcept {
         return coro_;
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// 协程级追踪（挂起 / 恢复时间戳）
+// =============================================================================
+//
+// 定义 ZLCORO_ENABLE_TRACING（CMake: -DZLCORO_ENABLE_TRACING=ON）后，
+// 以下位置会记录事件：
+// - Task 的 co_await：父协程挂起 / 恢复，子协程开始（父子关系即 continuation_）
+// - TaskPromiseBase::FinalAwaiter：子协程结束
+// - ScheduleAwaiter：提交到线程池 / 在工作线程上恢复（两者之差就是排队延迟）
+// - EventLoop 的 fd 就绪等待和 io_uring 操作（AsyncSocket 的所有 I/O 等待）
+//
+// 每个线程在第一次记录时创建自己的环形缓冲区，写入只有本线程一个写者，
+// 不加锁；缓冲区满后覆盖最旧的事件（飞行记录器）。
+// Tracer::instance().to_chrome_json() 导出 Chrome / Perfetto 的 trace JSON：
+// 每次等待是一个以协程地址为 id 的异步区间（可能跨线程），开始 / 结束是
+// 带 parent 参数的瞬时事件。
+//
+// 未定义 ZLCORO_ENABLE_TRACING 时所有记录都编译为空操作。
+// =============================================================================
+
+#if defined(ZLCORO_ENABLE_TRACING)
+inline constexpr bool tracing_enabled = true;
+#else
+inline constexpr bool tracing_enabled = false;
+#endif
+
+#if !defined(ZLCORO_TRACE_RING_SIZE)
+#define ZLCORO_TRACE_RING_SIZE 16384   // 每个线程保留的事件数（2 的幂）
+#endif
+
+enum class TraceEventType : uint8_t {
+    Suspend,   // 协程在 name 处挂起
+    Resume,    // 协程从 name 处恢复
+    Start,     // 协程被 parent 启动
+    Complete,  // 协程结束，将恢复 parent
+};
+
+struct TraceEvent {
+    uint64_t timestamp_ns = 0;     // steady_clock
+    const void* coro = nullptr;    // 协程帧地址
+    const void* parent = nullptr;  // Start / Complete 的父协程
+    const char* name = "";         // 等待点名称（字符串字面量）
+    TraceEventType type = TraceEventType::Suspend;
+};
+
+// 一个线程的事件快照
+struct ThreadTrace {
+    uint32_t thread_id = 0;        // 内核线程 ID
+    std::vector<TraceEvent> events;
+};
+
+// =============================================================================
+// TraceRing - 单写者环形缓冲区
+// =============================================================================
+//
+// 写者（所属线程）写入槽位后以 release 推进 head_；读者读取 head_，
+// 复制最新的 capacity 个事件，再读一次 head_，丢弃复制期间可能被
+// 覆盖的部分。
+// =============================================================================
+
+class TraceRing {
+public:
+    static constexpr size_t capacity = ZLCORO_TRACE_RING_SIZE;
+    static_assert((capacity & (capacity - 1)) == 0, "ZLCORO_TRACE_RING_SIZE must be a power of 2");
+
+    explicit TraceRing(uint32_t thread_id) : thread_id_(thread_id), events_(capacity) {}
+
+    void push(const TraceEvent& event) noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        events_[head & (capacity - 1)] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // 由另一个线程预先创建的缓冲区在所属线程启动时设置线程 ID
+    void set_thread_id(uint32_t thread_id) noexcept {
+        thread_id_.store(thread_id, std::memory_order_relaxed);
+    }
+
+    ThreadTrace snapshot() const {
+        ThreadTrace result;
+        result.thread_id = thread_id_.load(std::memory_order_relaxed);
+
+        uint64_t end = head_.load(std::memory_order_acquire);
+        uint64_t begin = std::max(start_.load(std::memory_order_relaxed),
+                                  end > capacity ? end - capacity : 0);
+        result.events.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; ++i) {
+            result.events.push_back(events_[i & (capacity - 1)]);
+        }
+
+        // 复制期间写者可能绕回并覆盖了最旧的事件
+        uint64_t now = head_.load(std::memory_order_acquire);
+        if (now > capacity && now - capacity > begin) {
+            auto overwritten = std::min<uint64_t>(now - capacity - begin, result.events.size());
+            result.events.erase(result.events.begin(),
+                                result.events.begin() + static_cast<std::ptrdiff_t>(overwritten));
+        }
+        return result;
+    }
+
+    // 丢弃已记录的事件（不影响写者）
+    void clear() noexcept {
+        start_.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint32_t> thread_id_;
+    std::vector<TraceEvent> events_;
+    std::atomic<uint64_t> head_{0};    // 已写入的事件总数
+    std::atomic<uint64_t> start_{0};   // clear() 时的 head_
+};
+
+// =============================================================================
+// Tracer - 所有线程环形缓冲区的注册表
+// =============================================================================
+
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    // 为当前线程分配缓冲区并注册（幂等）。事件循环开始运行时调用，
+    // 之后记录事件不再分配内存；其他线程在第一次记录时注册
+    void register_current_thread() {
+        local();
+    }
+
+    // 在创建线程的线程中为即将启动的线程分配并注册缓冲区，新线程用
+    // adopt_thread 接管：线程池的工作线程从启动起就不再分配内存
+    std::shared_ptr<TraceRing> prepare_thread() {
+        auto ring = std::make_shared<TraceRing>(0);
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    void adopt_thread(std::shared_ptr<TraceRing> ring) noexcept {
+        ring->set_thread_id(static_cast<uint32_t>(::syscall(SYS_gettid)));
+        slot() = std::move(ring);
+    }
+
+    // 记录一个事件到当前线程的缓冲区
+    void record(TraceEventType type, const void* coro, const void* parent, const char* name) {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        local().push(TraceEvent{
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()),
+            coro, parent, name, type});
+    }
+
+    // 所有线程（包括已退出的线程）的事件快照
+    std::vector<ThreadTrace> snapshot() const {
+        std::vector<std::shared_ptr<TraceRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings = rings_;
+        }
+        std::vector<ThreadTrace> result;
+        result.reserve(rings.size());
+        for (const auto& ring : rings) {
+            result.push_back(ring->snapshot());
+        }
+        return result;
+    }
+
+    // 丢弃所有已记录的事件
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& ring : rings_) {
+            ring->clear();
+        }
+    }
+
+    // 导出 Chrome trace event 格式（chrome://tracing、ui.perfetto.dev 可直接打开）
+    std::string to_chrome_json() const {
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        auto begin_event = [&] {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += "\n{";
+        };
+
+        for (const ThreadTrace& thread : snapshot()) {
+            const std::string tid = std::to_string(thread.thread_id);
+            begin_event();
+            out += "\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid +
+                   ",\"args\":{\"name\":\"zlcoro-" + tid + "\"}}";
+
+            for (const TraceEvent& event : thread.events) {
+                begin_event();
+                switch (event.type) {
+                case TraceEventType::Suspend:
+                case TraceEventType::Resume:
+                    out += event.type == TraceEventType::Suspend ? "\"ph\":\"b\"" : "\"ph\":\"e\"";
+                    out += ",\"cat\":\"zlcoro\",\"name\":\"";
+                    out += event.name;
+                    out += "\",\"id\":\"" + format_pointer(event.coro) + '"';
+                    break;
+                case TraceEventType::Start:
+                case TraceEventType::Complete:
+                    out += "\"ph\":\"i\",\"s\":\"t\",\"cat\":\"zlcoro\",\"name\":\"";
+                    out += event.type == TraceEventType::Start ? "start" : "complete";
+                    out += "\",\"args\":{\"coro\":\"" + format_pointer(event.coro) +
+                           "\",\"parent\":\"" + format_pointer(event.parent) + "\"}";
+                    break;
+                }
+                out += ",\"pid\":1,\"tid\":" + tid + ",\"ts\":" + format_timestamp(event.timestamp_ns) + '}';
+            }
+        }
+        out += "\n]}\n";
+        return out;
+    }
+
+private:
+    Tracer() = default;
+
+    static std::shared_ptr<TraceRing>& slot() noexcept {
+        thread_local std::shared_ptr<TraceRing> ring;
+        return ring;
+    }
+
+    TraceRing& local() {
+        auto& ring = slot();
+        if (!ring) {
+            ring = register_thread();
+        }
+        return *ring;
+    }
+
+    std::shared_ptr<TraceRing> register_thread() {
+        auto ring = std::make_shared<TraceRing>(static_cast<uint32_t>(::syscall(SYS_gettid)));
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    static std::string format_pointer(const void* ptr) {
+        char buffer[24];
+        std::snprintf(buffer, sizeof(buffer), "0x%zx", reinterpret_cast<size_t>(ptr));
+        return buffer;
+    }
+
+    // Chrome trace 的时间戳单位是微秒
+    static std::string format_timestamp(uint64_t ns) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%llu.%03u",
+                      static_cast<unsigned long long>(ns / 1000), static_cast<unsigned>(ns % 1000));
+        return buffer;
+    }
+
+    mutable std::mutex mutex_;                      // 只保护注册表（每个线程一次）
+    std::vector<std::shared_ptr<TraceRing>> rings_;
+};
+
+namespace detail {
+
+// 埋点辅助函数：未启用追踪时为空操作
+
+inline void trace_register_thread() {
+    if constexpr (tracing_enabled) {
+        Tracer::instance().register_current_thread();
+    }
+}
+
+// 创建线程前调用，结果交给新线程的 trace_adopt_thread（未启用追踪时为空）
+inline std::shared_ptr<TraceRing> trace_prepare_thread() {
+    if constexpr (tracing_enabled) {
+        return Tracer::instance().prepare_thread();
+    } else {
+        return nullptr;
+    }
+}
+
+inline void trace_adopt_thread(std::shared_ptr<TraceRing> ring) noexcept {
+    if constexpr (tracing_enabled) {
+        if (ring) {
+            Tracer::instance().adopt_thread(std::move(ring));
+        }
+    }
+}
+
+inline void trace_suspend(const void* coro, const char* name) {
+    if constexpr (tracing_enabled) {
+        Tracer::instance().record(TraceEventType::Suspend, coro, nullptr, name);
+    }
+}
+
+inline void trace_resume(const void* coro, const char* name) {
+    if constexpr (tracing_enabled) {
+        Tracer::instance().record(TraceEventType::Resume, coro, nullptr, name);
+    }
+}
+
+inline void trace_start(const void* coro, const void* parent) {
+    if constexpr (tracing_enabled) {
+        Tracer::instance().record(TraceEventType::Start, coro, parent, "start");
+    }
+}
+
+inline void trace_complete(const void* coro, const void* parent) {
+    if constexpr (tracing_enabled) {
+        Tracer::instance().record(TraceEventType::Complete, coro, parent, "complete");
+    }
+}
+
+} // namespace detail
+
+} // namespace zlcoro
@@ -4,5 +4,9 @@
 
 #include "io/epoll_poller.hpp"
 #include "io/event_loop.hpp"
+#include "io/timeout.hpp"
 #include "io/async_file.hpp"
+#include "io/buffer_pool.hpp"
 #include "io/async_socket.hpp"
+#include "io/buffered_stream.hpp"
+#include "io/event_loop_group.hpp"
@@ -1,14 +1,24 @@
 #pragma once
 
+#include "event_loop.hpp"
 #include "zlcoro/core/task.hpp"
+#include "zlcoro/scheduler/blocking_pool.hpp"
 #include "zlcoro/scheduler/scheduler.hpp"
 #include <string>
 #include <fstream>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
 #include <cstring>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
 #include <utility>
 
 namespace zlcoro {
@@ -18,9 +28,120 @@ namespace zlcoro {
 // =============================================================================
 // 
 // 提供异步文件读写接口。
-// 注意：由于 Linux AIO 较复杂，这里使用线程池模拟异步操作。
+//
+// read_at / write_at / fsync 是真正的异步操作，直接使用调用者的缓冲区：
+// - 在启用 io_uring 的事件循环线程中调用时，作为 SQE 提交到该事件循环
+// - 否则交给 BlockingPool 执行 pread / pwrite / fsync，
+//   完成后回到调用者所在的事件循环（不在事件循环中时回到全局调度器）
+//
+// read_all / read / write / sync / seek 是同步接口，会阻塞当前线程。
+//
+// map() 把文件的一段只读映射到内存（FileMapping），供需要随机访问的解析器
+// 直接使用，不拷贝；发送到 socket 见 AsyncSocket::send_file。
 // =============================================================================
 
+// =============================================================================
+// FileMapping - AsyncFile::map() 返回的只读内存映射
+// =============================================================================
+//
+// 析构时 munmap。映射不依赖 AsyncFile 保持打开。
+// 注意：访问映射的页面可能触发缺页并从磁盘读取（阻塞当前线程）；
+// 映射期间文件被其他进程截断时访问越界部分会收到 SIGBUS。
+// =============================================================================
+
+class FileMapping {
+public:
+    FileMapping() noexcept = default;
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    FileMapping(FileMapping&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr)),
+          mapped_size_(std::exchange(other.mapped_size_, 0)),
+          data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    FileMapping& operator=(FileMapping&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            base_ = std::exchange(other.base_, nullptr);
+            mapped_size_ = std::exchange(other.mapped_size_, 0);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~FileMapping() {
+        unmap();
+    }
+
+    const std::byte* data() const noexcept {
+        return data_;
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    std::span<const std::byte> bytes() const noexcept {
+        return {data_, size_};
+    }
+
+    std::string_view view() const noexcept {
+        return {reinterpret_cast<const char*>(data_), size_};
+    }
+
+    // 访问模式提示（MADV_SEQUENTIAL / MADV_RANDOM / MADV_WILLNEED 等）
+    void advise(int advice) const {
+        if (base_ && ::madvise(base_, mapped_size_, advice) == -1) {
+            throw std::runtime_error(
+                std::string("madvise failed: ") + strerror(errno));
+        }
+    }
+
+private:
+    friend class AsyncFile;
+
+    // 映射 fd 中 [offset, offset + length)；mmap 的偏移必须按页对齐，
+    // 多映射的前缀不暴露给调用者
+    FileMapping(int fd, off_t offset, size_t length) {
+        if (length == 0) {
+            return;
+        }
+        const auto page = static_cast<off_t>(::sysconf(_SC_PAGESIZE));
+        const off_t aligned = offset - offset % page;
+        const auto prefix = static_cast<size_t>(offset - aligned);
+
+        void* base = ::mmap(nullptr, length + prefix, PROT_READ, MAP_SHARED, fd, aligned);
+        if (base == MAP_FAILED) {
+            throw std::runtime_error(
+                std::string("mmap failed: ") + strerror(errno));
+        }
+        base_ = base;
+        mapped_size_ = length + prefix;
+        data_ = static_cast<const std::byte*>(base) + prefix;
+        size_ = length;
+    }
+
+    void unmap() noexcept {
+        if (base_) {
+            ::munmap(base_, mapped_size_);
+            base_ = nullptr;
+        }
+    }
+
+    void* base_ = nullptr;
+    size_t mapped_size_ = 0;
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+};
+
 class AsyncFile {
 public:
     // 打开模式
@@ -91,6 +212,31 @@ public:
         return fd_;
     }
 
+    // 文件大小（字节）
+    size_t size() const {
+        check_open();
+        struct stat st;
+        if (fstat(fd_, &st) == -1) {
+            throw std::runtime_error(
+                std::string("fstat failed: ") + strerror(errno));
+        }
+        return static_cast<size_t>(st.st_size);
+    }
+
+    // 只读映射 [offset, offset + length)；length 超出文件末尾时截断到末尾，
+    // offset 不小于文件大小时返回空映射。文件需要以可读模式打开
+    FileMapping map(off_t offset = 0, size_t length = SIZE_MAX) const {
+        if (offset < 0) {
+            throw std::invalid_argument("AsyncFile::map: negative offset");
+        }
+        size_t file_size = size();
+        if (static_cast<size_t>(offset) >= file_size) {
+            return {};
+        }
+        length = std::min(length, file_size - static_cast<size_t>(offset));
+        return FileMapping(fd_, offset, length);
+    }
+
     // 同步读取所有内容（调用者决定是否需要调度）
     std::string read_all() {
         if (!is_open()) {
@@ -180,12 +326,50 @@ public:
             throw std::runtime_error("File not open");
         }
         
-        if (fsync(fd_) == -1) {
+        if (::fsync(fd_) == -1) {
             throw std::runtime_error(
                 std::string("fsync failed: ") + strerror(errno));
         }
     }
 
+    // 从 offset 处读取到 buffer，返回读取的字节数（0 表示已到文件末尾）
+    Task<size_t> read_at(off_t offset, std::span<char> buffer) {
+        check_open();
+        int64_t res = co_await submit_io(IoOp::Read, offset, buffer.data(), buffer.size());
+        if (res < 0) {
+            throw std::runtime_error(
+                std::string("pread failed: ") + strerror(static_cast<int>(-res)));
+        }
+        co_return static_cast<size_t>(res);
+    }
+
+    // 把 data 全部写入 offset 处，返回写入的字节数
+    Task<size_t> write_at(off_t offset, std::span<const char> data) {
+        check_open();
+        size_t total_written = 0;
+        while (total_written < data.size()) {
+            int64_t res = co_await submit_io(
+                IoOp::Write, offset + static_cast<off_t>(total_written),
+                const_cast<char*>(data.data()) + total_written, data.size() - total_written);
+            if (res < 0) {
+                throw std::runtime_error(
+                    std::string("pwrite failed: ") + strerror(static_cast<int>(-res)));
+            }
+            total_written += static_cast<size_t>(res);
+        }
+        co_return total_written;
+    }
+
+    // 异步刷新到磁盘；datasync 为 true 时使用 fdatasync 语义
+    Task<void> fsync(bool datasync = false) {
+        check_open();
+        int64_t res = co_await submit_io(datasync ? IoOp::DataSync : IoOp::Sync, 0, nullptr, 0);
+        if (res < 0) {
+            throw std::runtime_error(
+                std::string("fsync failed: ") + strerror(static_cast<int>(-res)));
+        }
+    }
+
     // 移动文件指针（调用者决定是否需要调度）
     off_t seek(off_t offset, int whence = SEEK_SET) {
         if (!is_open()) {
@@ -201,6 +385,80 @@ public:
         return pos;
     }
 
+private:
+    enum class IoOp { Read, Write, Sync, DataSync };
+
+    void check_open() const {
+        if (!is_open()) {
+            throw std::runtime_error("File not open");
+        }
+    }
+
+    // 执行一次 I/O，结果：>= 0 成功，< 0 为 -errno（EINTR 已在内部重试）
+    Task<int64_t> submit_io(IoOp op, off_t offset, char* buf, size_t len) {
+        EventLoop* loop = EventLoop::current();
+#if defined(ZLCORO_HAS_IO_URING)
+        if (loop && loop->io_uring()) {
+            // 单个 SQE 的长度是 32 位，超出部分由调用者循环处理
+            auto n = static_cast<unsigned>(std::min<size_t>(len, UINT_MAX));
+            auto pos = static_cast<uint64_t>(offset);
+            while (true) {
+                int res;
+                switch (op) {
+                case IoOp::Read:
+                    res = co_await loop->submit(IoUringPoller::make_read(fd_, buf, n, pos));
+                    break;
+                case IoOp::Write:
+                    res = co_await loop->submit(IoUringPoller::make_write(fd_, buf, n, pos));
+                    break;
+                default:
+                    res = co_await loop->submit(
+                        IoUringPoller::make_fsync(fd_, op == IoOp::DataSync));
+                    break;
+                }
+                if (res != -EINTR) {
+                    co_return res;
+                }
+            }
+        }
+#endif
+        // 完成后回到调用者所在的事件循环，否则回到全局调度器
+        ResumeTarget target = ResumeTarget::scheduler();
+        if (loop) {
+            target = {[](void* context, std::coroutine_handle<> coro) {
+                          static_cast<EventLoop*>(context)->schedule(coro);
+                      },
+                      loop};
+        }
+
+        int fd = fd_;
+        co_return co_await spawn_blocking([=]() noexcept -> int64_t {
+            while (true) {
+                ssize_t ret;
+                switch (op) {
+                case IoOp::Read:
+                    ret = ::pread(fd, buf, len, offset);
+                    break;
+                case IoOp::Write:
+                    ret = ::pwrite(fd, buf, len, offset);
+                    break;
+                case IoOp::Sync:
+                    ret = ::fsync(fd);
+                    break;
+                default:
+                    ret = ::fdatasync(fd);
+                    break;
+                }
+                if (ret >= 0) {
+                    return ret;
+                }
+                if (errno != EINTR) {
+                    return -errno;
+                }
+            }
+        }, target);
+    }
+
 private:
     int fd_;  // 文件描述符
 };
@@ -210,31 +468,53 @@ private:
 // =============================================================================
 
 // 异步读取整个文件
-// 注意：此函数必须通过 async_run() 调用，不要直接 co_await
 inline Task<std::string> read_file(const std::string& path) {
-    // 同步读取文件（在线程池中执行）
     AsyncFile file(path, AsyncFile::ReadOnly);
-    co_return file.read_all();
+
+    struct stat st;
+    if (fstat(file.fd(), &st) == -1) {
+        throw std::runtime_error(
+            std::string("fstat failed: ") + strerror(errno));
+    }
+
+    // 按文件大小一次读取；大小未知（例如 /proc 文件）时按块读取直到末尾
+    std::string content;
+    content.resize(st.st_size > 0 ? static_cast<size_t>(st.st_size) : 4096);
+
+    size_t total = 0;
+    while (true) {
+        if (total == content.size()) {
+            content.resize(content.size() * 2);
+        }
+        size_t n = co_await file.read_at(
+            static_cast<off_t>(total),
+            std::span<char>(content.data() + total, content.size() - total));
+        if (n == 0) {
+            break;
+        }
+        total += n;
+        if (st.st_size > 0 && total == static_cast<size_t>(st.st_size)) {
+            break;
+        }
+    }
+
+    content.resize(total);
+    co_return content;
 }
 
 // 异步写入整个文件
-// 注意：此函数必须通过 async_run() 调用，不要直接 co_await
 inline Task<void> write_file(const std::string& path, const std::string& content) {
-    // 同步写入文件（在线程池中执行）
     AsyncFile file(path, AsyncFile::WriteOnly | AsyncFile::Create | AsyncFile::Truncate);
-    file.write(content);
-    file.sync();
-    co_return;
+    co_await file.write_at(0, content);
+    co_await file.fsync();
 }
 
 // 异步追加到文件
-// 注意：此函数必须通过 async_run() 调用，不要直接 co_await
 inline Task<void> append_file(const std::string& path, const std::string& content) {
-    // 同步追加到文件（在线程池中执行）
     AsyncFile file(path, AsyncFile::WriteOnly | AsyncFile::Create | AsyncFile::Append);
-    file.write(content);
-    file.sync();
-    co_return;
+    // O_APPEND 下 Linux 的 pwrite / io_uring 写入忽略偏移，始终追加到末尾
+    co_await file.write_at(0, content);
+    co_await file.fsync();
 }
 
 } // namespace zlcoro
@@ -1,17 +1,29 @@
 #pragma once
 
+#include "zlcoro/core/cancellation.hpp"
 #include "zlcoro/core/task.hpp"
+#include "async_file.hpp"
+#include "buffer_pool.hpp"
 #include "event_loop.hpp"
+#include <sys/sendfile.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
 #include <cstring>
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include <span>
+#include <system_error>
 #include <utility>
+#include <vector>
 
 namespace zlcoro {
 
@@ -20,17 +32,39 @@ namespace zlcoro {
 // =============================================================================
 // 
 // 提供异步的网络 socket 操作，基于 epoll 实现真正的异步 I/O。
+// 每个 socket 绑定到一个 EventLoop，它的读写协程都在该事件循环中恢复。
+// 默认绑定到当前线程正在运行的事件循环（没有则使用全局实例）。
+// 操作总是先尝试系统调用，返回 EAGAIN 才等待就绪；fd 在第一次等待时
+// 注册到 epoll，直到 close() 才注销，读者和写者可以同时等待。
+//
+// 事件循环启用 io_uring 时，recv / send / connect 直接作为 SQE 提交，
+// 此时 socket 保持阻塞模式（io_uring 内部负责等待，不会阻塞线程）；
+// 如果内核返回 EAGAIN（例如外部传入的非阻塞 fd），退化为等待 epoll 就绪后重试。
+//
+// 监听 socket 在所有后端中都是非阻塞的，accept 基于就绪通知：一次就绪
+// 可以用 accept4 循环取走整个积压队列（accept_many），新连接直接以正确
+// 的模式（epoll 后端非阻塞，两者都 CLOEXEC）创建，不需要额外的 fcntl。
 // =============================================================================
 
 class AsyncSocket {
 public:
     // 构造函数
-    AsyncSocket() : fd_(-1), event_loop_(EventLoop::instance()) {}
+    AsyncSocket() : fd_(-1), event_loop_(&EventLoop::current_or_default()) {}
 
-    explicit AsyncSocket(int fd) : fd_(fd), event_loop_(EventLoop::instance()) {
+    explicit AsyncSocket(EventLoop& loop) : fd_(-1), event_loop_(&loop) {}
+
+    explicit AsyncSocket(int fd) : fd_(fd), event_loop_(&EventLoop::current_or_default()) {
+        make_nonblocking();
+    }
+
+    AsyncSocket(int fd, EventLoop& loop) : fd_(fd), event_loop_(&loop) {
         make_nonblocking();
     }
 
+    // 外部传入的 fd 已经处于正确的模式（例如 io_uring accept 的结果）
+    struct AdoptTag {};
+    AsyncSocket(int fd, EventLoop& loop, AdoptTag) noexcept : fd_(fd), event_loop_(&loop) {}
+
     // 禁止拷贝
     AsyncSocket(const AsyncSocket&) = delete;
     AsyncSocket& operator=(const AsyncSocket&) = delete;
@@ -44,7 +78,7 @@ public:
         if (this != &other) {
             close();
             fd_ = std::exchange(other.fd_, -1);
-            // event_loop_ 是引用，不需要赋值
+            event_loop_ = other.event_loop_;
         }
         return *this;
     }
@@ -64,13 +98,15 @@ public:
                 std::string("socket failed: ") + strerror(errno));
         }
         
-        make_nonblocking();
+        if (!uses_io_uring()) {
+            make_nonblocking();
+        }
     }
 
     // 关闭 socket
     void close() {
         if (fd_ != -1) {
-            event_loop_.unregister(fd_);
+            event_loop_->unregister(fd_);
             ::close(fd_);
             fd_ = -1;
         }
@@ -86,6 +122,11 @@ public:
         return fd_;
     }
 
+    // 获取拥有该 socket 的事件循环
+    EventLoop& event_loop() const noexcept {
+        return *event_loop_;
+    }
+
     // 设置地址重用
     void set_reuse_addr(bool reuse = true) {
         int opt = reuse ? 1 : 0;
@@ -128,12 +169,15 @@ public:
         }
     }
 
-    // 监听
+    // 监听（io_uring 后端下监听 socket 也切换为非阻塞，见 accept）
     void listen(int backlog = 128) {
         if (::listen(fd_, backlog) == -1) {
             throw std::runtime_error(
                 std::string("listen failed: ") + strerror(errno));
         }
+        if (uses_io_uring()) {
+            make_nonblocking();
+        }
     }
 
     // 异步连接
@@ -150,87 +194,250 @@ public:
             throw std::runtime_error("Invalid address: " + host);
         }
         
-        int ret = ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        int err = 0;
+#if defined(ZLCORO_HAS_IO_URING)
+        if (uses_io_uring()) {
+            int res = co_await event_loop_->submit(IoUringPoller::make_connect(
+                fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+            err = res < 0 ? -res : 0;
+        } else
+#endif
+        {
+            int ret = ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            err = ret == 0 ? 0 : errno;
+        }
         
-        if (ret == 0) {
-            co_return;  // 立即连接成功
+        if (err == 0) {
+            co_return;  // 连接成功
         }
         
-        if (errno != EINPROGRESS) {
-            throw std::runtime_error(
-                std::string("connect failed: ") + strerror(errno));
+        if (err != EINPROGRESS && err != EAGAIN) {
+            throw_io_error("connect", err);
         }
         
         // 等待可写（连接完成）
-        co_await WriteAwaiter{fd_, event_loop_};
+        co_await event_loop_->wait_writable(fd_);
         
         // 检查连接错误
         int error = 0;
         socklen_t len = sizeof(error);
         if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len) == -1) {
-            throw std::runtime_error(
-                std::string("getsockopt failed: ") + strerror(errno));
+            throw_io_error("getsockopt", errno);
         }
         
         if (error != 0) {
-            throw std::runtime_error(
-                std::string("connect failed: ") + strerror(error));
+            throw_io_error("connect", error);
         }
         
         co_return;
     }
 
-    // 异步接受连接
+    // 异步接受连接（新连接绑定到与监听 socket 相同的事件循环）
     Task<AsyncSocket> accept() {
         while (true) {
-            co_await ReadAwaiter{fd_, event_loop_};
-            
-            sockaddr_in addr{};
-            socklen_t len = sizeof(addr);
-            
-            int client_fd = ::accept(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+            int client_fd = ::accept4(fd_, nullptr, nullptr, accept_flags());
             
             if (client_fd == -1) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    // 没有连接可接受，继续循环等待
+                    // 没有连接可接受，等待可读后重试
+                    co_await event_loop_->wait_readable(fd_);
                     continue;
                 }
-                throw std::runtime_error(
-                    std::string("accept failed: ") + strerror(errno));
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_io_error("accept", errno);
             }
             
-            co_return AsyncSocket(client_fd);
+            co_return AsyncSocket(client_fd, *event_loop_, AdoptTag{});
+        }
+    }
+
+    // 批量接受连接：等待至少一个连接，然后循环 accept4 直到 EAGAIN 或取满
+    // max_count 个，新连接追加到 out，返回本次接受的数量。
+    // 连接风暴中一次就绪只挂起 / 恢复一次；已经接受了连接之后的错误
+    // （例如 EMFILE）留给下一次调用报告。
+    Task<size_t> accept_many(std::vector<AsyncSocket>& out, size_t max_count = 64) {
+        out.reserve(out.size() + max_count);
+        size_t accepted = 0;
+        while (accepted < max_count) {
+            int client_fd = ::accept4(fd_, nullptr, nullptr, accept_flags());
+            if (client_fd == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (accepted > 0) {
+                    break;  // 积压队列已取空（EAGAIN）或出错：先交付已接受的连接
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await event_loop_->wait_readable(fd_);
+                    continue;
+                }
+                throw_io_error("accept", errno);
+            }
+            out.emplace_back(client_fd, *event_loop_, AdoptTag{});
+            ++accepted;
         }
+        co_return accepted;
     }
 
-    // 异步读取
+    // 放弃 fd 的所有权并返回它（不关闭）。
+    // 只有还没有在事件循环中等待过的 socket（例如刚接受的连接）才能交给
+    // 其他事件循环：等待过的 fd 已经注册到本事件循环的 epoll 中
+    int release() noexcept {
+        return std::exchange(fd_, -1);
+    }
+
+    // 异步读取（返回新分配的字符串，0 字节表示连接关闭）
     Task<std::string> read(size_t max_len = 4096) {
         std::string buffer;
         buffer.resize(max_len);
         
+        size_t n = co_await read(std::as_writable_bytes(std::span<char>(buffer)));
+        buffer.resize(n);
+        co_return buffer;
+    }
+
+    // 读取到调用者提供的缓冲区，返回读取的字节数（0 表示连接关闭）
+    Task<size_t> read(std::span<std::byte> buffer) {
+#if defined(ZLCORO_HAS_IO_URING)
+        if (uses_io_uring()) {
+            while (true) {
+                int res = co_await event_loop_->submit(IoUringPoller::make_recv(
+                    fd_, buffer.data(), clamp_len(buffer.size())));
+                if (res >= 0) {
+                    co_return static_cast<size_t>(res);
+                }
+                if (res == -EAGAIN) {
+                    co_await event_loop_->wait_readable(fd_);  // 非阻塞 fd
+                    continue;
+                }
+                if (res == -EINTR) {
+                    continue;
+                }
+                throw_io_error("read", -res);
+            }
+        }
+#endif
         while (true) {
-            co_await ReadAwaiter{fd_, event_loop_};
-            
-            ssize_t n = ::read(fd_, buffer.data(), max_len);
+            ssize_t n = ::read(fd_, buffer.data(), buffer.size());
             
             if (n == -1) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    // 没有数据，继续循环等待
+                    // 没有数据，等待可读后重试
+                    co_await event_loop_->wait_readable(fd_);
+                    continue;
+                }
+                if (errno == EINTR) {
                     continue;
                 }
-                throw std::runtime_error(
-                    std::string("read failed: ") + strerror(errno));
+                throw_io_error("read", errno);
             }
             
-            if (n == 0) {
-                // 连接关闭
-                buffer.clear();
-            } else {
-                buffer.resize(n);
+            co_return static_cast<size_t>(n);
+        }
+    }
+
+    // 分散读：一次读取到多个缓冲区，返回读取的总字节数（0 表示连接关闭）
+    // iov 指向的数组和缓冲区必须在读取完成前保持有效
+    Task<size_t> readv(std::span<const iovec> iov) {
+        iov = iov.first(std::min<size_t>(iov.size(), IOV_MAX));
+#if defined(ZLCORO_HAS_IO_URING)
+        if (uses_io_uring()) {
+            msghdr msg{};
+            msg.msg_iov = const_cast<iovec*>(iov.data());
+            msg.msg_iovlen = iov.size();
+            while (true) {
+                int res = co_await event_loop_->submit(IoUringPoller::make_recvmsg(fd_, &msg));
+                if (res >= 0) {
+                    co_return static_cast<size_t>(res);
+                }
+                if (res == -EAGAIN) {
+                    co_await event_loop_->wait_readable(fd_);
+                    continue;
+                }
+                if (res == -EINTR) {
+                    continue;
+                }
+                throw_io_error("readv", -res);
+            }
+        }
+#endif
+        while (true) {
+            ssize_t n = ::readv(fd_, iov.data(), static_cast<int>(iov.size()));
+            
+            if (n == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await event_loop_->wait_readable(fd_);
+                    continue;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_io_error("readv", errno);
             }
             
-            co_return buffer;
+            co_return static_cast<size_t>(n);
+        }
+    }
+
+    // 读取到 pool 的一个缓冲区（读取路径上不分配内存）
+    // pool 必须属于本 socket 所在的事件循环；返回空的 PooledBuffer 表示连接关闭
+    Task<PooledBuffer> read(BufferPool& pool) {
+        if (&pool.event_loop() != event_loop_) {
+            throw std::invalid_argument("BufferPool belongs to another event loop");
         }
+        
+#if defined(ZLCORO_HAS_IO_URING)
+        if (pool.kernel_selected()) {
+            while (true) {
+                auto [res, flags] = co_await event_loop_->submit_for_completion(
+                    IoUringPoller::make_recv_select(
+                        fd_, clamp_len(pool.buffer_size()), pool.group_id()));
+                
+                PooledBuffer buffer;
+                if (flags & IORING_CQE_F_BUFFER) {
+                    pool.on_kernel_selected();
+                    auto id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+                    buffer = PooledBuffer(pool, id, res > 0 ? static_cast<size_t>(res) : 0);
+                }
+                if (res >= 0) {
+                    co_return buffer;
+                }
+                if (res == -EAGAIN) {
+                    co_await event_loop_->wait_readable(fd_);
+                    continue;
+                }
+                if (res == -EINTR) {
+                    continue;
+                }
+                if (res == -ENOBUFS) {
+                    if (int err = pool.provide_error()) {
+                        throw_io_error("provide buffers", err);   // 真正的原因
+                    }
+                    throw std::runtime_error("read failed: buffer pool exhausted");
+                }
+                throw_io_error("read", -res);
+            }
+        }
+#endif
+        auto id = pool.acquire();
+        if (!id) {
+            throw std::runtime_error("read failed: buffer pool exhausted");
+        }
+        
+        size_t n = 0;
+        try {
+            n = co_await read(std::span<std::byte>(pool.buffer(*id), pool.buffer_size()));
+        } catch (...) {
+            pool.release(*id);
+            throw;
+        }
+        if (n == 0) {
+            pool.release(*id);  // 连接关闭
+            co_return PooledBuffer();
+        }
+        co_return PooledBuffer(pool, *id, n);
     }
 
     // 异步写入（字符串版本）
@@ -240,19 +447,48 @@ public:
     }
 
     Task<size_t> write(const char* data, size_t len) {
+        return write(std::as_bytes(std::span<const char>(data, len)));
+    }
+
+    // 写入调用者提供的数据（全部写完才返回），返回写入的字节数
+    Task<size_t> write(std::span<const std::byte> data) {
         size_t total_written = 0;
         
-        while (total_written < len) {
-            ssize_t n = ::write(fd_, data + total_written, len - total_written);
+#if defined(ZLCORO_HAS_IO_URING)
+        if (uses_io_uring()) {
+            while (total_written < data.size()) {
+                int res = co_await event_loop_->submit(IoUringPoller::make_send(
+                    fd_, data.data() + total_written,
+                    clamp_len(data.size() - total_written), MSG_NOSIGNAL));
+                if (res >= 0) {
+                    total_written += static_cast<size_t>(res);
+                    continue;
+                }
+                if (res == -EAGAIN) {
+                    co_await event_loop_->wait_writable(fd_);  // 非阻塞 fd
+                    continue;
+                }
+                if (res == -EINTR) {
+                    continue;
+                }
+                throw_io_error("write", -res);
+            }
+            co_return total_written;
+        }
+#endif
+        while (total_written < data.size()) {
+            ssize_t n = ::write(fd_, data.data() + total_written, data.size() - total_written);
             
             if (n == -1) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) {
                     // 缓冲区满，等待可写
-                    co_await WriteAwaiter{fd_, event_loop_};
+                    co_await event_loop_->wait_writable(fd_);
                     continue;
                 }
-                throw std::runtime_error(
-                    std::string("write failed: ") + strerror(errno));
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_io_error("write", errno);
             }
             
             total_written += n;
@@ -261,7 +497,208 @@ public:
         co_return total_written;
     }
 
+    // 聚集写：把多个缓冲区按顺序全部写出，返回写入的总字节数
+    // iov 指向的数组和缓冲区必须在写入完成前保持有效
+    Task<size_t> writev(std::span<const iovec> iov) {
+        size_t total_written = 0;
+        std::vector<iovec> rest;  // 仅在部分写入时使用
+        
+        while (!iov.empty()) {
+            auto batch = iov.first(std::min<size_t>(iov.size(), IOV_MAX));
+            ssize_t n;
+#if defined(ZLCORO_HAS_IO_URING)
+            if (uses_io_uring()) {
+                msghdr msg{};
+                msg.msg_iov = const_cast<iovec*>(batch.data());
+                msg.msg_iovlen = batch.size();
+                int res = co_await event_loop_->submit(
+                    IoUringPoller::make_sendmsg(fd_, &msg, MSG_NOSIGNAL));
+                if (res == -EAGAIN) {
+                    co_await event_loop_->wait_writable(fd_);
+                    continue;
+                }
+                if (res == -EINTR) {
+                    continue;
+                }
+                if (res < 0) {
+                    throw_io_error("writev", -res);
+                }
+                n = res;
+            } else
+#endif
+            {
+                n = ::writev(fd_, batch.data(), static_cast<int>(batch.size()));
+                if (n == -1) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        co_await event_loop_->wait_writable(fd_);
+                        continue;
+                    }
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw_io_error("writev", errno);
+                }
+            }
+            
+            total_written += static_cast<size_t>(n);
+            
+            // 跳过已写完的缓冲区；写了一半的缓冲区需要拷贝 iovec 再调整
+            auto skip = static_cast<size_t>(n);
+            while (!iov.empty() && skip >= iov.front().iov_len) {
+                skip -= iov.front().iov_len;
+                iov = iov.subspan(1);
+            }
+            if (skip > 0) {
+                std::vector<iovec> next(iov.begin(), iov.end());
+                next.front().iov_base = static_cast<char*>(next.front().iov_base) + skip;
+                next.front().iov_len -= skip;
+                rest.swap(next);
+                iov = rest;
+            }
+        }
+        
+        co_return total_written;
+    }
+
+    // 把 file 中从 offset 开始的 count 字节发送出去，数据不经过用户态：
+    // - epoll 后端：sendfile，发送缓冲区满时等待可写后从已发送的位置继续
+    // - io_uring 后端：经过一个管道的两次 IORING_OP_SPLICE（文件 -> 管道 -> socket）；
+    //   内核不支持 SPLICE 时退化为 read_at + write
+    // 返回发送的字节数，小于 count 表示先到达了文件末尾。
+    // 注意：epoll 后端的 sendfile 在事件循环线程中读取文件，页缓存未命中时会阻塞
+    Task<size_t> send_file(AsyncFile& file, off_t offset, size_t count) {
+#if defined(ZLCORO_HAS_IO_URING)
+        if (uses_io_uring()) {
+            if (event_loop_->io_uring()->supports(IORING_OP_SPLICE)) {
+                co_return co_await splice_file(file.fd(), offset, count);
+            }
+            co_return co_await copy_file(file, offset, count);
+        }
+#endif
+        size_t total = 0;
+        while (total < count) {
+            // 单次 sendfile 最多传输 0x7ffff000 字节，offset 由内核推进
+            ssize_t n = ::sendfile(fd_, file.fd(), &offset,
+                                   std::min<size_t>(count - total, 0x7ffff000));
+            if (n == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await event_loop_->wait_writable(fd_);
+                    continue;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_io_error("sendfile", errno);
+            }
+            if (n == 0) {
+                break;  // 文件末尾
+            }
+            total += static_cast<size_t>(n);
+        }
+        co_return total;
+    }
+
+    // 是否通过 io_uring 提交操作
+    bool uses_io_uring() const noexcept {
+        return event_loop_->backend() == IoBackend::IoUring;
+    }
+
 private:
+    // 新连接的模式与 create() 一致：io_uring 后端保持阻塞
+    int accept_flags() const noexcept {
+        return uses_io_uring() ? SOCK_CLOEXEC : SOCK_NONBLOCK | SOCK_CLOEXEC;
+    }
+
+#if defined(ZLCORO_HAS_IO_URING)
+    // send_file 的 io_uring 实现：每轮把最多一个管道容量的数据从文件搬进管道，
+    // 再全部搬到 socket
+    Task<size_t> splice_file(int file_fd, off_t offset, size_t count) {
+        struct Pipe {
+            int fds[2] = {-1, -1};
+            ~Pipe() {
+                for (int fd : fds) {
+                    if (fd != -1) {
+                        ::close(fd);
+                    }
+                }
+            }
+        } pipe;
+        if (::pipe2(pipe.fds, O_CLOEXEC) == -1) {
+            throw std::runtime_error(std::string("pipe2 failed: ") + strerror(errno));
+        }
+        // 尽量扩大管道以减少轮数；失败时保留默认容量
+        ::fcntl(pipe.fds[1], F_SETPIPE_SZ, 1 << 20);
+        int pipe_size = ::fcntl(pipe.fds[1], F_GETPIPE_SZ);
+        const size_t chunk = pipe_size > 0 ? static_cast<size_t>(pipe_size) : 65536;
+
+        size_t total = 0;
+        while (total < count) {
+            int res = co_await event_loop_->submit(IoUringPoller::make_splice(
+                file_fd, offset + static_cast<off_t>(total), pipe.fds[1], -1,
+                static_cast<unsigned>(std::min(count - total, chunk))));
+            if (res == -EINTR) {
+                continue;
+            }
+            if (res < 0) {
+                throw_io_error("splice", -res);
+            }
+            if (res == 0) {
+                break;  // 文件末尾
+            }
+
+            auto in_pipe = static_cast<unsigned>(res);
+            while (in_pipe > 0) {
+                res = co_await event_loop_->submit(IoUringPoller::make_splice(
+                    pipe.fds[0], -1, fd_, -1, in_pipe, SPLICE_F_MOVE));
+                if (res == -EAGAIN) {
+                    co_await event_loop_->wait_writable(fd_);  // 非阻塞 fd
+                    continue;
+                }
+                if (res == -EINTR) {
+                    continue;
+                }
+                if (res < 0) {
+                    throw_io_error("splice", -res);
+                }
+                in_pipe -= static_cast<unsigned>(res);
+                total += static_cast<size_t>(res);
+            }
+        }
+        co_return total;
+    }
+
+    // 内核不支持 SPLICE 时的 send_file：经过用户态缓冲区拷贝
+    Task<size_t> copy_file(AsyncFile& file, off_t offset, size_t count) {
+        auto buffer = std::make_unique<char[]>(65536);
+        size_t total = 0;
+        while (total < count) {
+            size_t n = co_await file.read_at(
+                offset + static_cast<off_t>(total),
+                std::span<char>(buffer.get(), std::min<size_t>(count - total, 65536)));
+            if (n == 0) {
+                break;
+            }
+            co_await write(buffer.get(), n);
+            total += n;
+        }
+        co_return total;
+    }
+#endif
+
+    // 单个 SQE 的长度是 32 位
+    static unsigned clamp_len(size_t len) noexcept {
+        return static_cast<unsigned>(std::min<size_t>(len, UINT_MAX));
+    }
+
+    // 系统调用或 io_uring 操作失败（err 为 errno，调用方可从 code() 取回）；
+    // io_uring 操作被取消令牌取消时以 ECANCELED 完成
+    [[noreturn]] static void throw_io_error(const char* what, int err) {
+        if (err == ECANCELED) {
+            throw OperationCancelled();
+        }
+        throw std::system_error(err, std::generic_category(), std::string(what) + " failed");
+    }
+
     // 设置为非阻塞模式
     void make_nonblocking() {
         int flags = fcntl(fd_, F_GETFL, 0);
@@ -276,41 +713,14 @@ private:
         }
     }
 
-    // 读事件 Awaiter
-    struct ReadAwaiter {
-        int fd;
-        EventLoop& event_loop;
-        
-        bool await_ready() const noexcept {
-            return false;  // 总是挂起
-        }
-        
-        void await_suspend(std::coroutine_handle<> coro) {
-            event_loop.register_read(fd, coro);
-        }
-        
-        void await_resume() const noexcept {}
-    };
-
-    // 写事件 Awaiter
-    struct WriteAwaiter {
-        int fd;
-        EventLoop& event_loop;
-        
-        bool await_ready() const noexcept {
-            return false;  // 总是挂起
-        }
-        
-        void await_suspend(std::coroutine_handle<> coro) {
-            event_loop.register_write(fd, coro);
-        }
-        
-        void await_resume() const noexcept {}
-    };
-
 private:
     int fd_;                    // Socket 文件描述符
-    EventLoop& event_loop_;     // 事件循环引用
+    EventLoop* event_loop_;     // 拥有该 socket 的事件循环
 };
 
+// 把 file 中 [offset, offset + count) 零拷贝地发送到 socket，见 AsyncSocket::send_file
+inline Task<size_t> send_file(AsyncSocket& socket, AsyncFile& file, off_t offset, size_t count) {
+    return socket.send_file(file, offset, count);
+}
+
 } // namespace zlcoro
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "event_loop.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace zlcoro {
+
+class PooledBuffer;
+
+// =============================================================================
+// BufferPool - 供 AsyncSocket::read(BufferPool&) 使用的固定缓冲区池
+// =============================================================================
+//
+// 构造时一次性分配 buffer_count 个 buffer_size 字节的缓冲区，之后读取
+// 不再分配内存：
+// - io_uring 后端：缓冲区通过 IORING_OP_PROVIDE_BUFFERS 交给内核，
+//   recv 时由内核挑选空闲缓冲区填充（provided buffers）；缓冲区组 ID 由
+//   所属的 IoUringPoller 分配，内核拒绝提供缓冲区时读取抛出对应的错误
+// - epoll 后端：从空闲列表取一个缓冲区，就绪后 read 进去
+//
+// 读取结果以 PooledBuffer 返回，析构时缓冲区自动归还。
+//
+// 注意：
+// - BufferPool 属于一个 EventLoop，只能在该事件循环的线程中使用，
+//   PooledBuffer 也必须在该线程中释放
+// - BufferPool 必须在其 EventLoop 之前销毁，且销毁时不能有进行中的读取
+// =============================================================================
+
+class BufferPool {
+public:
+    explicit BufferPool(EventLoop& loop, size_t buffer_size = 4096, size_t buffer_count = 256)
+        : loop_(&loop), buffer_size_(buffer_size), buffer_count_(buffer_count) {
+        if (buffer_size == 0 || buffer_count == 0 || buffer_count > UINT16_MAX + 1u) {
+            throw std::invalid_argument("BufferPool: invalid buffer size or count");
+        }
+        storage_ = std::make_unique<std::byte[]>(buffer_size_ * buffer_count_);
+
+#if defined(ZLCORO_HAS_IO_URING)
+        if (IoUringPoller* ring = loop_->io_uring()) {
+            group_ = ring->acquire_buffer_group();   // 同一 ring 上不会与存活的池重复
+            ring->provide_buffers(storage_.get(), static_cast<unsigned>(buffer_size_),
+                                  static_cast<unsigned>(buffer_count_), group_, 0, true);
+            available_ = buffer_count_;
+            return;
+        }
+#endif
+        free_.reserve(buffer_count_);
+        for (size_t i = buffer_count_; i > 0; --i) {
+            free_.push_back(static_cast<uint16_t>(i - 1));
+        }
+        available_ = buffer_count_;
+    }
+
+    // 禁止拷贝和移动（PooledBuffer 持有指向池的指针）
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    ~BufferPool() {
+#if defined(ZLCORO_HAS_IO_URING)
+        if (IoUringPoller* ring = loop_->io_uring()) {
+            // 立即提交：内核在释放内存之前移除仍由它持有的缓冲区
+            ring->enqueue(IoUringPoller::make_remove_buffers(
+                              static_cast<unsigned>(buffer_count_), group_),
+                          nullptr, true);
+            ring->release_buffer_group(group_);
+        }
+#endif
+    }
+
+    EventLoop& event_loop() const noexcept {
+        return *loop_;
+    }
+
+    size_t buffer_size() const noexcept {
+        return buffer_size_;
+    }
+
+    size_t buffer_count() const noexcept {
+        return buffer_count_;
+    }
+
+    // 未被 PooledBuffer 占用的缓冲区数量
+    size_t available() const noexcept {
+        return available_;
+    }
+
+    // 是否由内核选择缓冲区（io_uring provided buffers）
+    bool kernel_selected() const noexcept {
+#if defined(ZLCORO_HAS_IO_URING)
+        return loop_->io_uring() != nullptr;
+#else
+        return false;
+#endif
+    }
+
+private:
+    friend class PooledBuffer;
+    friend class AsyncSocket;
+
+    std::byte* buffer(uint16_t id) const noexcept {
+        return storage_.get() + static_cast<size_t>(id) * buffer_size_;
+    }
+
+    uint16_t group_id() const noexcept {
+        return group_;
+    }
+
+    // epoll 后端：取一个空闲缓冲区
+    std::optional<uint16_t> acquire() noexcept {
+        if (free_.empty()) {
+            return std::nullopt;
+        }
+        uint16_t id = free_.back();
+        free_.pop_back();
+        --available_;
+        return id;
+    }
+
+    // io_uring 后端：内核已选中一个缓冲区
+    void on_kernel_selected() noexcept {
+        --available_;
+    }
+
+    // 归还缓冲区
+    void release(uint16_t id) {
+        ++available_;
+#if defined(ZLCORO_HAS_IO_URING)
+        if (IoUringPoller* ring = loop_->io_uring()) {
+            ring->provide_buffers(buffer(id), static_cast<unsigned>(buffer_size_), 1, group_, id,
+                                  !loop_->is_in_loop_thread());
+            return;
+        }
+#endif
+        free_.push_back(id);
+    }
+
+    // io_uring 后端：内核拒绝提供缓冲区时的 errno（没有失败为 0）
+    int provide_error() const {
+#if defined(ZLCORO_HAS_IO_URING)
+        if (IoUringPoller* ring = loop_->io_uring()) {
+            return ring->buffer_group_error(group_);
+        }
+#endif
+        return 0;
+    }
+
+private:
+    EventLoop* loop_;
+    size_t buffer_size_;
+    size_t buffer_count_;
+    std::unique_ptr<std::byte[]> storage_;
+    std::vector<uint16_t> free_;   // epoll 后端的空闲缓冲区 ID
+    size_t available_ = 0;
+    uint16_t group_ = 0;           // io_uring 缓冲区组 ID
+};
+
+// =============================================================================
+// PooledBuffer - 从 BufferPool 借出的一块已填充数据的缓冲区
+// =============================================================================
+
+class PooledBuffer {
+public:
+    PooledBuffer() noexcept = default;
+
+    PooledBuffer(BufferPool& pool, uint16_t id, size_t size) noexcept
+        : pool_(&pool), id_(id), size_(size) {}
+
+    // 禁止拷贝
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)), id_(other.id_),
+          size_(std::exchange(other.size_, 0)) {}
+
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_ = std::exchange(other.pool_, nullptr);
+            id_ = other.id_;
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~PooledBuffer() {
+        reset();
+    }
+
+    // 读取到的数据
+    std::span<const std::byte> data() const noexcept {
+        return pool_ ? std::span<const std::byte>(pool_->buffer(id_), size_)
+                     : std::span<const std::byte>();
+    }
+
+    std::string_view view() const noexcept {
+        return pool_ ? std::string_view(reinterpret_cast<const char*>(pool_->buffer(id_)), size_)
+                     : std::string_view();
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    // 0 字节表示连接已关闭
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    // 提前把缓冲区归还给池
+    void reset() {
+        if (pool_) {
+            std::exchange(pool_, nullptr)->release(id_);
+            size_ = 0;
+        }
+    }
+
+private:
+    BufferPool* pool_ = nullptr;
+    uint16_t id_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace zlcoro
@@ -0,0 +1,384 @@
+#pragma once
+
+#include "async_socket.hpp"
+#include "zlcoro/core/task.hpp"
+#include <algorithm>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <utility>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// BufferedReader - AsyncSocket 的带缓冲读取
+// =============================================================================
+//
+// 按行或按长度前缀解析协议时，每次 read() 都是一次系统调用和一个新字符串。
+// BufferedReader 用一个固定容量的环形缓冲区尽量多读，之后从缓冲区中切分：
+//   BufferedReader reader(conn);
+//   std::string line;                                // 调用者复用
+//   while (co_await reader.read_until(line, "\r\n")) { ... }
+//
+//   uint32_t len;
+//   co_await reader.read_exact(std::as_writable_bytes(std::span(&len, 1)));
+//
+// - 环形缓冲区回绕时用 readv 一次填满两段空闲空间
+// - read_exact 请求的长度不小于缓冲区容量且缓冲区已空时直接读到目标中
+// - 单行（含分隔符）不能超过缓冲区容量
+//
+// 注意：BufferedReader 引用 socket，只能在 socket 的事件循环中使用，
+// 同一时刻只能有一个读取在进行
+// =============================================================================
+
+class BufferedReader {
+public:
+    // capacity 向上取整到 2 的幂
+    explicit BufferedReader(AsyncSocket& socket, size_t capacity = 16 * 1024)
+        : socket_(&socket), capacity_(std::bit_ceil(capacity)) {
+        if (capacity == 0) {
+            throw std::invalid_argument("BufferedReader: capacity must be positive");
+        }
+        data_ = std::make_unique<std::byte[]>(capacity_);
+    }
+
+    BufferedReader(const BufferedReader&) = delete;
+    BufferedReader& operator=(const BufferedReader&) = delete;
+
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    // 缓冲区中还没有被取走的字节数
+    size_t buffered() const noexcept {
+        return static_cast<size_t>(tail_ - head_);
+    }
+
+    // 读取到 delimiter（不能为空）为止，line 被替换为包含分隔符的一行。
+    // 连接关闭时最后不完整的一行原样返回；没有数据可返回时返回 false。
+    // 缓冲区已满仍然没有找到分隔符时抛出 std::runtime_error。
+    Task<bool> read_until(std::string& line, std::string_view delimiter) {
+        line.clear();
+        size_t scanned = 0;  // 已经确认不包含分隔符起点的前缀长度
+        while (true) {
+            size_t pos = find(delimiter, scanned);
+            if (pos != npos) {
+                take(line, pos + delimiter.size());
+                co_return true;
+            }
+            scanned = buffered() >= delimiter.size() ? buffered() - delimiter.size() + 1 : 0;
+
+            if (buffered() == capacity_) {
+                throw std::runtime_error("BufferedReader: delimiter not found within buffer capacity");
+            }
+            if (co_await fill() == 0) {
+                if (buffered() == 0) {
+                    co_return false;
+                }
+                take(line, buffered());
+                co_return true;
+            }
+        }
+    }
+
+    // 读满 out，返回读取的字节数（小于 out.size() 表示连接已关闭）
+    Task<size_t> read_exact(std::span<std::byte> out) {
+        size_t total = 0;
+        while (total < out.size()) {
+            if (buffered() == 0) {
+                size_t n;
+                if (out.size() - total >= capacity_) {
+                    n = co_await socket_->read(out.subspan(total));  // 大块读取不经过缓冲区
+                    total += n;
+                } else {
+                    n = co_await fill();
+                }
+                if (n == 0) {
+                    break;
+                }
+                continue;
+            }
+            size_t n = std::min(buffered(), out.size() - total);
+            copy_out(out.data() + total, n);
+            total += n;
+        }
+        co_return total;
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // 从 head_ 之后第 offset 个字节开始的连续可读区间
+    std::span<const std::byte> readable_from(size_t offset) const noexcept {
+        size_t pos = static_cast<size_t>(head_ + offset) & (capacity_ - 1);
+        return {data_.get() + pos, std::min(buffered() - offset, capacity_ - pos)};
+    }
+
+    std::byte byte_at(size_t offset) const noexcept {
+        return data_[static_cast<size_t>(head_ + offset) & (capacity_ - 1)];
+    }
+
+    // 在可读区间中从 from 开始查找 delimiter，返回相对 head_ 的偏移
+    size_t find(std::string_view delimiter, size_t from) const noexcept {
+        const size_t size = buffered();
+        const int first = static_cast<unsigned char>(delimiter.front());
+        size_t pos = from;
+        while (pos + delimiter.size() <= size) {
+            auto segment = readable_from(pos);
+            auto* hit = static_cast<const std::byte*>(
+                std::memchr(segment.data(), first, segment.size()));
+            if (!hit) {
+                pos += segment.size();
+                continue;
+            }
+            size_t candidate = pos + static_cast<size_t>(hit - segment.data());
+            if (candidate + delimiter.size() > size) {
+                return npos;
+            }
+            size_t i = 1;
+            while (i < delimiter.size() &&
+                   byte_at(candidate + i) == static_cast<std::byte>(delimiter[i])) {
+                ++i;
+            }
+            if (i == delimiter.size()) {
+                return candidate;
+            }
+            pos = candidate + 1;
+        }
+        return npos;
+    }
+
+    // 取走 n 个字节到 dst
+    void copy_out(std::byte* dst, size_t n) noexcept {
+        auto first = readable_from(0);
+        size_t len = std::min(n, first.size());
+        std::memcpy(dst, first.data(), len);
+        if (n > len) {
+            std::memcpy(dst + len, data_.get(), n - len);
+        }
+        head_ += n;
+        if (head_ == tail_) {
+            head_ = tail_ = 0;  // 缓冲区为空时回到起点，下次读取不回绕
+        }
+    }
+
+    void take(std::string& out, size_t n) {
+        out.resize(n);
+        copy_out(reinterpret_cast<std::byte*>(out.data()), n);
+    }
+
+    // 把空闲空间读满（可能是一段或回绕后的两段），返回读取的字节数（0 表示连接关闭）
+    Task<size_t> fill() {
+        const size_t free = capacity_ - buffered();
+        const size_t pos = static_cast<size_t>(tail_) & (capacity_ - 1);
+        const size_t first = std::min(free, capacity_ - pos);
+        iovec iov[2] = {{data_.get() + pos, first}, {data_.get(), free - first}};
+        size_t n = co_await socket_->readv(std::span<const iovec>(iov, free > first ? 2 : 1));
+        tail_ += n;
+        co_return n;
+    }
+
+    AsyncSocket* socket_;
+    size_t capacity_;
+    std::unique_ptr<std::byte[]> data_;
+    uint64_t head_ = 0;  // 下一个可读字节的逻辑位置
+    uint64_t tail_ = 0;  // 下一个可写字节的逻辑位置
+};
+
+// =============================================================================
+// BufferedWriter - 合并小写入的 AsyncSocket 写缓冲
+// =============================================================================
+//
+// write() 只把数据追加到缓冲区并在事件循环中安排一次刷出：本轮就绪队列中
+// 所有协程的写入在下一轮合并成一次 writev。
+//   BufferedWriter writer(conn);
+//   co_await writer.write(header);
+//   co_await writer.write(body);     // 与 header 合并发送
+//   ...
+//   co_await writer.flush();         // 销毁之前刷出剩余数据
+//
+// - 刷出期间的新写入追加到另一块缓冲区，不等待
+// - 缓冲的数据达到 limit 时 write() 等待刷出（背压）
+// - 不小于 limit 的写入不拷贝，与已缓冲的数据一起通过 writev 直接发送
+// - cork() 暂停自动刷出（limit 和显式 flush() 仍然生效），uncork() 恢复
+// - 写入失败后错误会保留，之后的 write() / flush() 都会抛出该异常
+//
+// 注意：
+// - BufferedWriter 引用 socket，只能在 socket 的事件循环中使用
+// - 销毁之前必须 co_await flush()：销毁时还没有开始的自动刷出会被取消，
+//   未刷出的数据被丢弃，但不能有进行中的刷出
+// =============================================================================
+
+class BufferedWriter {
+public:
+    explicit BufferedWriter(AsyncSocket& socket, size_t limit = 64 * 1024)
+        : socket_(&socket), limit_(limit),
+          alive_(std::make_shared<BufferedWriter*>(this)) {}
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    ~BufferedWriter() {
+        *alive_ = nullptr;
+    }
+
+    Task<void> write(std::string_view data) {
+        return write(std::as_bytes(std::span<const char>(data.data(), data.size())));
+    }
+
+    // data 只需要在 co_await 返回之前保持有效
+    Task<void> write(std::span<const std::byte> data) {
+        rethrow_if_failed();
+        if (data.size() >= limit_) {
+            co_await wait_idle();
+            co_await drain(data);
+            rethrow_if_failed();
+            co_return;
+        }
+
+        pending_.insert(pending_.end(), data.begin(), data.end());
+        if (pending_.size() >= limit_) {
+            co_await flush();
+        } else {
+            schedule_flush();
+        }
+    }
+
+    // 立即刷出所有缓冲的数据（包括 cork 期间的数据），等待写完
+    Task<void> flush() {
+        co_await wait_idle();
+        if (!pending_.empty()) {
+            co_await drain({});
+        }
+        rethrow_if_failed();
+    }
+
+    void cork() noexcept {
+        corked_ = true;
+    }
+
+    void uncork() {
+        corked_ = false;
+        schedule_flush();
+    }
+
+    // 缓冲中还没有写出的字节数
+    size_t buffered() const noexcept {
+        return pending_.size();
+    }
+
+    // 已经提交的 writev 次数（用于观察合并效果）
+    uint64_t flush_count() const noexcept {
+        return flushes_;
+    }
+
+private:
+    // 等待进行中的刷出结束，在事件循环中恢复
+    class FlushWaiter {
+    public:
+        explicit FlushWaiter(BufferedWriter* writer) noexcept : writer_(writer) {}
+
+        bool await_ready() const noexcept {
+            return !writer_->flushing_;
+        }
+
+        void await_suspend(std::coroutine_handle<> coro) {
+            writer_->waiters_.push_back(coro);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        BufferedWriter* writer_;
+    };
+
+    Task<void> wait_idle() {
+        // 被恢复之前可能已有其他等待者开始了新的刷出
+        while (flushing_) {
+            co_await FlushWaiter{this};
+        }
+        rethrow_if_failed();
+    }
+
+    void rethrow_if_failed() const {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    void schedule_flush() {
+        if (flush_scheduled_ || flushing_ || corked_ || pending_.empty()) {
+            return;  // 进行中的刷出会继续写出新追加的数据
+        }
+        flush_scheduled_ = true;
+        socket_->event_loop().spawn(deferred_flush(alive_));
+    }
+
+    // 新调度的协程排在本轮就绪队列之后执行，本轮的写入都已经追加到缓冲区
+    static Task<void> deferred_flush(std::shared_ptr<BufferedWriter*> alive) {
+        BufferedWriter* self = *alive;
+        if (!self) {
+            co_return;  // 写缓冲已经销毁
+        }
+        self->flush_scheduled_ = false;
+        if (self->flushing_ || self->corked_ || self->pending_.empty()) {
+            co_return;
+        }
+        co_await self->drain({});  // 错误保存在 error_ 中，由下一次 write / flush 报告
+    }
+
+    // 写出缓冲的数据（第一次还包括 tail），直到缓冲区为空；在 wait_idle 之后调用
+    Task<void> drain(std::span<const std::byte> tail) {
+        flushing_ = true;
+        try {
+            while (!pending_.empty() || !tail.empty()) {
+                inflight_.swap(pending_);
+                iovec iov[2];
+                size_t count = 0;
+                if (!inflight_.empty()) {
+                    iov[count++] = {inflight_.data(), inflight_.size()};
+                }
+                if (!tail.empty()) {
+                    iov[count++] = {const_cast<std::byte*>(tail.data()), tail.size()};
+                    tail = {};
+                }
+                ++flushes_;
+                co_await socket_->writev(std::span<const iovec>(iov, count));
+                inflight_.clear();  // 保留容量，与 pending_ 交替使用
+            }
+        } catch (...) {
+            error_ = std::current_exception();
+            pending_.clear();
+            inflight_.clear();
+        }
+        flushing_ = false;
+
+        for (auto waiter : std::exchange(waiters_, {})) {
+            socket_->event_loop().schedule(waiter);
+        }
+    }
+
+    AsyncSocket* socket_;
+    size_t limit_;
+    std::vector<std::byte> pending_;    // 等待刷出的数据
+    std::vector<std::byte> inflight_;   // 正在写出的数据
+    std::vector<std::coroutine_handle<>> waiters_;
+    std::exception_ptr error_;
+    uint64_t flushes_ = 0;
+    bool flushing_ = false;
+    bool flush_scheduled_ = false;
+    bool corked_ = false;
+    std::shared_ptr<BufferedWriter*> alive_;  // 还没有开始的自动刷出据此判断写缓冲是否还在
+};
+
+} // namespace zlcoro
@@ -2,9 +2,11 @@
 
 #include <sys/epoll.h>
 #include <unistd.h>
+#include <atomic>
 #include <coroutine>
+#include <cstdint>
 #include <stdexcept>
-#include <map>
+#include <memory>
 #include <vector>
 #include <cstring>
 
@@ -16,8 +18,84 @@ namespace zlcoro {
 // 
 // 封装 Linux epoll API，用于高效的 I/O 事件监听。
 // 支持注册文件描述符，等待事件，并在事件就绪时恢复协程。
+//
+// 事件处理器按 fd 直接索引，存放在分页表中（每页 page_size 个，按需分配，
+// 分配后地址不变）。epoll_event.data.ptr 直接指向处理器，分发一个事件只
+// 访问一个处理器，不需要查找。
+//
+// 两种注册方式：
+// - add()/modify()：一次性的 (事件, 协程) 注册，每次等待都要 epoll_ctl
+// - watch()：fd 以 EPOLLIN|EPOLLOUT|EPOLLET 注册一次，直到 remove()；
+//   读、写各有一个等待槽（IoWaiter），边沿事件只更新等待槽，
+//   读者和写者可以同时等待同一个 fd，之后的等待不再需要 epoll_ctl
 // =============================================================================
 
+// =============================================================================
+// IoWaiter - 单方向（读或写）的等待槽
+// =============================================================================
+//
+// 状态为三者之一（类似 Go netpoll 的 pollDesc）：
+// - Empty：没有缓存的就绪事件，也没有等待者
+// - Ready：上次边沿之后还没有被消费（await_ready 可以直接返回 true）
+// - 协程句柄地址：有一个协程在等待
+//
+// 使用方式：先执行系统调用，返回 EAGAIN 后才等待。Ready 可能是旧的边沿，
+// 消费后系统调用最多再多返回一次 EAGAIN，不会丢失事件。
+// 状态是原子的：事件循环线程发布就绪，等待者可以在任意线程。
+// =============================================================================
+
+class IoWaiter {
+public:
+    // 消费缓存的就绪标志，返回 true 表示不需要挂起
+    bool consume_ready() noexcept {
+        uintptr_t expected = ready_state;
+        return state_.load(std::memory_order_acquire) == ready_state &&
+               state_.compare_exchange_strong(expected, empty_state,
+                                              std::memory_order_acq_rel);
+    }
+
+    // 挂起 coro 等待下一次边沿；返回 false 表示期间已就绪，不需要挂起
+    bool park(std::coroutine_handle<> coro) noexcept {
+        uintptr_t expected = empty_state;
+        if (state_.compare_exchange_strong(expected,
+                                           reinterpret_cast<uintptr_t>(coro.address()),
+                                           std::memory_order_acq_rel)) {
+            return true;
+        }
+        // 只有 Ready 会让 CAS 失败（同一方向只允许一个等待者）
+        state_.store(empty_state, std::memory_order_release);
+        return false;
+    }
+
+    // 发布一次边沿：有等待者时取出并返回它，否则缓存为 Ready
+    std::coroutine_handle<> notify() noexcept {
+        uintptr_t old = state_.exchange(ready_state, std::memory_order_acq_rel);
+        if (old == empty_state || old == ready_state) {
+            return nullptr;
+        }
+        // 被唤醒的协程会重试系统调用，不再需要 Ready
+        state_.store(empty_state, std::memory_order_release);
+        return std::coroutine_handle<>::from_address(reinterpret_cast<void*>(old));
+    }
+
+    // 撤销 coro 的等待（取消）：返回 true 表示 coro 仍在等待且已被移除，
+    // 由调用者负责恢复它；返回 false 表示 notify() 已经取走了它
+    bool cancel(std::coroutine_handle<> coro) noexcept {
+        uintptr_t expected = reinterpret_cast<uintptr_t>(coro.address());
+        return state_.compare_exchange_strong(expected, empty_state, std::memory_order_acq_rel);
+    }
+
+    void reset() noexcept {
+        state_.store(empty_state, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uintptr_t empty_state = 0;
+    static constexpr uintptr_t ready_state = 1;
+
+    std::atomic<uintptr_t> state_{empty_state};
+};
+
 class EpollPoller {
 public:
     // 事件类型
@@ -31,10 +109,26 @@ public:
 
     // 事件回调信息
     struct EventHandler {
-        std::coroutine_handle<> coro;  // 要恢复的协程
-        uint32_t events;                // 监听的事件
+        std::coroutine_handle<> coro;  // 要恢复的协程（add/modify）
+        uint32_t events = 0;            // 监听的事件
+        bool registered = false;        // 是否已注册到 epoll
+        bool persistent = false;        // 是否由 watch() 注册
+        IoWaiter reader;                // 读等待槽（watch）
+        IoWaiter writer;                // 写等待槽（watch）
+
+        void reset() noexcept {
+            coro = nullptr;
+            events = 0;
+            registered = false;
+            persistent = false;
+            reader.reset();
+            writer.reset();
+        }
     };
 
+    // watch() 注册的事件
+    static constexpr uint32_t persistent_events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+
     // 构造函数：创建 epoll 实例
     EpollPoller() {
         epfd_ = epoll_create1(0);
@@ -57,9 +151,11 @@ public:
 
     // 添加文件描述符监听
     void add(int fd, uint32_t events, std::coroutine_handle<> coro) {
+        EventHandler& handler = slot(fd);
+        
         epoll_event ev;
         ev.events = events;
-        ev.data.fd = fd;
+        ev.data.ptr = &handler;
         
         if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
             throw std::runtime_error(
@@ -67,21 +163,56 @@ public:
         }
         
         // 记录事件处理器
-        handlers_[fd] = EventHandler{coro, events};
+        handler.reset();
+        handler.coro = coro;
+        handler.events = events;
+        handler.registered = true;
     }
 
     // 修改文件描述符监听的事件
     void modify(int fd, uint32_t events, std::coroutine_handle<> coro) {
+        EventHandler& handler = slot(fd);
+        
         epoll_event ev;
         ev.events = events;
-        ev.data.fd = fd;
+        ev.data.ptr = &handler;
         
         if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) == -1) {
             throw std::runtime_error(
                 std::string("epoll_ctl MOD failed: ") + strerror(errno));
         }
         
-        handlers_[fd] = EventHandler{coro, events};
+        handler.reset();
+        handler.coro = coro;
+        handler.events = events;
+        handler.registered = true;
+    }
+
+    // 以 EPOLLIN|EPOLLOUT|EPOLLET 持久注册 fd（已注册时不做任何系统调用），
+    // 返回其处理器，通过 reader / writer 等待槽等待
+    EventHandler& watch(int fd) {
+        EventHandler& handler = slot(fd);
+        if (handler.persistent) {
+            return handler;
+        }
+        if (handler.registered) {
+            throw std::logic_error("EpollPoller: fd already registered with add()");
+        }
+
+        epoll_event ev;
+        ev.events = persistent_events;
+        ev.data.ptr = &handler;
+
+        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            throw std::runtime_error(
+                std::string("epoll_ctl ADD failed: ") + strerror(errno));
+        }
+
+        handler.reset();
+        handler.events = persistent_events;
+        handler.registered = true;
+        handler.persistent = true;
+        return handler;
     }
 
     // 移除文件描述符
@@ -94,50 +225,76 @@ public:
             }
         }
         
-        handlers_.erase(fd);
+        // 处理器本身保留在表中：本轮 poll 中尚未分发的事件看到
+        // registered == false 后会被忽略
+        if (EventHandler* handler = find(fd)) {
+            handler->reset();
+        }
     }
 
     // 轮询事件（阻塞指定时间）
     // timeout_ms: 超时时间（毫秒），-1 表示永久阻塞
-    // 返回：就绪的协程句柄列表
-    std::vector<std::coroutine_handle<>> poll(int timeout_ms = -1) {
+    // 就绪的协程句柄追加到 ready（调用者可以复用同一个 vector），返回追加的数量
+    size_t poll(int timeout_ms, std::vector<std::coroutine_handle<>>& ready) {
         epoll_event events[max_events_];
         
         int n = epoll_wait(epfd_, events, max_events_, timeout_ms);
         
         if (n == -1) {
             if (errno == EINTR) {
-                // 被信号中断，返回空列表
-                return {};
+                // 被信号中断
+                return 0;
             }
             throw std::runtime_error(
                 std::string("epoll_wait failed: ") + strerror(errno));
         }
         
-        // 收集就绪的协程（使用 set 去重）
-        std::vector<std::coroutine_handle<>> ready_coros;
-        ready_coros.reserve(n);
-        
+        size_t count = 0;
         for (int i = 0; i < n; ++i) {
-            int fd = events[i].data.fd;
+            auto* handler = static_cast<EventHandler*>(events[i].data.ptr);
             uint32_t revents = events[i].events;
             
-            auto it = handlers_.find(fd);
-            if (it != handlers_.end()) {
-                // 检查是否触发了我们关心的事件或错误事件
-                // 错误事件（EPOLLERR | EPOLLHUP）总是需要处理
-                if ((revents & it->second.events) || (revents & (EPOLLERR | EPOLLHUP))) {
-                    ready_coros.push_back(it->second.coro);
+            if (handler->persistent) {
+                // 错误和挂断同时唤醒两个方向，由系统调用报告具体错误
+                constexpr uint32_t failure = EPOLLERR | EPOLLHUP;
+                if (revents & (EPOLLIN | EPOLLRDHUP | failure)) {
+                    if (auto coro = handler->reader.notify()) {
+                        ready.push_back(coro);
+                        ++count;
+                    }
+                }
+                if (revents & (EPOLLOUT | failure)) {
+                    if (auto coro = handler->writer.notify()) {
+                        ready.push_back(coro);
+                        ++count;
+                    }
                 }
+                continue;
+            }
+            
+            // 检查是否触发了我们关心的事件或错误事件
+            // 错误事件（EPOLLERR | EPOLLHUP）总是需要处理
+            if (handler->registered &&
+                ((revents & handler->events) || (revents & (EPOLLERR | EPOLLHUP)))) {
+                ready.push_back(handler->coro);
+                ++count;
             }
         }
         
-        return ready_coros;
+        return count;
+    }
+
+    // 同上，返回新的就绪协程列表
+    std::vector<std::coroutine_handle<>> poll(int timeout_ms = -1) {
+        std::vector<std::coroutine_handle<>> ready;
+        poll(timeout_ms, ready);
+        return ready;
     }
 
     // 检查文件描述符是否已注册
     bool has(int fd) const {
-        return handlers_.find(fd) != handlers_.end();
+        const EventHandler* handler = find(fd);
+        return handler && handler->registered;
     }
 
     // 获取 epoll 文件描述符
@@ -145,9 +302,43 @@ public:
         return epfd_;
     }
 
+private:
+    static constexpr size_t page_size = 1024;          // 每页的处理器数量
+
+    struct Page {
+        EventHandler handlers[page_size];
+    };
+
+    // 获取 fd 对应的处理器（所在页不存在时分配）
+    EventHandler& slot(int fd) {
+        if (fd < 0) {
+            throw std::invalid_argument("EpollPoller: invalid fd");
+        }
+        size_t index = static_cast<size_t>(fd) / page_size;
+        if (index >= pages_.size()) {
+            pages_.resize(index + 1);
+        }
+        if (!pages_[index]) {
+            pages_[index] = std::make_unique<Page>();
+        }
+        return pages_[index]->handlers[static_cast<size_t>(fd) % page_size];
+    }
+
+    // 查找 fd 对应的处理器（所在页不存在时返回 nullptr）
+    EventHandler* find(int fd) const noexcept {
+        if (fd < 0) {
+            return nullptr;
+        }
+        size_t index = static_cast<size_t>(fd) / page_size;
+        if (index >= pages_.size() || !pages_[index]) {
+            return nullptr;
+        }
+        return &pages_[index]->handlers[static_cast<size_t>(fd) % page_size];
+    }
+
 private:
     int epfd_ = -1;                                    // epoll 文件描述符
-    std::map<int, EventHandler> handlers_;             // 文件描述符 -> 事件处理器
+    std::vector<std::unique_ptr<Page>> pages_;         // fd -> 事件处理器（分页）
     static constexpr int max_events_ = 128;            // 一次最多处理的事件数
 };
 
@@ -1,131 +1,543 @@
 #pragma once
 
 #include "epoll_poller.hpp"
+#include "io_uring_poller.hpp"
+#include "timer_wheel.hpp"
+#include "zlcoro/core/cancellation.hpp"
+#include "zlcoro/core/detached_task.hpp"
+#include "zlcoro/core/executor.hpp"
+#include "zlcoro/core/metrics.hpp"
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/scheduler/mpmc_queue.hpp"
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <coroutine>
 #include <deque>
 #include <mutex>
 #include <atomic>
 #include <chrono>
 #include <functional>
-#include <map>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace zlcoro {
 
+// I/O 后端选择
+enum class IoBackend {
+    Auto,     // io_uring 可用时使用 io_uring，否则 epoll
+    Epoll,    // 只使用 epoll 就绪通知
+    IoUring   // 优先 io_uring（不可用时回退到 epoll）
+};
+
+// EventLoop 的指标快照（各项分别读取，彼此之间不保证一致）
+struct EventLoopMetrics {
+    uint64_t iterations = 0;            // 循环轮数
+    uint64_t polls = 0;                 // epoll_wait 调用次数
+    uint64_t io_events = 0;             // poll 返回的就绪协程总数（含 io_uring 完成）
+    uint64_t tasks_run = 0;             // 就绪队列中恢复的协程数
+    uint64_t timers_fired = 0;          // 触发的定时器数
+    uint64_t ready_queue_depth = 0;     // 最近一轮就绪队列的长度
+    HistogramSnapshot events_per_poll;  // 每次 poll 返回的就绪协程数
+    HistogramSnapshot timer_lag;        // 每轮到期定时器的最大延迟（纳秒，1ms 精度）
+    HistogramSnapshot loop_latency;     // 每轮循环除 poll 阻塞外的耗时（纳秒）
+
+    // 转成 Prometheus 文本格式；labels 形如 loop="0"，可以为空
+    std::string to_prometheus(std::string_view prefix = "zlcoro_event_loop",
+                              std::string_view labels = {}) const {
+        std::string out;
+        std::string p(prefix);
+        auto counter = [&](const char* name, uint64_t value) {
+            append_prometheus_header(out, p + name, "counter");
+            append_prometheus_sample(out, p + name, "", labels, value);
+        };
+        counter("_iterations_total", iterations);
+        counter("_polls_total", polls);
+        counter("_io_events_total", io_events);
+        counter("_tasks_run_total", tasks_run);
+        counter("_timers_fired_total", timers_fired);
+
+        append_prometheus_header(out, p + "_ready_queue_depth", "gauge");
+        append_prometheus_sample(out, p + "_ready_queue_depth", "", labels, ready_queue_depth);
+
+        append_prometheus_header(out, p + "_events_per_poll", "histogram");
+        append_prometheus_histogram(out, p + "_events_per_poll", labels, events_per_poll);
+        append_prometheus_header(out, p + "_timer_lag_seconds", "histogram");
+        append_prometheus_histogram(out, p + "_timer_lag_seconds", labels, timer_lag, 1e-9);
+        append_prometheus_header(out, p + "_loop_latency_seconds", "histogram");
+        append_prometheus_histogram(out, p + "_loop_latency_seconds", labels, loop_latency, 1e-9);
+        return out;
+    }
+};
+
 // =============================================================================
 // EventLoop - 事件循环
 // =============================================================================
 // 
 // 管理 I/O 事件和协程调度的核心组件。
 // 使用 Reactor 模式，在单线程中处理所有 I/O 事件和协程。
+// 可以有多个 EventLoop（见 EventLoopGroup），每个拥有自己的 EpollPoller，
+// 由各自的线程运行；fd 上的协程始终在拥有该 fd 的 EventLoop 中恢复。
+//
+// 启用 io_uring 后端时，读写等操作以 SQE 提交，io_uring 的 fd 注册在
+// epoll 中：每轮循环统一提交一次 SQE，并从完成队列收割结果。
+// 环境变量 ZLCORO_IO_BACKEND=epoll 可在运行期强制使用 epoll。
+//
+// 没有就绪协程时 epoll_wait 一直阻塞到最近的定时器到期；其他线程调度
+// 协程、添加定时器或调用 stop() 时，通过 eventfd 唤醒事件循环。
+//
+// 运行时指标见 metrics()：计数器只由事件循环线程写入，任意线程可以读取。
+//
+// 就绪队列分两条路径：
+// - 事件循环线程内的 schedule()（I/O 完成、定时器、协程互相唤醒）直接
+//   追加到本地 vector，不加锁也没有原子操作
+// - 其他线程的 schedule() 进入无锁注入队列（满时退化到有锁的溢出队列），
+//   每轮循环最多写一次 eventfd（唤醒合并）
 // =============================================================================
 
-class EventLoop {
+class EventLoop : public Executor {
 public:
     // 定时器 ID 类型
-    using TimerId = uint64_t;
+    using TimerId = TimerWheel::TimerId;
     
     // 定时器回调
-    using TimerCallback = std::function<void()>;
+    using TimerCallback = TimerWheel::Callback;
 
-    EventLoop() : running_(false), next_timer_id_(0) {}
+    explicit EventLoop(IoBackend backend = default_backend())
+        : running_(false) {
+        wakeup_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeup_fd_ == -1) {
+            throw std::runtime_error(
+                std::string("eventfd failed: ") + strerror(errno));
+        }
+        // 边缘触发：每次 write 产生一个事件，唤醒 epoll_wait 即可
+        poller_.add(wakeup_fd_, EpollPoller::Read | EpollPoller::EdgeTriggered,
+                    std::noop_coroutine());
+
+#if defined(ZLCORO_HAS_IO_URING)
+        if (backend != IoBackend::Epoll) {
+            try {
+                uring_ = std::make_unique<IoUringPoller>();
+                // 完成队列非空时 ring fd 可读：用 noop 协程唤醒 epoll_wait 即可
+                poller_.add(uring_->fd(), EpollPoller::Read, std::noop_coroutine());
+            } catch (const std::exception&) {
+                uring_.reset();  // 内核不支持或资源受限，回退到 epoll
+            }
+        }
+#else
+        (void)backend;
+#endif
+    }
 
     // 禁止拷贝
     EventLoop(const EventLoop&) = delete;
     EventLoop& operator=(const EventLoop&) = delete;
 
+    ~EventLoop() {
+        ::close(wakeup_fd_);
+    }
+
     // 获取全局事件循环实例（单例）
     static EventLoop& instance() {
         static EventLoop loop;
         return loop;
     }
 
+    // 默认后端：读取环境变量 ZLCORO_IO_BACKEND（epoll / io_uring）
+    static IoBackend default_backend() noexcept {
+        const char* env = std::getenv("ZLCORO_IO_BACKEND");
+        if (env && std::strcmp(env, "epoll") == 0) {
+            return IoBackend::Epoll;
+        }
+        if (env && std::strcmp(env, "io_uring") == 0) {
+            return IoBackend::IoUring;
+        }
+        return IoBackend::Auto;
+    }
+
+    // 实际使用的后端
+    IoBackend backend() const noexcept {
+#if defined(ZLCORO_HAS_IO_URING)
+        if (uring_) {
+            return IoBackend::IoUring;
+        }
+#endif
+        return IoBackend::Epoll;
+    }
+
+#if defined(ZLCORO_HAS_IO_URING)
+    // io_uring 提交队列（未启用时返回 nullptr）
+    IoUringPoller* io_uring() noexcept {
+        return uring_.get();
+    }
+
+    // 提交一个 io_uring 操作并等待完成，co_await 结果为 CQE 的 res
+    // 在事件循环线程中调用时批量提交，否则立即提交
+    IoUringPoller::OpAwaiter submit(const IoUringPoller::Request& req) {
+        return IoUringPoller::OpAwaiter{uring_.get(), req, !is_in_loop_thread()};
+    }
+
+    // 同 submit，co_await 结果为包含 CQE 标志的 Completion
+    IoUringPoller::CompletionAwaiter submit_for_completion(const IoUringPoller::Request& req) {
+        return IoUringPoller::CompletionAwaiter{uring_.get(), req, !is_in_loop_thread()};
+    }
+#endif
+
+    // 当前线程正在运行的事件循环（不在任何 run() 中时返回 nullptr）
+    static EventLoop* current() noexcept {
+        return current_loop_;
+    }
+
+    // 当前线程的事件循环，如果没有则返回全局实例
+    static EventLoop& current_or_default() noexcept {
+        return current_loop_ ? *current_loop_ : instance();
+    }
+
+    // 当前线程是否是运行本事件循环的线程
+    bool is_in_loop_thread() const noexcept {
+        return current_loop_ == this;
+    }
+
+    // 读取指标快照（任意线程）
+    EventLoopMetrics metrics() const {
+        EventLoopMetrics result;
+        result.iterations = iterations_.load();
+        result.polls = polls_.load();
+        result.io_events = io_events_.load();
+        result.tasks_run = tasks_run_.load();
+        result.timers_fired = timers_fired_.load();
+        result.ready_queue_depth = ready_queue_depth_.load();
+        result.events_per_poll = events_per_poll_.snapshot();
+        result.timer_lag = timer_lag_.snapshot();
+        result.loop_latency = loop_latency_.snapshot();
+        return result;
+    }
+
     // 运行事件循环（阻塞）
     void run() {
         running_ = true;
+        run_until_stopped();
+    }
+
+private:
+    friend class EventLoopGroup;
+
+    // 事件循环主体，不修改 running_
+    // EventLoopGroup 在创建线程之前置位 running_，线程启动前到达的 stop() 不会被覆盖
+    void run_until_stopped() {
+        EventLoop* previous = std::exchange(current_loop_, this);
+        detail::trace_register_thread();
+        CurrentScope executor_scope(this);
+        auto busy_start = metrics_now();
         
         while (running_) {
+            iterations_.add();
+
             // 1. 执行所有待调度的协程
             process_ready_queue();
             
             // 2. 检查并执行到期的定时器
             auto next_timeout = process_timers();
+            if (has_ready_work()) {
+                next_timeout = 0;  // 回调或协程又调度了协程，不阻塞
+            }
             
-            // 3. 等待 I/O 事件
+#if defined(ZLCORO_HAS_IO_URING)
+            // 3. 批量提交本轮积攒的 io_uring 操作
+            if (uring_) {
+                uring_->submit();
+                if (uring_->has_completions()) {
+                    next_timeout = 0;
+                } else if (uring_->has_backlog() && (next_timeout < 0 || next_timeout > 1)) {
+                    next_timeout = 1;  // 内核暂时不接收提交：稍后重试，不在锁内忙等
+                }
+            }
+#endif
+
+            // 4. 等待 I/O 事件
             if (running_) {
-                auto ready_coros = poller_.poll(next_timeout);
+                if constexpr (metrics_enabled) {
+                    loop_latency_.record(metrics_now() - busy_start);
+                }
+                io_ready_.clear();
+                poller_.poll(next_timeout, io_ready_);
+                busy_start = metrics_now();
+                drain_wakeups();
                 
+#if defined(ZLCORO_HAS_IO_URING)
+                // 收割 io_uring 完成的操作
+                if (uring_) {
+                    uring_->reap(io_ready_);
+                }
+#endif
+                polls_.add();
+                io_events_.add(io_ready_.size());
+                events_per_poll_.record(static_cast<uint64_t>(io_ready_.size()));
+
                 // 将就绪的协程加入队列
-                for (auto coro : ready_coros) {
+                for (auto coro : io_ready_) {
                     schedule(coro);
                 }
             }
         }
+
+        current_loop_ = previous;
     }
 
-    // 停止事件循环
+public:
+    // 停止事件循环（可以在任意线程调用）
     void stop() {
         running_ = false;
+        wakeup();
+    }
+
+    // 唤醒阻塞在 epoll_wait 中的事件循环
+    // 事件循环清除标志之前的多次唤醒只写一次 eventfd
+    void wakeup() noexcept {
+        if (wakeup_pending_.exchange(true, std::memory_order_acq_rel)) {
+            return;  // 已有未处理的唤醒
+        }
+        uint64_t one = 1;
+        ssize_t n = ::write(wakeup_fd_, &one, sizeof(one));
+        (void)n;  // 计数器溢出（EAGAIN）时事件循环必然处于可读状态，忽略
     }
 
     // 调度一个协程（加入就绪队列）
     void schedule(std::coroutine_handle<> coro) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        ready_queue_.push_back(coro);
+        if (is_in_loop_thread()) {
+            local_ready_.push_back(coro);  // 快速路径：只有本线程访问
+            return;
+        }
+
+        if (!injection_queue_.try_push(coro)) {
+            // 注入队列已满：退化到有锁的溢出队列
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            overflow_queue_.push_back(coro);
+            overflowed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        wakeup();
     }
 
-    // 注册文件描述符的读事件
-    void register_read(int fd, std::coroutine_handle<> coro) {
-        if (poller_.has(fd)) {
-            poller_.modify(fd, EpollPoller::Read | EpollPoller::EdgeTriggered, coro);
-        } else {
-            poller_.add(fd, EpollPoller::Read | EpollPoller::EdgeTriggered, coro);
+    // Executor 接口：排到就绪队列尾部（co_await resume_on(loop) / yield()）
+    void execute(std::coroutine_handle<> coro) override {
+        schedule(coro);
+    }
+
+    // 在本事件循环中启动一个协程（不等待结果，协程结束后自动销毁）
+    void spawn(Task<void> task) {
+        auto detached = detail::make_detached(std::move(task));
+        schedule(detached.handle());
+    }
+
+    // =========================================================================
+    // fd 就绪等待
+    // =========================================================================
+    //
+    // fd 在第一次等待时以 EPOLLIN|EPOLLOUT|EPOLLET 注册，之后一直保持注册，
+    // 直到 unregister()。读和写使用各自的等待槽，可以同时等待。
+    // 调用方应先执行系统调用，返回 EAGAIN 后再等待：
+    //   while ((n = ::read(fd, buf, len)) == -1 && errno == EAGAIN) {
+    //       co_await loop.wait_readable(fd);
+    //   }
+    // 注册只能在事件循环线程中进行（AsyncSocket 的操作都在该线程中执行）。
+    //
+    // 等待者的取消令牌被请求停止时（任意线程），等待从等待槽中撤销，
+    // 协程在事件循环中恢复并抛出 OperationCancelled。
+
+    class ReadinessAwaiter {
+    public:
+        ReadinessAwaiter(EventLoop& loop, IoWaiter& waiter, const char* name) noexcept
+            : loop_(&loop), waiter_(&waiter), name_(name) {}
+
+        // 已缓存就绪事件时不挂起，也不需要系统调用
+        bool await_ready() noexcept {
+            return waiter_->consume_ready();
         }
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> coro) {
+            std::stop_token token = detail::stop_token_of(coro);
+            if (token.stop_requested()) {
+                cancelled_ = true;
+                return false;
+            }
+            coro_ = coro;
+            detail::trace_suspend(coro.address(), name_);
+            if (!waiter_->park(coro)) {
+                return false;
+            }
+            // 在事件循环线程中挂起：返回之前 notify() 不会恢复协程
+            if (token.stop_possible()) {
+                cancel_.emplace(std::move(token), Canceller{this});
+            }
+            return true;
+        }
+
+        void await_resume() {
+            cancel_.reset();  // 等待可能正在其他线程中执行的取消回调结束
+            if constexpr (tracing_enabled) {
+                if (coro_) {
+                    detail::trace_resume(coro_.address(), name_);
+                }
+            }
+            if (cancelled_) {
+                throw OperationCancelled();
+            }
+        }
+
+    private:
+        struct Canceller {
+            ReadinessAwaiter* self;
+
+            void operator()() const noexcept {
+                self->cancel();
+            }
+        };
+
+        // 取消回调：仍在等待槽中时撤销等待并恢复协程；已被 notify() 取走时什么也不做
+        void cancel() noexcept {
+            if (waiter_->cancel(coro_)) {
+                cancelled_ = true;
+                loop_->schedule(coro_);
+            }
+        }
+
+        EventLoop* loop_;
+        IoWaiter* waiter_;
+        const char* name_;                       // 追踪中的等待点名称
+        std::coroutine_handle<> coro_ = nullptr;
+        bool cancelled_ = false;
+        std::optional<std::stop_callback<Canceller>> cancel_;
+    };
+
+    // 等待 fd 可读（或出错、对端关闭）
+    ReadinessAwaiter wait_readable(int fd) {
+        return ReadinessAwaiter{*this, poller_.watch(fd).reader, "wait_readable"};
     }
 
-    // 注册文件描述符的写事件
-    void register_write(int fd, std::coroutine_handle<> coro) {
-        if (poller_.has(fd)) {
-            poller_.modify(fd, EpollPoller::Write | EpollPoller::EdgeTriggered, coro);
-        } else {
-            poller_.add(fd, EpollPoller::Write | EpollPoller::EdgeTriggered, coro);
+    // 等待 fd 可写（或出错）
+    ReadinessAwaiter wait_writable(int fd) {
+        return ReadinessAwaiter{*this, poller_.watch(fd).writer, "wait_writable"};
+    }
+
+    // 在 fd 可读时恢复 coro（已有缓存的就绪事件时立即调度）
+    void register_read(int fd, std::coroutine_handle<> coro) {
+        IoWaiter& waiter = poller_.watch(fd).reader;
+        if (waiter.consume_ready() || !waiter.park(coro)) {
+            schedule(coro);
         }
     }
 
-    // 同时注册读写事件
-    void register_rw(int fd, std::coroutine_handle<> coro) {
-        uint32_t events = EpollPoller::Read | EpollPoller::Write | EpollPoller::EdgeTriggered;
-        if (poller_.has(fd)) {
-            poller_.modify(fd, events, coro);
-        } else {
-            poller_.add(fd, events, coro);
+    // 在 fd 可写时恢复 coro（已有缓存的就绪事件时立即调度）
+    void register_write(int fd, std::coroutine_handle<> coro) {
+        IoWaiter& waiter = poller_.watch(fd).writer;
+        if (waiter.consume_ready() || !waiter.park(coro)) {
+            schedule(coro);
         }
     }
 
-    // 取消注册
+    // 取消注册（关闭 fd 之前调用，fd 号可能被复用）
     void unregister(int fd) {
         poller_.remove(fd);
     }
 
-    // 添加定时器（返回定时器 ID）
+    // 添加定时器（返回定时器 ID），回调在事件循环线程中执行
     TimerId add_timer(int delay_ms, TimerCallback callback) {
-        auto expire_time = std::chrono::steady_clock::now() + 
-                          std::chrono::milliseconds(delay_ms);
-        
-        std::lock_guard<std::mutex> lock(mutex_);
-        TimerId id = next_timer_id_++;
-        timers_.emplace(expire_time, std::make_pair(id, std::move(callback)));
+        return add_timer(std::chrono::milliseconds(delay_ms), std::move(callback));
+    }
+
+    TimerId add_timer(std::chrono::steady_clock::duration delay, TimerCallback callback) {
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            id = timers_.add(std::chrono::steady_clock::now() + delay, std::move(callback));
+        }
+        if (!is_in_loop_thread()) {
+            wakeup();  // 新定时器可能早于事件循环当前的超时时间
+        }
         return id;
     }
 
-    // 取消定时器
-    void cancel_timer(TimerId id) {
+    // 取消定时器（O(1)），返回 false 表示定时器已触发或已取消
+    bool cancel_timer(TimerId id) {
         std::lock_guard<std::mutex> lock(mutex_);
-        for (auto it = timers_.begin(); it != timers_.end(); ++it) {
-            if (it->second.first == id) {
-                timers_.erase(it);
-                break;
+        return timers_.cancel(id);
+    }
+
+    // =========================================================================
+    // SleepAwaiter - co_await loop.sleep_for(d)：挂起至少 d，在本事件循环中恢复
+    // =========================================================================
+    //
+    // 在事件循环线程中等待时注册取消回调：令牌被请求停止后取消定时器，
+    // 协程提前恢复并抛出 OperationCancelled。
+
+    class SleepAwaiter {
+    public:
+        SleepAwaiter(EventLoop& loop, std::chrono::steady_clock::duration delay) noexcept
+            : loop_(&loop), delay_(delay) {}
+
+        bool await_ready() const noexcept {
+            return delay_ <= std::chrono::steady_clock::duration::zero();
+        }
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> coro) {
+            std::stop_token token = detail::stop_token_of(coro);
+            if (token.stop_requested()) {
+                cancelled_ = true;
+                return false;
+            }
+            EventLoop* loop = loop_;
+            timer_ = loop->add_timer(delay_, [loop, coro] { loop->schedule(coro); });
+            // 定时器只在事件循环线程中触发：在该线程中挂起时，返回之前协程不会被恢复
+            if (token.stop_possible() && loop->is_in_loop_thread()) {
+                coro_ = coro;
+                cancel_.emplace(std::move(token), Canceller{this});
             }
+            return true;
         }
+
+        void await_resume() {
+            cancel_.reset();
+            if (cancelled_) {
+                throw OperationCancelled();
+            }
+        }
+
+    private:
+        struct Canceller {
+            SleepAwaiter* self;
+
+            void operator()() const noexcept {
+                self->cancel();
+            }
+        };
+
+        // 取消回调：定时器还未触发时取消它并恢复协程
+        void cancel() noexcept {
+            if (loop_->cancel_timer(timer_)) {
+                cancelled_ = true;
+                loop_->schedule(coro_);
+            }
+        }
+
+        EventLoop* loop_;
+        std::chrono::steady_clock::duration delay_;
+        TimerId timer_ = TimerWheel::invalid_id;
+        std::coroutine_handle<> coro_ = nullptr;
+        bool cancelled_ = false;
+        std::optional<std::stop_callback<Canceller>> cancel_;
+    };
+
+    SleepAwaiter sleep_for(std::chrono::steady_clock::duration delay) noexcept {
+        return SleepAwaiter{*this, delay};
     }
 
     // 检查是否正在运行
@@ -134,71 +546,106 @@ public:
     }
 
 private:
-    // 处理就绪队列中的协程
+    // 处理就绪队列中的协程（本轮执行期间新调度的协程留到下一轮）
     void process_ready_queue() {
-        std::deque<std::coroutine_handle<>> local_queue;
-        
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            local_queue.swap(ready_queue_);
+        running_batch_.swap(local_ready_);
+
+        while (auto coro = injection_queue_.try_pop()) {
+            running_batch_.push_back(*coro);
+        }
+        if (overflowed_.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            running_batch_.insert(running_batch_.end(),
+                                  overflow_queue_.begin(), overflow_queue_.end());
+            overflowed_.fetch_sub(overflow_queue_.size(), std::memory_order_relaxed);
+            overflow_queue_.clear();
         }
         
-        for (auto coro : local_queue) {
+        ready_queue_depth_.set(running_batch_.size());
+        tasks_run_.add(running_batch_.size());
+        for (auto coro : running_batch_) {
             if (coro && !coro.done()) {
                 coro.resume();
             }
         }
+        running_batch_.clear();  // 保留容量，下一轮复用
     }
 
-    // 处理定时器，返回下次超时时间（毫秒）
+    // 是否还有待执行的协程（事件循环线程调用）
+    bool has_ready_work() const noexcept {
+        return !local_ready_.empty() || !injection_queue_.empty_approx() ||
+               overflowed_.load(std::memory_order_relaxed) != 0;
+    }
+
+    // 被唤醒后清空 eventfd 计数器，再清除唤醒标志：
+    // 标志被清除之前调度的协程，下一轮 process_ready_queue 一定能看到
+    void drain_wakeups() noexcept {
+        if (!wakeup_pending_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        uint64_t count;
+        ssize_t n = ::read(wakeup_fd_, &count, sizeof(count));
+        (void)n;
+        wakeup_pending_.exchange(false, std::memory_order_acq_rel);
+    }
+
+    // 处理定时器，返回下次超时时间（毫秒），没有定时器时返回 -1
     int process_timers() {
-        auto now = std::chrono::steady_clock::now();
         std::vector<TimerCallback> expired_callbacks;
         
+        uint64_t lag_ms;
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            
-            // multimap 按 expire_time 排序，从头开始处理到期的定时器
-            auto it = timers_.begin();
-            while (it != timers_.end() && it->first <= now) {
-                expired_callbacks.push_back(std::move(it->second.second));
-                it = timers_.erase(it);
-            }
+            lag_ms = timers_.advance(std::chrono::steady_clock::now(), expired_callbacks);
+        }
+        if (!expired_callbacks.empty()) {
+            timers_fired_.add(expired_callbacks.size());
+            timer_lag_.record(lag_ms * 1'000'000);
         }
         
-        // 执行到期的定时器
+        // 在锁外执行到期的定时器（回调中可以添加、取消定时器）
         for (auto& callback : expired_callbacks) {
             callback();
         }
         
         // 重新获取当前时间（考虑回调执行耗时）
-        now = std::chrono::steady_clock::now();
-        
-        // 计算下次超时时间
         std::lock_guard<std::mutex> lock(mutex_);
-        if (timers_.empty()) {
-            return 100;  // 默认 100ms
-        }
-        
-        // multimap 按 expire_time 排序，第一个就是最早到期的
-        auto next_expire = timers_.begin()->first;
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            next_expire - now);
-        
-        return std::max(0, static_cast<int>(duration.count()));
+        return timers_.next_timeout(std::chrono::steady_clock::now());
     }
 
 private:
     EpollPoller poller_;                                    // Epoll 轮询器
+    std::vector<std::coroutine_handle<>> io_ready_;         // 本轮 I/O 就绪的协程（复用）
+#if defined(ZLCORO_HAS_IO_URING)
+    std::unique_ptr<IoUringPoller> uring_;                  // io_uring（可选）
+#endif
     std::atomic<bool> running_;                             // 运行标志
-    std::deque<std::coroutine_handle<>> ready_queue_;       // 就绪队列
-    std::mutex mutex_;                                       // 保护共享数据
-    
-    // 定时器：按到期时间排序，value 是 (TimerId, Callback)
-    // 使用 multimap 支持多个定时器同时到期
-    std::multimap<std::chrono::steady_clock::time_point, 
-                  std::pair<TimerId, TimerCallback>> timers_;
-    TimerId next_timer_id_;                                 // 下一个定时器 ID
+
+    // 就绪队列
+    std::vector<std::coroutine_handle<>> local_ready_;      // 事件循环线程调度的协程
+    std::vector<std::coroutine_handle<>> running_batch_;    // 本轮正在执行的协程（复用）
+    BoundedMpmcQueue<std::coroutine_handle<>> injection_queue_{1024};  // 其他线程调度的协程
+    std::deque<std::coroutine_handle<>> overflow_queue_;    // 注入队列满时的溢出队列
+    std::atomic<size_t> overflowed_{0};                     // 溢出队列中的协程数量
+    std::mutex overflow_mutex_;
+
+    std::mutex mutex_;                                       // 保护定时器
+    TimerWheel timers_;                                     // 定时器（分层时间轮）
+    int wakeup_fd_ = -1;                                    // 跨线程唤醒用的 eventfd
+    std::atomic<bool> wakeup_pending_{false};               // 已写 eventfd、尚未被事件循环处理
+
+    // 指标（只由事件循环线程写入）
+    MetricCounter iterations_;
+    MetricCounter polls_;
+    MetricCounter io_events_;
+    MetricCounter tasks_run_;
+    MetricCounter timers_fired_;
+    MetricGauge ready_queue_depth_;
+    MetricHistogram events_per_poll_;
+    MetricHistogram timer_lag_;
+    MetricHistogram loop_latency_;
+
+    static inline thread_local EventLoop* current_loop_ = nullptr;  // 当前线程运行的事件循环
 };
 
 } // namespace zlcoro
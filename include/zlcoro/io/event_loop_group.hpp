@@ -0,0 +1,256 @@
+#pragma once
+
+#include "event_loop.hpp"
+#include "async_socket.hpp"
+#include "zlcoro/core/task.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace zlcoro {
+
+// EventLoopGroup::serve 的选项
+struct ServeOptions {
+    int backlog = 128;          // listen 的积压队列长度
+    bool reuse_port = true;     // 每个事件循环一个 SO_REUSEPORT 监听 socket
+    size_t accept_batch = 64;   // 每次就绪最多接受的连接数
+    // accept 因 fd 或内存耗尽（EMFILE/ENFILE/ENOBUFS/ENOMEM）失败后的退避时间
+    std::chrono::steady_clock::duration accept_retry_delay = std::chrono::milliseconds(10);
+};
+
+// =============================================================================
+// EventLoopGroup - 多 Reactor 事件循环组
+// =============================================================================
+//
+// 管理 N 个 EventLoop，每个拥有独立的 EpollPoller，由独立线程运行，
+// 并可绑定到指定 CPU 核心。
+//
+// 连接分发默认使用 SO_REUSEPORT：serve() 为每个事件循环创建一个监听
+// socket，由内核把新连接分散到各个监听者；每个连接从 accept 到关闭都留在
+// 同一个事件循环中，不跨线程，保持缓存局部性。每次就绪用 accept_many
+// 批量取走积压的连接。
+// ServeOptions::reuse_port 为 false 时只在第 0 个事件循环上监听，新连接按
+// 轮询交给各个事件循环（每个连接一次跨线程调度）。
+//
+// 使用方式:
+//   EventLoopGroup group(4);
+//   group.serve("0.0.0.0", 8080, [](AsyncSocket conn) -> Task<void> {
+//       auto data = co_await conn.read();
+//       co_await conn.write(data);
+//   });
+//   group.start();
+//   ...
+//   group.stop();
+// =============================================================================
+
+class EventLoopGroup {
+public:
+    // 创建 num_loops 个事件循环；pin_threads 为 true 时第 i 个线程绑定到 CPU i
+    explicit EventLoopGroup(size_t num_loops = std::thread::hardware_concurrency(),
+                            bool pin_threads = true)
+        : pin_threads_(pin_threads) {
+        if (num_loops == 0) {
+            num_loops = 1;
+        }
+
+        size_t cpu_count = std::thread::hardware_concurrency();
+        if (cpu_count == 0) {
+            cpu_count = 1;
+        }
+
+        for (size_t i = 0; i < num_loops; ++i) {
+            loops_.push_back(std::make_unique<EventLoop>());
+            cpus_.push_back(static_cast<int>(i % cpu_count));
+        }
+    }
+
+    // 按给定的 CPU 列表创建事件循环：第 i 个事件循环绑定到 cpus[i]
+    explicit EventLoopGroup(std::vector<int> cpus)
+        : cpus_(std::move(cpus)), pin_threads_(true) {
+        if (cpus_.empty()) {
+            throw std::invalid_argument("EventLoopGroup: empty cpu list");
+        }
+        for (size_t i = 0; i < cpus_.size(); ++i) {
+            loops_.push_back(std::make_unique<EventLoop>());
+        }
+    }
+
+    // 禁止拷贝
+    EventLoopGroup(const EventLoopGroup&) = delete;
+    EventLoopGroup& operator=(const EventLoopGroup&) = delete;
+
+    ~EventLoopGroup() {
+        stop();
+    }
+
+    // 启动所有事件循环线程
+    void start() {
+        if (started_) {
+            return;
+        }
+        started_ = true;
+
+        // 在创建线程之前置位，紧随其后的 stop() 不会被线程里的 run() 覆盖
+        for (auto& loop : loops_) {
+            loop->running_ = true;
+        }
+
+        threads_.reserve(loops_.size());
+        for (size_t i = 0; i < loops_.size(); ++i) {
+            threads_.emplace_back([this, i] {
+                if (pin_threads_) {
+                    pin_current_thread(cpus_[i]);
+                }
+                loops_[i]->run_until_stopped();
+            });
+        }
+    }
+
+    // 停止所有事件循环并等待线程退出
+    // 注意：仍挂起在事件循环上的连接协程不会被恢复，应在 stop 之前结束
+    void stop() {
+        for (auto& loop : loops_) {
+            loop->stop();
+        }
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        threads_.clear();
+
+        // 线程已退出，可以安全销毁 serve() 启动的监听协程
+        servers_.clear();
+        started_ = false;
+    }
+
+    // 事件循环数量
+    size_t size() const noexcept {
+        return loops_.size();
+    }
+
+    // 获取第 i 个事件循环
+    EventLoop& loop(size_t index) {
+        return *loops_.at(index);
+    }
+
+    // serve() 的监听协程遇到并已恢复的 accept 错误次数（fd 耗尽、连接中止等）
+    uint64_t accept_errors() const noexcept {
+        return accept_errors_.load(std::memory_order_relaxed);
+    }
+
+    // 轮询选择下一个事件循环
+    EventLoop& next() noexcept {
+        size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+        return *loops_[i % loops_.size()];
+    }
+
+    // 在每个事件循环上启动一个协程
+    // fn 签名: Task<void>(EventLoop& loop, size_t index)
+    template <typename Fn>
+    void run_on_each(Fn&& fn) {
+        for (size_t i = 0; i < loops_.size(); ++i) {
+            loops_[i]->spawn(fn(*loops_[i], i));
+        }
+    }
+
+    // 在每个事件循环上创建一个 SO_REUSEPORT 监听 socket，
+    // 接受的连接交给 handler 在同一个事件循环中处理
+    // handler 签名: Task<void>(AsyncSocket conn)
+    template <typename Handler>
+    void serve(const std::string& host, int port, Handler handler, int backlog = 128) {
+        ServeOptions options;
+        options.backlog = backlog;
+        serve(host, port, std::move(handler), options);
+    }
+
+    template <typename Handler>
+    void serve(const std::string& host, int port, Handler handler, const ServeOptions& options) {
+        const size_t listeners = options.reuse_port ? loops_.size() : 1;
+        for (size_t i = 0; i < listeners; ++i) {
+            EventLoop& loop = *loops_[i];
+            AsyncSocket listener(loop);
+            listener.create();
+            listener.set_reuse_addr(true);
+            if (options.reuse_port) {
+                listener.set_reuse_port(true);
+            }
+            listener.bind(host, port);
+            listener.listen(options.backlog);
+
+            servers_.push_back(accept_loop(std::move(listener), handler, options,
+                                           !options.reuse_port));
+            loop.schedule(servers_.back().handle());
+        }
+    }
+
+private:
+    // distribute 为 false 时连接留在监听 socket 的事件循环中，
+    // 否则按轮询交给各个事件循环（连接还没有注册到 epoll，可以直接转交 fd）
+    // 可恢复的 accept 错误不结束监听：资源耗尽时退避后重试，
+    // 被对端中止的连接直接跳过；其他错误结束协程
+    template <typename Handler>
+    Task<void> accept_loop(AsyncSocket listener, Handler handler, ServeOptions options,
+                           bool distribute) {
+        EventLoop& loop = listener.event_loop();
+        std::vector<AsyncSocket> batch;
+        while (true) {
+            bool back_off = false;
+            try {
+                co_await listener.accept_many(batch, options.accept_batch);
+            } catch (const std::system_error& e) {
+                int err = e.code().value();
+                if (err == EMFILE || err == ENFILE || err == ENOBUFS || err == ENOMEM) {
+                    back_off = true;
+                } else if (err != ECONNABORTED && err != EPROTO) {
+                    throw;
+                }
+                accept_errors_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (back_off) {
+                // catch 块中不能 co_await
+                co_await loop.sleep_for(options.accept_retry_delay);
+                continue;
+            }
+            for (AsyncSocket& conn : batch) {
+                EventLoop& target = distribute ? next() : loop;
+                if (&target == &loop) {
+                    loop.spawn(handler(std::move(conn)));
+                } else {
+                    target.spawn(handler(AsyncSocket(conn.release(), target, AsyncSocket::AdoptTag{})));
+                }
+            }
+            batch.clear();
+        }
+    }
+
+    static void pin_current_thread(int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        // 绑定失败（例如受 cgroup 限制）不影响正确性，忽略
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+private:
+    std::vector<std::unique_ptr<EventLoop>> loops_;  // 事件循环
+    std::vector<int> cpus_;                          // 每个事件循环绑定的 CPU
+    std::vector<std::thread> threads_;               // 运行事件循环的线程
+    std::vector<Task<void>> servers_;                // serve() 启动的监听协程
+    std::atomic<size_t> next_{0};                    // 轮询计数
+    std::atomic<uint64_t> accept_errors_{0};         // 已恢复的 accept 错误
+    bool pin_threads_;
+    bool started_ = false;
+};
+
+} // namespace zlcoro
@@ -0,0 +1,672 @@
+#pragma once
+
+// =============================================================================
+// io_uring 后端（可选）
+// =============================================================================
+//
+// 编译期：存在 <linux/io_uring.h> 且未定义 ZLCORO_DISABLE_IO_URING 时启用，
+//         此时定义 ZLCORO_HAS_IO_URING。
+// 运行期：IoUringPoller 构造时探测内核是否支持所需的操作码，
+//         不支持时抛出异常，EventLoop 捕获后回退到 epoll。
+// =============================================================================
+
+#if !defined(ZLCORO_DISABLE_IO_URING) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    define ZLCORO_HAS_IO_URING 1
+#  endif
+#endif
+
+#if defined(ZLCORO_HAS_IO_URING)
+
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/core/trace.hpp"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// IoUringPoller - io_uring 提交/完成队列封装
+// =============================================================================
+//
+// 与 EpollPoller 的"就绪通知 + 再做一次系统调用"不同，io_uring 直接提交
+// 读、写、accept、connect、fsync 等操作，完成后内核把结果写入完成队列。
+//
+// - 每个操作用一个 Operation 表示（通常位于等待者协程的帧中），
+//   其地址作为 user_data，完成时写入 result 并恢复 coro
+// - 事件循环线程上的提交先积攒在 SQ 中，每轮循环统一提交一次
+// - 其他线程上的提交立即调用 io_uring_enter
+// - 完成队列通过共享内存读取，不需要系统调用
+// - 在事件循环线程上提交的操作会注册等待者的取消令牌：请求停止后提交
+//   IORING_OP_ASYNC_CANCEL，操作以 -ECANCELED 完成
+// - SQ 已满且内核暂时不接收提交（EAGAIN/EBUSY）时请求进入积压队列，
+//   事件循环收割完成队列后补交，提交者不会在锁内忙等
+//
+// 直接使用系统调用，不依赖 liburing。
+// =============================================================================
+
+class IoUringPoller {
+public:
+    // 一个进行中的操作
+    struct Operation {
+        std::coroutine_handle<> coro;  // 完成后要恢复的协程
+        int result = 0;                // CQE 结果（>= 0 成功，< 0 为 -errno）
+        uint32_t flags = 0;            // CQE 标志（例如选中的缓冲区 ID）
+    };
+
+    // 完整的完成结果
+    struct Completion {
+        int result;
+        uint32_t flags;
+    };
+
+    // 一个待提交操作的描述（提交时填入 SQE）
+    // 不直接保存 io_uring_sqe：它含有零长度数组成员，不适合放进协程帧
+    struct Request {
+        uint8_t opcode = IORING_OP_NOP;
+        int fd = -1;
+        uint64_t addr = 0;
+        uint32_t len = 0;
+        uint64_t off = 0;
+        uint32_t op_flags = 0;   // rw_flags / msg_flags / accept_flags / fsync_flags
+        uint8_t sqe_flags = 0;   // IOSQE_*
+        uint16_t buf_group = 0;  // 缓冲区组（IOSQE_BUFFER_SELECT / PROVIDE_BUFFERS）
+        int32_t splice_fd_in = 0;  // SPLICE 的输入 fd（输出 fd 在 fd 中）
+    };
+
+    // 提交一个操作并等待完成的 Awaiter
+    // WithFlags 为 true 时 co_await 结果为 Completion，否则只有 res
+    template <bool WithFlags>
+    struct BasicOpAwaiter {
+        // 取消回调：请求内核取消 op（op 仍会以 -ECANCELED 或实际结果完成）
+        struct Canceller {
+            BasicOpAwaiter* self;
+
+            void operator()() const noexcept {
+                self->ring->enqueue(make_cancel(&self->op), nullptr, true);
+            }
+        };
+
+        IoUringPoller* ring;
+        Request req;
+        bool submit_now;       // 是否立即提交（非事件循环线程）
+        Operation op{};
+        std::optional<std::stop_callback<Canceller>> cancel{};
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> coro) {
+            std::stop_token token = detail::stop_token_of(coro);
+            if (token.stop_requested()) {
+                op.result = -ECANCELED;
+                return false;
+            }
+            op.coro = coro;
+            detail::trace_suspend(coro.address(), "io_uring");
+            ring->enqueue(req, &op, submit_now);
+            // 立即提交时操作可能已经完成并被恢复，不能再访问 this；
+            // 事件循环线程上的操作要到本轮循环收割时才恢复
+            if (!submit_now && token.stop_possible()) {
+                cancel.emplace(std::move(token), Canceller{this});
+            }
+            return true;
+        }
+
+        auto await_resume() noexcept {
+            cancel.reset();  // 等待可能正在其他线程中执行的取消回调结束
+            if (op.coro) {
+                detail::trace_resume(op.coro.address(), "io_uring");
+            }
+            if constexpr (WithFlags) {
+                return Completion{op.result, op.flags};
+            } else {
+                return op.result;
+            }
+        }
+    };
+
+    using OpAwaiter = BasicOpAwaiter<false>;
+    using CompletionAwaiter = BasicOpAwaiter<true>;
+
+    explicit IoUringPoller(unsigned entries = 256) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd_ < 0) {
+            throw std::runtime_error(
+                std::string("io_uring_setup failed: ") + strerror(errno));
+        }
+
+        try {
+            // 在同一个 ring 上探测：单独创建再关闭探测用的 ring 会让内核在
+            // 回收它时向创建线程投递 task_work，打断该线程上带超时的阻塞调用
+            if (!supports_required_ops()) {
+                throw std::runtime_error("io_uring: required opcodes not supported");
+            }
+            map_rings(params);
+        } catch (...) {
+            unmap_rings();
+            ::close(ring_fd_);
+            throw;
+        }
+    }
+
+    // 禁止拷贝
+    IoUringPoller(const IoUringPoller&) = delete;
+    IoUringPoller& operator=(const IoUringPoller&) = delete;
+
+    ~IoUringPoller() {
+        unmap_rings();
+        if (ring_fd_ != -1) {
+            ::close(ring_fd_);
+        }
+    }
+
+    // 获取 io_uring 文件描述符（有完成事件时可读，可注册到 epoll）
+    int fd() const noexcept {
+        return ring_fd_;
+    }
+
+    // =========================================================================
+    // SQE 构造
+    // =========================================================================
+
+    static Request make_read(int fd, void* buf, unsigned len, uint64_t offset) {
+        return make_rw(IORING_OP_READ, fd, buf, len, offset);
+    }
+
+    static Request make_write(int fd, const void* buf, unsigned len, uint64_t offset) {
+        return make_rw(IORING_OP_WRITE, fd, buf, len, offset);
+    }
+
+    static Request make_recv(int fd, void* buf, unsigned len, int flags = 0) {
+        return make_rw(IORING_OP_RECV, fd, buf, len, 0, static_cast<uint32_t>(flags));
+    }
+
+    static Request make_send(int fd, const void* buf, unsigned len, int flags = 0) {
+        return make_rw(IORING_OP_SEND, fd, buf, len, 0, static_cast<uint32_t>(flags));
+    }
+
+    // addr / addrlen 必须在操作完成前保持有效
+    static Request make_accept(int fd, sockaddr* addr, socklen_t* addrlen, int flags = 0) {
+        return make_rw(IORING_OP_ACCEPT, fd, addr, 0,
+                       reinterpret_cast<uint64_t>(addrlen), static_cast<uint32_t>(flags));
+    }
+
+    static Request make_connect(int fd, const sockaddr* addr, socklen_t addrlen) {
+        return make_rw(IORING_OP_CONNECT, fd, addr, 0, addrlen);
+    }
+
+    static Request make_fsync(int fd, bool datasync = false) {
+        return make_rw(IORING_OP_FSYNC, fd, nullptr, 0, 0,
+                       datasync ? IORING_FSYNC_DATASYNC : 0);
+    }
+
+    // msg 及其指向的 iovec 数组必须在操作完成前保持有效
+    static Request make_recvmsg(int fd, msghdr* msg, int flags = 0) {
+        return make_rw(IORING_OP_RECVMSG, fd, msg, 1, 0, static_cast<uint32_t>(flags));
+    }
+
+    static Request make_sendmsg(int fd, const msghdr* msg, int flags = 0) {
+        return make_rw(IORING_OP_SENDMSG, fd, msg, 1, 0, static_cast<uint32_t>(flags));
+    }
+
+    // 从缓冲区组 group 中由内核选择一个缓冲区接收数据（最多 len 字节）
+    static Request make_recv_select(int fd, unsigned len, uint16_t group, int flags = 0) {
+        Request req = make_rw(IORING_OP_RECV, fd, nullptr, len, 0, static_cast<uint32_t>(flags));
+        req.sqe_flags = IOSQE_BUFFER_SELECT;
+        req.buf_group = group;
+        return req;
+    }
+
+    // 把从 addr 开始的 count 个、每个 len 字节的缓冲区提供给缓冲区组 group，
+    // 缓冲区 ID 从 first_id 开始递增
+    static Request make_provide_buffers(void* addr, unsigned len, unsigned count,
+                                        uint16_t group, uint16_t first_id) {
+        Request req = make_rw(IORING_OP_PROVIDE_BUFFERS, static_cast<int>(count),
+                              addr, len, first_id);
+        req.buf_group = group;
+        return req;
+    }
+
+    // 取消 user_data 为 op 的操作（没有等待者：完成结果被忽略）
+    static Request make_cancel(const Operation* op) {
+        return make_rw(IORING_OP_ASYNC_CANCEL, -1, op, 0, 0);
+    }
+
+    // 从 fd_in 的 off_in 处搬运最多 len 字节到 fd_out 的 off_out 处（两端之一必须是管道，
+    // 管道一端的偏移为 -1）
+    static Request make_splice(int fd_in, int64_t off_in, int fd_out, int64_t off_out,
+                               unsigned len, unsigned flags = 0) {
+        Request req = make_rw(IORING_OP_SPLICE, fd_out, nullptr, len,
+                              static_cast<uint64_t>(off_out), flags);
+        req.addr = static_cast<uint64_t>(off_in);  // splice_off_in 与 addr 共用联合体
+        req.splice_fd_in = fd_in;
+        return req;
+    }
+
+    // 从缓冲区组 group 中移除最多 count 个缓冲区
+    static Request make_remove_buffers(unsigned count, uint16_t group) {
+        Request req = make_rw(IORING_OP_REMOVE_BUFFERS, static_cast<int>(count),
+                              nullptr, 0, 0);
+        req.buf_group = group;
+        return req;
+    }
+
+    // =========================================================================
+    // 提交与完成
+    // =========================================================================
+
+    // 把一个操作放入提交队列
+    // submit_now 为 false 时只入队，等待下一次 submit()（批量提交）
+    void enqueue(const Request& req, Operation* op, bool submit_now) {
+        enqueue_raw(req, reinterpret_cast<uint64_t>(op), submit_now);
+    }
+
+    // 提交所有积攒的 SQE，返回提交的数量
+    unsigned submit() {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        return submit_locked();
+    }
+
+    // 完成队列中是否有待处理的 CQE（包括溢出到内核中、尚未刷回 CQ 的）
+    bool has_completions() const noexcept {
+        unsigned head = std::atomic_ref<unsigned>(*cq_head_).load(std::memory_order_relaxed);
+        unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+        return head != tail || cq_overflowed();
+    }
+
+    // 收割所有完成的操作，把要恢复的协程追加到 out（只能由事件循环线程调用）
+    // CQ 满时内核把多出的 CQE 暂存在溢出列表中，只有 io_uring_enter 才会刷回 CQ
+    size_t reap(std::vector<std::coroutine_handle<>>& out) {
+        size_t count = reap_ring(out);
+        while (cq_overflowed() && flush_overflow()) {
+            unsigned head = *cq_head_;
+            count += reap_ring(out);
+            if (*cq_head_ == head) {
+                break;  // 没有刷回新的 CQE，下一轮再试
+            }
+        }
+        return count;
+    }
+
+    // =========================================================================
+    // 缓冲区组（provided buffers）
+    // =========================================================================
+
+    // 分配一个本 ring 上未被占用的缓冲区组 ID，全部占用时抛出异常
+    uint16_t acquire_buffer_group() {
+        std::lock_guard<std::mutex> lock(group_mutex_);
+        for (size_t i = 0; i < live_groups_.size(); ++i) {
+            auto group = static_cast<uint16_t>(next_group_ + i);
+            if (!live_groups_.test(group)) {
+                live_groups_.set(group);
+                next_group_ = static_cast<uint16_t>(group + 1);
+                group_errors_.erase(group);
+                return group;
+            }
+        }
+        throw std::runtime_error("IoUringPoller: all buffer group ids are in use");
+    }
+
+    // 归还缓冲区组 ID（组中的缓冲区应已移除）
+    void release_buffer_group(uint16_t group) {
+        std::lock_guard<std::mutex> lock(group_mutex_);
+        live_groups_.reset(group);
+    }
+
+    // 把缓冲区提供给组 group（参数同 make_provide_buffers）；
+    // 内核拒绝时错误记录在组上，见 buffer_group_error
+    void provide_buffers(void* addr, unsigned len, unsigned count, uint16_t group,
+                         uint16_t first_id, bool submit_now) {
+        enqueue_raw(make_provide_buffers(addr, len, count, group, first_id),
+                    (static_cast<uint64_t>(group) << 1) | provide_tag, submit_now);
+    }
+
+    // 向 group 提供缓冲区最近一次失败的 errno，没有失败时返回 0
+    // 结果在事件循环收割完成队列之后才可见
+    int buffer_group_error(uint16_t group) const {
+        std::lock_guard<std::mutex> lock(group_mutex_);
+        auto it = group_errors_.find(group);
+        return it == group_errors_.end() ? 0 : it->second;
+    }
+
+    // 内核是否支持 opcode（构造时探测；必需的操作码之外的操作使用前应检查）
+    bool supports(uint8_t opcode) const noexcept {
+        return supported_ops_.test(opcode);
+    }
+
+    // 是否有因 SQ 已满而积压、尚未进入 SQ 的请求
+    bool has_backlog() {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        return !backlog_.empty();
+    }
+
+    // 已提交但尚未收割的操作数量
+    size_t in_flight() const noexcept {
+        return in_flight_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static Request make_rw(uint8_t opcode, int fd, const void* addr, unsigned len,
+                           uint64_t offset, uint32_t op_flags = 0) {
+        Request req;
+        req.opcode = opcode;
+        req.fd = fd;
+        req.addr = reinterpret_cast<uint64_t>(addr);
+        req.len = len;
+        req.off = offset;
+        req.op_flags = op_flags;
+        return req;
+    }
+
+    // 填写并发布一个 SQE（user_data 为 Operation 指针或缓冲区组标记）
+    // SQ 已满且内核暂时不接收（EAGAIN/EBUSY，例如 CQ 溢出）时不在锁内忙等：
+    // 请求进入积压队列，由事件循环在收割完成队列后的 submit() 中补交
+    void enqueue_raw(const Request& req, uint64_t user_data, bool submit_now) {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+
+        io_uring_sqe* slot = backlog_.empty() ? next_sqe() : nullptr;
+        if (!slot) {
+            // SQ 已满（或已有积压，保持顺序）：先把积攒的 SQE 提交给内核
+            submit_locked();
+            slot = backlog_.empty() ? next_sqe() : nullptr;
+        }
+        if (!slot) {
+            backlog_.push_back(Pending{req, user_data});
+            return;
+        }
+
+        fill_sqe(slot, req, user_data);
+        if (submit_now) {
+            submit_locked();
+        }
+    }
+
+    void fill_sqe(io_uring_sqe* slot, const Request& req, uint64_t user_data) noexcept {
+        std::memset(slot, 0, sizeof(*slot));
+        slot->opcode = req.opcode;
+        slot->fd = req.fd;
+        slot->addr = req.addr;
+        slot->len = req.len;
+        slot->off = req.off;
+        slot->rw_flags = static_cast<__kernel_rwf_t>(req.op_flags);  // 与其他 *_flags 共用联合体
+        slot->flags = req.sqe_flags;
+        slot->buf_group = req.buf_group;
+        slot->splice_fd_in = req.splice_fd_in;
+        slot->user_data = user_data;
+        commit_sqe();
+    }
+
+    // 收割 CQ 中已有的 CQE
+    size_t reap_ring(std::vector<std::coroutine_handle<>>& out) {
+        std::atomic_ref<unsigned> head_ref(*cq_head_);
+        unsigned head = head_ref.load(std::memory_order_relaxed);
+        unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+
+        size_t count = 0;
+        size_t completed = 0;
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            if (cqe.user_data & provide_tag) {
+                // 提供缓冲区没有等待者，失败时记录在缓冲区组上
+                if (cqe.res < 0) {
+                    record_group_error(static_cast<uint16_t>(cqe.user_data >> 1), -cqe.res);
+                }
+            } else if (auto* op = reinterpret_cast<Operation*>(cqe.user_data)) {
+                // user_data 为空的操作（例如移除缓冲区、取消）没有等待者
+                op->result = cqe.res;
+                op->flags = cqe.flags;
+                out.push_back(op->coro);
+                ++count;
+            }
+            ++head;
+            ++completed;
+        }
+
+        head_ref.store(head, std::memory_order_release);
+        in_flight_.fetch_sub(completed, std::memory_order_relaxed);
+        return count;
+    }
+
+    bool cq_overflowed() const noexcept {
+        return std::atomic_ref<unsigned>(*sq_flags_).load(std::memory_order_acquire) &
+               IORING_SQ_CQ_OVERFLOW;
+    }
+
+    // 让内核把溢出列表中的 CQE 刷回 CQ（不等待新的完成）
+    bool flush_overflow() noexcept {
+        while (true) {
+            int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, 0, 0,
+                                               IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (ret >= 0) {
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    void record_group_error(uint16_t group, int err) {
+        std::lock_guard<std::mutex> lock(group_mutex_);
+        group_errors_[group] = err;
+    }
+
+    bool supports_required_ops() {
+        constexpr unsigned max_ops = 256;
+        std::vector<unsigned char> buffer(
+            sizeof(io_uring_probe) + max_ops * sizeof(io_uring_probe_op), 0);
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+
+        bool ok = syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE,
+                          probe, max_ops) == 0;
+        if (ok) {
+            for (unsigned op = 0; op <= probe->last_op && op < max_ops; ++op) {
+                supported_ops_.set(op, probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+            }
+            for (int op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_RECV,
+                           IORING_OP_SEND, IORING_OP_ACCEPT, IORING_OP_CONNECT,
+                           IORING_OP_FSYNC, IORING_OP_RECVMSG, IORING_OP_SENDMSG,
+                           IORING_OP_PROVIDE_BUFFERS, IORING_OP_REMOVE_BUFFERS,
+                           IORING_OP_ASYNC_CANCEL}) {
+                if (op > probe->last_op ||
+                    !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+
+        return ok;
+    }
+
+    void map_rings(const io_uring_params& params) {
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = mmap_or_throw(sq_ring_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_ : mmap_or_throw(cq_ring_size_, IORING_OFF_CQ_RING);
+
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mmap_or_throw(sqes_size_, IORING_OFF_SQES));
+
+        auto* sq = static_cast<unsigned char*>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_entries_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_flags_ = reinterpret_cast<unsigned*>(sq + params.sq_off.flags);
+
+        auto* cq = static_cast<unsigned char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        sq_local_tail_ = *sq_tail_;
+    }
+
+    void* mmap_or_throw(size_t size, off_t offset) {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error(
+                std::string("io_uring mmap failed: ") + strerror(errno));
+        }
+        return ptr;
+    }
+
+    void unmap_rings() noexcept {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+            sqes_ = nullptr;
+        }
+        if (cq_ring_ && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        cq_ring_ = nullptr;
+        if (sq_ring_) {
+            ::munmap(sq_ring_, sq_ring_size_);
+            sq_ring_ = nullptr;
+        }
+    }
+
+    // 取一个空闲 SQE（调用者持有 submit_mutex_），SQ 满时返回 nullptr
+    io_uring_sqe* next_sqe() noexcept {
+        unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+        if (sq_local_tail_ - head >= sq_entries_) {
+            return nullptr;
+        }
+        return &sqes_[sq_local_tail_ & sq_mask_];
+    }
+
+    // 发布刚填好的 SQE（调用者持有 submit_mutex_）
+    void commit_sqe() noexcept {
+        unsigned index = sq_local_tail_ & sq_mask_;
+        sq_array_[index] = index;
+        ++sq_local_tail_;
+        std::atomic_ref<unsigned>(*sq_tail_).store(sq_local_tail_, std::memory_order_release);
+        ++to_submit_;
+    }
+
+    // 提交 SQ 中的 SQE，再把积压的请求填入腾出的槽位并提交
+    unsigned submit_locked() {
+        unsigned submitted = enter_locked();
+        bool refilled = false;
+        while (!backlog_.empty()) {
+            io_uring_sqe* slot = next_sqe();
+            if (!slot) {
+                break;
+            }
+            fill_sqe(slot, backlog_.front().req, backlog_.front().user_data);
+            backlog_.pop_front();
+            refilled = true;
+        }
+        if (refilled) {
+            submitted += enter_locked();
+        }
+        return submitted;
+    }
+
+    unsigned enter_locked() {
+        unsigned submitted = 0;
+        while (to_submit_ > 0) {
+            int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_,
+                                               to_submit_, 0, 0, nullptr, 0));
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EBUSY) {
+                    break;  // 内核暂时无法接收，下一轮再提交
+                }
+                throw std::runtime_error(
+                    std::string("io_uring_enter failed: ") + strerror(errno));
+            }
+            to_submit_ -= static_cast<unsigned>(ret);
+            submitted += static_cast<unsigned>(ret);
+        }
+        return submitted;
+    }
+
+private:
+    int ring_fd_ = -1;
+
+    // 映射的内存区域
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    size_t sqes_size_ = 0;
+
+    // 提交队列
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned* sq_flags_ = nullptr;    // IORING_SQ_CQ_OVERFLOW 等标志
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sq_local_tail_ = 0;
+    unsigned to_submit_ = 0;          // 已入队但尚未提交给内核的 SQE 数量
+    std::mutex submit_mutex_;         // 保护提交队列和积压队列
+
+    // SQ 已满时积压的请求
+    struct Pending {
+        Request req;
+        uint64_t user_data;
+    };
+    std::deque<Pending> backlog_;
+
+    // 完成队列
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::atomic<size_t> in_flight_{0};
+    std::bitset<256> supported_ops_;  // 探测到的内核支持的操作码
+
+    // 缓冲区组：Operation 指针至少按 4 字节对齐，最低位置 1 的 user_data
+    // 表示提供缓冲区的操作，高位是组 ID
+    static constexpr uint64_t provide_tag = 1;
+    mutable std::mutex group_mutex_;
+    std::bitset<UINT16_MAX + 1> live_groups_;         // 已分配的组 ID
+    uint16_t next_group_ = 0;                         // 下一次分配从这里开始查找
+    std::unordered_map<uint16_t, int> group_errors_;  // 提供缓冲区失败的组 -> errno
+};
+
+} // namespace zlcoro
+
+#endif // ZLCORO_HAS_IO_URING
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "event_loop.hpp"
+#include "zlcoro/core/cancellation.hpp"
+#include "zlcoro/core/detached_task.hpp"
+#include "zlcoro/core/task.hpp"
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace zlcoro {
+
+// =============================================================================
+// 基于 EventLoop 定时器的等待与超时
+// =============================================================================
+//
+// 使用方式:
+//   co_await sleep_for(std::chrono::milliseconds(10));
+//
+//   try {
+//       auto data = co_await with_timeout(conn.read(), std::chrono::seconds(5));
+//   } catch (const TimeoutError&) {
+//       // 超时
+//   }
+//
+// 两者都使用当前线程正在运行的事件循环（没有则使用全局实例，
+// 此时必须有线程在运行它），并在该事件循环中恢复。
+//
+// with_timeout 给 task 一个新的取消令牌：超时或父协程被取消时请求停止，
+// task 中正在等待的 I/O、定时器以 OperationCancelled 结束。
+// =============================================================================
+
+// 挂起当前协程至少 delay
+inline EventLoop::SleepAwaiter sleep_for(std::chrono::steady_clock::duration delay) noexcept {
+    return EventLoop::current_or_default().sleep_for(delay);
+}
+
+// with_timeout 超时时抛出
+class TimeoutError : public std::runtime_error {
+public:
+    TimeoutError() : std::runtime_error("operation timed out") {}
+};
+
+namespace detail {
+
+// 把一个令牌的停止请求转发给 stop_source（合并父协程与超时的取消）
+struct StopForwarder {
+    std::stop_source* source;
+
+    void operator()() const noexcept {
+        source->request_stop();
+    }
+};
+
+// with_timeout 的共享状态：任务和定时器谁先完成，谁恢复等待者
+template <typename T>
+struct TimeoutState {
+    using storage_type = std::conditional_t<
+        std::is_void_v<T>, std::monostate,
+        std::conditional_t<std::is_reference_v<T>, std::remove_reference_t<T>*, T>>;
+
+    EventLoop* loop = nullptr;
+    std::coroutine_handle<> waiter;
+    EventLoop::TimerId timer = TimerWheel::invalid_id;
+    std::atomic<bool> done{false};
+    bool timed_out = false;
+    std::optional<storage_type> value;
+    std::exception_ptr error;
+    std::stop_source stop;                                  // task 的取消令牌来源
+    std::optional<std::stop_callback<StopForwarder>> forward;  // 父协程的取消
+
+    void complete(bool by_timer) {
+        if (done.exchange(true, std::memory_order_acq_rel)) {
+            return;  // 另一方已经恢复了等待者
+        }
+        timed_out = by_timer;
+        if (by_timer) {
+            stop.request_stop();  // 取消 task 中正在等待的操作
+        } else {
+            loop->cancel_timer(timer);
+        }
+        loop->schedule(waiter);
+    }
+};
+
+// 执行任务并把结果写入共享状态；超时后任务被取消，结果被丢弃
+template <typename T>
+DetachedTask run_with_timeout(Task<T> task, std::shared_ptr<TimeoutState<T>> state) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            state->value.emplace();
+        } else if constexpr (std::is_reference_v<T>) {
+            state->value.emplace(std::addressof(co_await task));
+        } else {
+            state->value.emplace(co_await task);
+        }
+    } catch (...) {
+        state->error = std::current_exception();
+    }
+    state->complete(false);
+}
+
+template <typename T>
+class TimeoutAwaiter {
+public:
+    TimeoutAwaiter(std::shared_ptr<TimeoutState<T>> state, Task<T> task,
+                   std::chrono::steady_clock::duration timeout)
+        : state_(std::move(state)), task_(std::move(task)), timeout_(timeout) {}
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> coro) {
+        // 不在事件循环线程上时，定时器可能在 add_timer 返回之前就触发并恢复
+        // 等待者，等待者随即销毁本 Awaiter 所在的帧：先把成员移到局部变量，
+        // 之后不再访问 this
+        auto state = std::move(state_);
+        auto task = std::move(task_);
+        EventLoop* loop = state->loop;
+        state->waiter = coro;
+        state->timer = loop->add_timer(timeout_, [state] { state->complete(true); });
+        loop->schedule(run_with_timeout(std::move(task), std::move(state)).handle());
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    std::shared_ptr<TimeoutState<T>> state_;
+    Task<T> task_;
+    std::chrono::steady_clock::duration timeout_;
+};
+
+} // namespace detail
+
+// 等待 task，最多 timeout；超时抛出 TimeoutError
+// 超时会通过取消令牌取消 task，它在事件循环中结束（不等待它）
+template <typename T>
+Task<T> with_timeout(Task<T> task, std::chrono::steady_clock::duration timeout) {
+    auto state = std::make_shared<detail::TimeoutState<T>>();
+    state->loop = &EventLoop::current_or_default();
+
+    std::stop_token parent = co_await get_stop_token();
+    if (parent.stop_possible()) {
+        state->forward.emplace(std::move(parent), detail::StopForwarder{&state->stop});
+    }
+    task.set_stop_token(state->stop.get_token());
+    co_await detail::TimeoutAwaiter<T>(state, std::move(task), timeout);
+    state->forward.reset();
+
+    if (state->timed_out) {
+        throw TimeoutError();
+    }
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+    if constexpr (std::is_reference_v<T>) {
+        co_return **state->value;
+    } else if constexpr (!std::is_void_v<T>) {
+        co_return std::move(*state->value);
+    }
+}
+
+} // namespace zlcoro
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// TimerWheel - 分层时间轮
+// =============================================================================
+//
+// 1ms 精度的分层哈希时间轮（levels 层，每层 64 个槽）：
+// - 第 L 层的一个槽覆盖 64^L 毫秒，4 层共约 4.6 小时，更远的定时器放在
+//   最高层，降级时重新计算
+// - 每个槽是一个侵入式双向链表，添加、取消都是 O(1)
+// - 时间推进到第 L 层的槽边界时，该槽的定时器降级到更低的层（cascade）
+// - 每层一个 64 位占用位图，计算下次超时只需要 levels 次 countr_zero
+//
+// 定时器节点存放在 slab 中，TimerId 由槽位下标和代数组成，
+// 节点复用后旧的 TimerId 自动失效。
+//
+// 注意：TimerWheel 不是线程安全的，由 EventLoop 加锁保护。
+// =============================================================================
+
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId invalid_id = 0;
+
+    explicit TimerWheel(Clock::time_point start = Clock::now()) : start_(start) {
+        for (auto& level : slots_) {
+            level.fill(npos);
+        }
+    }
+
+    // 添加定时器：在 expire 之后（不早于）触发
+    TimerId add(Clock::time_point expire, Callback callback) {
+        uint32_t index = allocate();
+        Node& node = nodes_[index];
+        node.callback = std::move(callback);
+        // 向上取整到毫秒，保证不会提前触发；已经过期的在下一个 tick 触发
+        node.expire = std::max(to_tick_ceil(expire), now_tick_ + 1);
+        node.active = true;
+        link(index);
+        ++size_;
+        return make_id(index, node.generation);
+    }
+
+    // 取消定时器，返回 false 表示定时器不存在（已触发或已取消）
+    bool cancel(TimerId id) noexcept {
+        uint32_t index = static_cast<uint32_t>(id & 0xffffffffu) - 1;
+        if (id == invalid_id || index >= nodes_.size()) {
+            return false;
+        }
+        Node& node = nodes_[index];
+        if (!node.active || node.generation != static_cast<uint32_t>(id >> 32)) {
+            return false;
+        }
+        unlink(index);
+        node.callback = nullptr;
+        release(index);
+        --size_;
+        return true;
+    }
+
+    // 推进到 now，把到期定时器的回调追加到 expired（由调用者在锁外执行）
+    // 返回本次到期的定时器中最大的延迟（now 与到期时间之差，毫秒）
+    uint64_t advance(Clock::time_point now, std::vector<Callback>& expired) {
+        uint64_t target = to_tick_floor(now);
+        uint64_t max_lag = 0;
+        if (size_ == 0) {
+            now_tick_ = std::max(now_tick_, target);
+            return max_lag;
+        }
+
+        while (now_tick_ < target && size_ > 0) {
+            // 跳过中间没有任何槽需要处理的 tick
+            now_tick_ = std::min(target, next_tick());
+
+            // 到达高层槽边界：把该槽降级到低层
+            for (size_t level = 1; level < levels; ++level) {
+                if ((now_tick_ & ((uint64_t{1} << (level * slot_bits)) - 1)) != 0) {
+                    break;
+                }
+                cascade(level, slot_index(now_tick_, level));
+            }
+
+            // 第 0 层当前槽中的定时器全部到期
+            size_t slot = slot_index(now_tick_, 0);
+            uint32_t index = slots_[0][slot];
+            while (index != npos) {
+                uint32_t next = nodes_[index].next;
+                unlink(index);
+                max_lag = std::max(max_lag, target - nodes_[index].expire);
+                expired.push_back(std::move(nodes_[index].callback));
+                nodes_[index].callback = nullptr;
+                release(index);
+                --size_;
+                index = next;
+            }
+        }
+        now_tick_ = std::max(now_tick_, target);
+        return max_lag;
+    }
+
+    // 距下次需要 advance 的时间（毫秒）；没有定时器时返回 -1
+    // 可能早于最近定时器的到期时间（高层槽降级时），但不会晚于它
+    int next_timeout(Clock::time_point now) const noexcept {
+        if (size_ == 0) {
+            return -1;
+        }
+
+        auto deadline = start_ + std::chrono::milliseconds(next_tick());
+        if (deadline <= now) {
+            return 0;
+        }
+        auto ms = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+        return static_cast<int>(std::min<int64_t>(ms, std::numeric_limits<int>::max()));
+    }
+
+    // 等待中的定时器数量
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+private:
+    static constexpr size_t levels = 4;
+    static constexpr size_t slot_bits = 6;
+    static constexpr size_t slots_per_level = size_t{1} << slot_bits;   // 64
+    static constexpr uint64_t slot_mask = slots_per_level - 1;
+    static constexpr uint64_t max_delta = (uint64_t{1} << (levels * slot_bits)) - 1;
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        Callback callback;
+        uint64_t expire = 0;           // 到期 tick
+        uint32_t prev = npos;          // 槽内链表
+        uint32_t next = npos;
+        uint32_t generation = 1;       // 复用代数（TimerId 高 32 位）
+        uint8_t level = 0;             // 所在的层和槽
+        uint8_t slot = 0;
+        bool active = false;
+    };
+
+    static TimerId make_id(uint32_t index, uint32_t generation) noexcept {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(index) + 1);
+    }
+
+    static size_t slot_index(uint64_t tick, size_t level) noexcept {
+        return static_cast<size_t>((tick >> (level * slot_bits)) & slot_mask);
+    }
+
+    // 下一个需要处理的 tick：第 0 层的到期 tick 或高层槽的降级 tick
+    uint64_t next_tick() const noexcept {
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+        for (size_t level = 0; level < levels; ++level) {
+            if (occupied_[level] == 0) {
+                continue;
+            }
+            // 从当前槽的下一个槽开始，第一个非空槽在 k 个槽之后（1..64）
+            uint64_t shift = level * slot_bits;
+            uint64_t current = now_tick_ >> shift;
+            auto start = static_cast<int>((current + 1) & slot_mask);
+            int k = std::countr_zero(std::rotr(occupied_[level], start)) + 1;
+            next = std::min(next, (current + static_cast<uint64_t>(k)) << shift);
+        }
+        return next;
+    }
+
+    uint64_t to_tick_floor(Clock::time_point t) const noexcept {
+        if (t <= start_) {
+            return 0;
+        }
+        return static_cast<uint64_t>(
+            std::chrono::floor<std::chrono::milliseconds>(t - start_).count());
+    }
+
+    uint64_t to_tick_ceil(Clock::time_point t) const noexcept {
+        if (t <= start_) {
+            return 0;
+        }
+        return static_cast<uint64_t>(
+            std::chrono::ceil<std::chrono::milliseconds>(t - start_).count());
+    }
+
+    uint32_t allocate() {
+        if (free_ != npos) {
+            uint32_t index = free_;
+            free_ = nodes_[index].next;
+            return index;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void release(uint32_t index) noexcept {
+        Node& node = nodes_[index];
+        node.active = false;
+        ++node.generation;
+        if (node.generation == 0) {
+            node.generation = 1;
+        }
+        node.prev = npos;
+        node.next = free_;
+        free_ = index;
+    }
+
+    // 按剩余时间放入对应的层（expire >= now_tick_）
+    void link(uint32_t index) noexcept {
+        Node& node = nodes_[index];
+        uint64_t delta = node.expire - now_tick_;
+        uint64_t expire = node.expire;
+        if (delta > max_delta) {
+            expire = now_tick_ + max_delta;  // 超出范围：先放在最高层，降级时重新计算
+            delta = max_delta;
+        }
+
+        size_t level = 0;
+        while (level + 1 < levels && delta >= (uint64_t{1} << ((level + 1) * slot_bits))) {
+            ++level;
+        }
+        size_t slot = slot_index(expire, level);
+
+        node.level = static_cast<uint8_t>(level);
+        node.slot = static_cast<uint8_t>(slot);
+        node.prev = npos;
+        node.next = slots_[level][slot];
+        if (node.next != npos) {
+            nodes_[node.next].prev = index;
+        }
+        slots_[level][slot] = index;
+        occupied_[level] |= uint64_t{1} << slot;
+    }
+
+    void unlink(uint32_t index) noexcept {
+        Node& node = nodes_[index];
+        if (node.prev != npos) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            slots_[node.level][node.slot] = node.next;
+            if (node.next == npos) {
+                occupied_[node.level] &= ~(uint64_t{1} << node.slot);
+            }
+        }
+        if (node.next != npos) {
+            nodes_[node.next].prev = node.prev;
+        }
+        node.prev = npos;
+        node.next = npos;
+    }
+
+    // 把 level 层的一个槽重新放入（更低的）层
+    void cascade(size_t level, size_t slot) noexcept {
+        uint32_t index = slots_[level][slot];
+        slots_[level][slot] = npos;
+        occupied_[level] &= ~(uint64_t{1} << slot);
+        while (index != npos) {
+            uint32_t next = nodes_[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+private:
+    Clock::time_point start_;                                          // tick 0 的时间
+    uint64_t now_tick_ = 0;                                            // 已经处理到的 tick
+    std::array<std::array<uint32_t, slots_per_level>, levels> slots_;  // 槽链表头
+    std::array<uint64_t, levels> occupied_{};                          // 非空槽位图
+    std::vector<Node> nodes_;                                          // 定时器节点 slab
+    uint32_t free_ = npos;                                             // 空闲节点链表
+    size_t size_ = 0;
+};
+
+} // namespace zlcoro
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "zlcoro/core/detached_task.hpp"
 #include "zlcoro/core/task.hpp"
 #include "zlcoro/scheduler/scheduler.hpp"
-#include <future>
+#include <atomic>
+#include <coroutine>
+#include <exception>
 #include <memory>
-#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 namespace zlcoro {
 
@@ -12,61 +17,262 @@ namespace zlcoro {
 // async_run - 异步执行协程
 // =============================================================================
 // 
-// 将协程提交到调度器，返回 std::future 用于等待结果
+// 将协程提交到调度器，返回 JoinHandle 用于等待结果
 // 
 // 使用示例:
 //   Task<int> compute() {
 //       co_return 42;
 //   }
 //
-//   auto future = async_run(compute());
-//   int result = future.get();  // 阻塞等待结果
+//   auto handle = async_run(compute());
+//   int result = handle.get();  // 阻塞等待结果
+//
+// 除 task 自身的帧外只分配一个驱动协程帧（从 FramePool 分配），结果和
+// 完成状态都保存在驱动协程的 promise 中，不需要 shared_ptr 或 future。
+// 帧由 JoinHandle 和驱动协程各持有一个引用，后释放的一方销毁帧：
+// 驱动协程在发布完成状态并唤醒等待者之后才释放引用，所以等待者取走结果
+// 并析构 JoinHandle 时不会销毁一个仍要被 notify 的帧；JoinHandle 析构时
+// 如果 task 还没完成，驱动协程结束后自行销毁。
 // =============================================================================
 
 template <typename T>
-std::future<T> async_run(Task<T> task) {
-    // 使用 shared_ptr 包装状态
-    struct State {
-        Task<T> task;
-        std::promise<T> promise;
-        std::atomic<bool> executed{false};
-        
-        explicit State(Task<T>&& t) : task(std::move(t)) {}
+class JoinHandle;
+
+namespace detail {
+
+// 驱动协程的 promise：保存结果和完成状态
+template <typename T>
+class JoinPromiseBase : public FrameAllocated {
+public:
+    // 完成状态
+    enum State : int {
+        Running = 0,   // 正在执行
+        Done = 1       // 结果已写入
     };
-    
-    auto state = std::make_shared<State>(std::move(task));
-    auto future = state->promise.get_future();
-    
-    // 创建runner - 使用lambda按值捕获shared_ptr
-    auto runner = [state]() {
-        // 确保只执行一次，额外的保护机制
-        bool expected = false;
-        if (!state->executed.compare_exchange_strong(expected, true)) {
-            return;  // 已经被执行过了
-        }
-        
-        try {
-            // 使用 sync_wait 执行协程
-            if constexpr (std::is_void_v<T>) {
-                state->task.sync_wait();
-                state->promise.set_value();
-            } else {
-                T result = state->task.sync_wait();
-                state->promise.set_value(std::move(result));
-            }
-        } catch (...) {
-            try {
-                state->promise.set_exception(std::current_exception());
-            } catch (...) {
-                // 忽略
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> coro) noexcept {
+            auto& promise = coro.promise();
+            promise.state_.store(Done, std::memory_order_release);
+            promise.state_.notify_all();
+            // 唤醒之后才释放引用：在此之前等待者即使已经取走结果也不会销毁帧
+            if (promise.release()) {
+                coro.destroy();  // JoinHandle 已放弃结果
             }
         }
+
+        void await_resume() noexcept {}
     };
-    
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        exception_ = std::current_exception();
+    }
+
+    void wait() const noexcept {
+        int state = state_.load(std::memory_order_acquire);
+        while (state == Running) {
+            state_.wait(state, std::memory_order_acquire);
+            state = state_.load(std::memory_order_acquire);
+        }
+    }
+
+    bool is_ready() const noexcept {
+        return state_.load(std::memory_order_acquire) == Done;
+    }
+
+    // 释放一个引用（JoinHandle 或驱动协程）；返回 true 表示调用者负责销毁帧
+    bool release() noexcept {
+        return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+protected:
+    void rethrow_if_failed() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    std::atomic<int> state_{Running};
+    std::atomic<int> refs_{2};   // JoinHandle + 驱动协程
+    std::exception_ptr exception_;
+};
+
+template <typename T>
+class JoinPromise : public JoinPromiseBase<T> {
+public:
+    JoinHandle<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T result() {
+        this->rethrow_if_failed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <typename T>
+class JoinPromise<T&> : public JoinPromiseBase<T&> {
+public:
+    JoinHandle<T&> get_return_object() noexcept;
+
+    void return_value(T& value) noexcept {
+        value_ = std::addressof(value);
+    }
+
+    T& result() {
+        this->rethrow_if_failed();
+        return *value_;
+    }
+
+private:
+    T* value_ = nullptr;
+};
+
+template <>
+class JoinPromise<void> : public JoinPromiseBase<void> {
+public:
+    JoinHandle<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void result() {
+        rethrow_if_failed();
+    }
+};
+
+// 在调度器上驱动 task，结果写入驱动协程的 promise
+// 以协程方式 co_await，task 挂起时不会阻塞工作线程
+template <typename T>
+JoinHandle<T> run_to_completion(Task<T> task);
+
+} // namespace detail
+
+// =============================================================================
+// JoinHandle<T> - async_run 的结果句柄（只能移动）
+// =============================================================================
+
+template <typename T>
+class JoinHandle {
+public:
+    using promise_type = detail::JoinPromise<T>;
+
+    JoinHandle() noexcept = default;
+
+    explicit JoinHandle(std::coroutine_handle<promise_type> coro) noexcept
+        : coro_(coro) {}
+
+    JoinHandle(const JoinHandle&) = delete;
+    JoinHandle& operator=(const JoinHandle&) = delete;
+
+    JoinHandle(JoinHandle&& other) noexcept
+        : coro_(std::exchange(other.coro_, {})) {}
+
+    JoinHandle& operator=(JoinHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            coro_ = std::exchange(other.coro_, {});
+        }
+        return *this;
+    }
+
+    ~JoinHandle() {
+        reset();
+    }
+
+    bool valid() const noexcept {
+        return coro_ != nullptr;
+    }
+
+    // 任务是否已完成（不阻塞）
+    bool is_ready() const noexcept {
+        return coro_ && coro_.promise().is_ready();
+    }
+
+    // 阻塞等待任务完成
+    void wait() const noexcept {
+        coro_.promise().wait();
+    }
+
+    // 阻塞等待并返回结果（异常会被重新抛出），只能调用一次
+    decltype(auto) get() {
+        wait();
+        if constexpr (std::is_void_v<T>) {
+            coro_.promise().result();
+            return;
+        } else {
+            return coro_.promise().result();
+        }
+    }
+
+    // 底层句柄：用于提交到执行器
+    std::coroutine_handle<> handle() const noexcept {
+        return coro_;
+    }
+
+private:
+    void reset() noexcept {
+        if (coro_) {
+            auto coro = std::exchange(coro_, {});
+            if (coro.promise().release()) {
+                coro.destroy();  // 驱动协程已结束并释放了引用
+            }
+        }
+    }
+
+    std::coroutine_handle<promise_type> coro_;
+};
+
+namespace detail {
+
+template <typename T>
+JoinHandle<T> JoinPromise<T>::get_return_object() noexcept {
+    return JoinHandle<T>{std::coroutine_handle<JoinPromise>::from_promise(*this)};
+}
+
+template <typename T>
+JoinHandle<T&> JoinPromise<T&>::get_return_object() noexcept {
+    return JoinHandle<T&>{std::coroutine_handle<JoinPromise>::from_promise(*this)};
+}
+
+inline JoinHandle<void> JoinPromise<void>::get_return_object() noexcept {
+    return JoinHandle<void>{std::coroutine_handle<JoinPromise>::from_promise(*this)};
+}
+
+template <typename T>
+JoinHandle<T> run_to_completion(Task<T> task) {
+    co_return co_await task;
+}
+
+inline JoinHandle<void> run_to_completion(Task<void> task) {
+    co_await task;
+}
+
+} // namespace detail
+
+template <typename T>
+JoinHandle<T> async_run(Task<T> task) {
+    auto handle = detail::run_to_completion(std::move(task));
     // 提交到调度器
-    Scheduler::instance().schedule(std::move(runner));
-    
-    return future;
+    Scheduler::instance().schedule(handle.handle());
+    return handle;
 }
 
 // =============================================================================
@@ -85,21 +291,9 @@ std::future<T> async_run(Task<T> task) {
 // =============================================================================
 
 inline void fire_and_forget(Task<void> task) {
-    // 使用 shared_ptr 管理 Task 的生命周期
-    auto task_ptr = std::make_shared<Task<void>>(std::move(task));
-    
-    std::function<void()> runner = [task_ptr]() {
-        try {
-            auto handle = task_ptr->handle();
-            while (!handle.done()) {
-                handle.resume();
-            }
-        } catch (...) {
-            // 忽略异常
-        }
-    };
-    
-    Scheduler::instance().schedule(std::move(runner));
+    // 协程结束后自动销毁（连同 task 的帧），未捕获的异常被忽略
+    auto detached = detail::make_detached(std::move(task));
+    Scheduler::instance().schedule(detached.handle());
 }
 
 } // namespace zlcoro
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "scheduler.hpp"
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// BlockingPool - 阻塞操作专用线程池
+// =============================================================================
+//
+// 用于执行会阻塞线程的操作（磁盘 I/O、fsync、DNS 等），避免阻塞
+// 调度器的工作线程或事件循环线程，作用类似 Tokio 的 spawn_blocking。
+// - 线程按需创建：没有空闲线程时新建，直到 max_threads 上限
+// - 达到上限后任务排队，等待已有线程空闲
+// - 线程创建后常驻，直到线程池析构
+// - shutdown() 之后提交的任务被拒绝：submit 返回 false，
+//   spawn_blocking 的 co_await 抛出 std::runtime_error
+//
+// 使用方式:
+//   Task<void> work() {
+//       ssize_t n = co_await spawn_blocking([&] { return ::pread(fd, buf, len, 0); });
+//       // 恢复后回到调度器线程池
+//   }
+// =============================================================================
+
+class BlockingPool {
+public:
+    static constexpr size_t default_max_threads = 64;
+
+    explicit BlockingPool(size_t max_threads = default_max_threads)
+        : max_threads_(max_threads == 0 ? 1 : max_threads) {}
+
+    // 禁止拷贝
+    BlockingPool(const BlockingPool&) = delete;
+    BlockingPool& operator=(const BlockingPool&) = delete;
+
+    ~BlockingPool() {
+        shutdown();
+    }
+
+    // 获取全局阻塞线程池实例
+    static BlockingPool& instance() {
+        static BlockingPool pool;
+        return pool;
+    }
+
+    // 提交一个阻塞任务；线程池已停止时不执行 job 并返回 false
+    bool submit(std::function<void()> job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stop_) {
+            return false;
+        }
+
+        jobs_.push_back(std::move(job));
+
+        // 排队的任务多于空闲线程时扩容
+        if (jobs_.size() > idle_ && threads_.size() < max_threads_) {
+            threads_.emplace_back([this] { worker_thread(); });
+        } else {
+            cv_.notify_one();
+        }
+        return true;
+    }
+
+    // 停止线程池：执行完已排队的任务后退出
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_) {
+                return;
+            }
+            stop_ = true;
+        }
+        cv_.notify_all();
+
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    // 已创建的线程数量
+    size_t thread_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threads_.size();
+    }
+
+    size_t max_threads() const noexcept {
+        return max_threads_;
+    }
+
+private:
+    void worker_thread() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ++idle_;
+                cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+                --idle_;
+
+                if (jobs_.empty()) {
+                    return;  // stop_ 且没有剩余任务
+                }
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+private:
+    const size_t max_threads_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::vector<std::thread> threads_;
+    size_t idle_ = 0;      // 正在等待任务的线程数
+    bool stop_ = false;
+};
+
+// =============================================================================
+// ResumeTarget - 阻塞任务完成后恢复协程的位置
+// =============================================================================
+
+struct ResumeTarget {
+    void (*resume)(void* context, std::coroutine_handle<> coro);
+    void* context;
+
+    // 恢复到全局调度器
+    static ResumeTarget scheduler() noexcept {
+        return {[](void*, std::coroutine_handle<> coro) {
+                    Scheduler::instance().schedule(coro);
+                },
+                nullptr};
+    }
+};
+
+// =============================================================================
+// BlockingAwaiter - 在 BlockingPool 中执行 fn，完成后在 target 上恢复协程
+// =============================================================================
+
+template <typename Fn>
+class BlockingAwaiter {
+public:
+    using result_type = std::invoke_result_t<Fn&>;
+
+    BlockingAwaiter(Fn fn, ResumeTarget target, BlockingPool& pool = BlockingPool::instance())
+        : fn_(std::move(fn)), target_(target), pool_(&pool) {}
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> coro) {
+        bool submitted = pool_->submit([this, coro] {
+            try {
+                if constexpr (std::is_void_v<result_type>) {
+                    fn_();
+                } else {
+                    result_.emplace(fn_());
+                }
+            } catch (...) {
+                exception_ = std::current_exception();
+            }
+            target_.resume(target_.context, coro);
+        });
+        if (!submitted) {
+            // 线程池已停止：不挂起，在 await_resume 中抛出，协程不会被遗忘
+            exception_ = std::make_exception_ptr(
+                std::runtime_error("spawn_blocking failed: BlockingPool is shut down"));
+        }
+        return submitted;   // 提交成功后任务可能已经恢复协程，不能再访问 this
+    }
+
+    result_type await_resume() {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+        if constexpr (!std::is_void_v<result_type>) {
+            return std::move(*result_);
+        }
+    }
+
+private:
+    using storage_type = std::conditional_t<std::is_void_v<result_type>,
+                                            std::monostate, result_type>;
+
+    Fn fn_;
+    ResumeTarget target_;
+    BlockingPool* pool_;
+    std::optional<storage_type> result_;
+    std::exception_ptr exception_;
+};
+
+// 在阻塞线程池中执行 fn，co_await 的结果为 fn 的返回值（异常会被重新抛出）
+// 默认恢复到全局调度器
+template <typename Fn>
+BlockingAwaiter<std::decay_t<Fn>> spawn_blocking(
+    Fn&& fn, ResumeTarget target = ResumeTarget::scheduler()) {
+    return BlockingAwaiter<std::decay_t<Fn>>(std::forward<Fn>(fn), target);
+}
+
+// 同上，在指定的阻塞线程池中执行
+template <typename Fn>
+BlockingAwaiter<std::decay_t<Fn>> spawn_blocking(
+    BlockingPool& pool, Fn&& fn, ResumeTarget target = ResumeTarget::scheduler()) {
+    return BlockingAwaiter<std::decay_t<Fn>>(std::forward<Fn>(fn), target, pool);
+}
+
+} // namespace zlcoro
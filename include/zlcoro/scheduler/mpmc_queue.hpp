@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace zlcoro {
+
+// =============================================================================
+// BoundedMpmcQueue<T> - 有界多生产者多消费者无锁队列
+// =============================================================================
+//
+// 基于 Dmitry Vyukov 的有界 MPMC 环形队列：
+// - 每个槽位带一个序号，生产者/消费者通过 CAS 抢占位置
+// - 容量在构造时确定，之后 push/pop 不做任何堆分配
+// - 队列满时 try_push 返回 false，由调用者决定如何处理（降级/背压）
+// =============================================================================
+
+template <typename T>
+class BoundedMpmcQueue {
+public:
+    explicit BoundedMpmcQueue(size_t capacity = 1024) {
+        // 容量向上取整到 2 的幂
+        size_t cap = 2;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        capacity_ = cap;
+        mask_ = cap - 1;
+        cells_ = std::make_unique<Cell[]>(cap);
+        for (size_t i = 0; i < cap; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 禁止拷贝
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+    ~BoundedMpmcQueue() {
+        // 析构剩余元素
+        while (try_pop()) {
+        }
+    }
+
+    // 尝试入队，队列满时返回 false（value 保持不变）
+    template <typename U>
+    bool try_push(U&& value) {
+        Cell* cell;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (static_cast<void*>(cell->storage)) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 尝试出队，队列空时返回 nullopt
+    std::optional<T> try_pop() {
+        Cell* cell;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;  // 空
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* slot = std::launder(reinterpret_cast<T*>(cell->storage));
+        std::optional<T> result(std::move(*slot));
+        std::destroy_at(slot);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return result;
+    }
+
+    // 近似大小（并发情况下仅供参考）
+    size_t size_approx() const noexcept {
+        size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty_approx() const noexcept {
+        return size_approx() == 0;
+    }
+
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+
+    // 生产者和消费者的位置分别放在独立的缓存行
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+
+} // namespace zlcoro
@@ -2,8 +2,17 @@
 
 #include "thread_pool.hpp"
 #include "zlcoro/core/task.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <coroutine>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace zlcoro {
 
@@ -11,9 +20,16 @@ namespace zlcoro {
 // Scheduler - 协程调度器
 // =============================================================================
 // 
-// 负责调度协程的执行，将协程任务分配到线程池。
+// 负责调度协程的执行，将协程任务分配到工作窃取线程池。
+// 线程池默认有 hardware_concurrency() 个不绑定 CPU 的工作线程；
+// 在第一次使用调度器之前调用 Scheduler::configure() 可以修改线程数、
+// CPU 绑定和 NUMA 分组。
 // 
 // 使用方式:
+//   ThreadPoolOptions options;
+//   options.cpus = {2, 3, 4, 5};   // CPU 0、1 留给网卡中断
+//   Scheduler::configure(options);  // main() 开头，任何 co_await schedule() 之前
+//
 //   auto& scheduler = Scheduler::instance();
 //   scheduler.schedule(some_coroutine_handle);
 // =============================================================================
@@ -22,25 +38,41 @@ class Scheduler {
 public:
     // 获取全局调度器实例（单例模式）
     static Scheduler& instance() {
-        static Scheduler scheduler;
+        static Scheduler scheduler(take_options());
         return scheduler;
     }
 
+    // 设置全局调度器的线程池参数；调度器已经创建后调用会抛出异常
+    static void configure(ThreadPoolOptions options) {
+        std::lock_guard<std::mutex> lock(config_mutex());
+        if (created()) {
+            throw std::logic_error("Scheduler::configure called after the scheduler was created");
+        }
+        pending_options() = std::move(options);
+    }
+
     // 禁止拷贝和移动
     Scheduler(const Scheduler&) = delete;
     Scheduler& operator=(const Scheduler&) = delete;
 
     // 调度一个协程句柄
-    void schedule(std::coroutine_handle<> coro) {
+    // 在工作线程中调用时进入该线程的本地队列，否则进入全局注入队列
+    void schedule(std::coroutine_handle<> coro, TaskPriority priority = TaskPriority::Normal) {
         if (!coro || coro.done()) {
             return;
         }
         
-        thread_pool_.submit([coro]() mutable {
-            if (!coro.done()) {
-                coro.resume();
-            }
-        });
+        thread_pool_.submit(coro, priority);
+    }
+
+    // 调度一个带截止时间的协程句柄（最早截止时间优先，先于所有优先级通道）
+    void schedule_before(std::coroutine_handle<> coro,
+                         std::chrono::steady_clock::time_point deadline) {
+        if (!coro || coro.done()) {
+            return;
+        }
+
+        thread_pool_.submit_before(coro, deadline);
     }
 
     // 调度一个可调用对象
@@ -59,10 +91,37 @@ public:
         return thread_pool_.thread_count();
     }
 
+    // 线程池指标快照
+    ThreadPoolMetrics metrics() const {
+        return thread_pool_.metrics();
+    }
+
 private:
     // 私有构造函数（单例模式）
-    Scheduler() 
-        : thread_pool_(std::thread::hardware_concurrency()) {
+    explicit Scheduler(const ThreadPoolOptions& options)
+        : thread_pool_(options) {
+    }
+
+    // 取出 configure() 设置的参数，并标记调度器已创建
+    static ThreadPoolOptions take_options() {
+        std::lock_guard<std::mutex> lock(config_mutex());
+        created() = true;
+        return std::move(pending_options());
+    }
+
+    static std::mutex& config_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static ThreadPoolOptions& pending_options() {
+        static ThreadPoolOptions options;
+        return options;
+    }
+
+    static bool& created() {
+        static bool value = false;
+        return value;
     }
 
     ~Scheduler() {
@@ -78,44 +137,196 @@ private:
 // =============================================================================
 // 
 // 使用方式:
-//   co_await schedule();  // 当前协程会被重新调度到线程池
+//   co_await schedule();                     // 当前协程会被重新调度到线程池
+//   co_await schedule(TaskPriority::High);   // 延迟敏感的请求处理
+//   co_await schedule(TaskPriority::Low);    // 批处理，不挤占请求处理
+//   co_await schedule_before(deadline);      // 按截止时间排序，先于所有优先级
+//
+// 只有默认的 schedule()（Normal 优先级）在已经位于调度器工作线程上时不挂起
+// （不需要切换线程）；指定了优先级或截止时间时总是重新入队，让排在前面的
+// 更高优先级任务先执行。需要让出执行权时使用 co_await yield()。
 // =============================================================================
 
 struct ScheduleAwaiter {
+    TaskPriority priority = TaskPriority::Normal;
+    std::coroutine_handle<> coro_ = nullptr;   // 只在启用追踪时记录
+
+    bool await_ready() const {
+        return priority == TaskPriority::Normal &&
+               Scheduler::instance().thread_pool().is_worker_thread();
+    }
+
+    void await_suspend(std::coroutine_handle<> coro) {
+        if constexpr (tracing_enabled) {
+            coro_ = coro;
+            detail::trace_suspend(coro.address(), "schedule");
+        }
+        // 将协程提交到调度器
+        Scheduler::instance().schedule(coro, priority);
+    }
+
+    void await_resume() const noexcept {
+        if constexpr (tracing_enabled) {
+            if (coro_) {   // await_ready 跳过挂起时没有对应的 Suspend
+                detail::trace_resume(coro_.address(), "schedule");
+            }
+        }
+    }
+};
+
+// 辅助函数：创建 ScheduleAwaiter
+inline ScheduleAwaiter schedule(TaskPriority priority = TaskPriority::Normal) {
+    return ScheduleAwaiter{priority};
+}
+
+struct DeadlineScheduleAwaiter {
+    std::chrono::steady_clock::time_point deadline;
+    std::coroutine_handle<> coro_ = nullptr;   // 只在启用追踪时记录
+
     bool await_ready() const noexcept {
-        return false;  // 总是挂起
+        return false;   // 截止时间总是要进入截止时间堆排序
+    }
+
+    void await_suspend(std::coroutine_handle<> coro) {
+        if constexpr (tracing_enabled) {
+            coro_ = coro;
+            detail::trace_suspend(coro.address(), "schedule_before");
+        }
+        Scheduler::instance().schedule_before(coro, deadline);
+    }
+
+    void await_resume() const noexcept {
+        if constexpr (tracing_enabled) {
+            detail::trace_resume(coro_.address(), "schedule_before");
+        }
+    }
+};
+
+// 辅助函数：以截止时间切换到调度器
+inline DeadlineScheduleAwaiter schedule_before(std::chrono::steady_clock::time_point deadline) {
+    return DeadlineScheduleAwaiter{deadline};
+}
+
+// =============================================================================
+// YieldAwaiter - co_await yield()：让出执行权
+// =============================================================================
+//
+// 总是挂起，排到当前执行器（线程池或事件循环）队列的尾部，让已经排队的
+// 任务先执行；不在任何执行器中时交给调度器。
+// 工作线程上 yield 进入注入队列而不是本地 LIFO 队列，否则会立刻被自己取回。
+// =============================================================================
+
+struct YieldAwaiter {
+    bool await_ready() const noexcept {
+        return false;
     }
 
     void await_suspend(std::coroutine_handle<> coro) const {
-        // 将协程提交到调度器
-        Scheduler::instance().schedule(coro);
+        if (Executor* executor = Executor::current()) {
+            executor->execute(coro);
+        } else {
+            Scheduler::instance().schedule(coro);
+        }
     }
 
     void await_resume() const noexcept {}
 };
 
-// 辅助函数：创建 ScheduleAwaiter
-inline ScheduleAwaiter schedule() {
+inline YieldAwaiter yield() noexcept {
     return {};
 }
 
 // =============================================================================
-// NewThreadAwaiter - 在新线程中恢复协程
+// NewThreadAwaiter - 在专用线程中恢复协程
 // =============================================================================
 // 
 // 使用方式:
-//   co_await resume_on_new_thread();  // 协程在新线程中继续执行
+//   co_await resume_on_new_thread();  // 协程在一个专用线程中继续执行
+//
+// 专用线程在协程挂起或结束、把线程交还之后回到缓存中，空闲超过
+// keep_alive 才退出；下一次 resume_on_new_thread() 复用空闲线程，
+// 不再每次创建线程。同一时刻每个专用线程只运行一个协程，
+// 适合长时间阻塞的调用（不占用调度器的工作线程）。
 // =============================================================================
 
+namespace detail {
+
+class DedicatedThreadPool {
+public:
+    static constexpr auto keep_alive = std::chrono::seconds(30);
+    static constexpr size_t max_idle = 64;
+
+    // 进程退出时仍可能有专用线程在运行，实例不析构
+    static DedicatedThreadPool& instance() {
+        static auto* pool = new DedicatedThreadPool();
+        return *pool;
+    }
+
+    void run(std::coroutine_handle<> coro) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                Worker* worker = idle_.back();
+                idle_.pop_back();
+                worker->coro = coro;
+                worker->wakeup.notify_one();
+                return;
+            }
+        }
+        std::thread([this, coro] { thread_main(coro); }).detach();
+        created_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 累计创建的线程数 / 当前空闲线程数
+    size_t threads_created() const noexcept {
+        return created_.load(std::memory_order_relaxed);
+    }
+
+    size_t idle_threads() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return idle_.size();
+    }
+
+private:
+    struct Worker {
+        std::condition_variable wakeup;
+        std::coroutine_handle<> coro;
+    };
+
+    void thread_main(std::coroutine_handle<> coro) {
+        Worker self;
+        while (true) {
+            coro.resume();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (idle_.size() >= max_idle) {
+                return;
+            }
+            idle_.push_back(&self);
+            if (!self.wakeup.wait_for(lock, keep_alive, [&] { return bool(self.coro); })) {
+                idle_.erase(std::find(idle_.begin(), idle_.end(), &self));
+                return;  // 空闲超时
+            }
+            coro = std::exchange(self.coro, nullptr);
+        }
+    }
+
+    DedicatedThreadPool() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<Worker*> idle_;
+    std::atomic<size_t> created_{0};
+};
+
+} // namespace detail
+
 struct NewThreadAwaiter {
     bool await_ready() const noexcept {
         return false;
     }
 
     void await_suspend(std::coroutine_handle<> coro) const {
-        std::thread([coro]() mutable {
-            coro.resume();
-        }).detach();
+        detail::DedicatedThreadPool::instance().run(coro);
     }
 
     void await_resume() const noexcept {}
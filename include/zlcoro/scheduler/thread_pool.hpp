@@ -1,45 +1,251 @@
 #pragma once
 
+#include "mpmc_queue.hpp"
+#include "work_stealing_queue.hpp"
+#include "zlcoro/core/executor.hpp"
+#include "zlcoro/core/metrics.hpp"
+#include "zlcoro/core/trace.hpp"
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <thread>
 #include <vector>
 #include <deque>
 #include <mutex>
-#include <condition_variable>
 #include <coroutine>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <optional>
+#include <string>
+#include <string_view>
 
 namespace zlcoro {
 
 // =============================================================================
-// ThreadPool - 线程池
+// ThreadPool - 工作窃取线程池
 // =============================================================================
 // 
-// 基础线程池实现，管理多个工作线程。
+// 管理多个工作线程，每个工作线程拥有一个 Chase-Lev 本地队列。
 // 特性：
 // - 固定数量的工作线程
-// - 任务队列管理
+// - 工作线程内恢复的协程压入本地队列（LIFO，缓存友好）
+// - 空闲线程随机选择受害者窃取任务，优先窃取同一 NUMA 节点上的线程
+// - 外部提交的协程句柄进入无锁有界注入队列（不做堆分配）
+// - 普通可调用对象走单独的慢速通道（std::function + 互斥锁）
+// - 可选：每个工作线程绑定到指定 CPU（ThreadPoolOptions）
+// - 三个优先级通道（High / Normal / Low），每个通道有自己的本地队列和
+//   注入队列；带截止时间的任务按最早截止时间优先（EDF）执行
+// - 防饥饿：每 starvation_interval 次调度反过来从低优先级开始找一次任务
+// - 空闲线程先自旋一小段时间再休眠；有线程在自旋时提交任务不需要唤醒
+//   （省掉一次 futex 唤醒和上下文切换），休眠在每个线程自己的
+//   std::atomic::wait 上
 // - 优雅关闭
 // =============================================================================
 
-class ThreadPool {
+namespace detail {
+
+// 自旋等待中的 CPU 提示（降低功耗，让出超线程的执行资源）
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+} // namespace detail
+
+// CPU 所在的 NUMA 节点（读取 /sys/devices/system/cpu/cpuN/nodeK，无法确定时为 0）
+inline int numa_node_of_cpu(int cpu) {
+    std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return 0;
+    }
+    int node = 0;
+    while (dirent* entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' &&
+            entry->d_name[4] <= '9') {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+// 当前进程允许运行的 CPU 列表（sched_getaffinity）
+inline std::vector<int> available_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+// 任务优先级：数值越小越先执行
+enum class TaskPriority : uint8_t {
+    High = 0,     // 延迟敏感（例如请求处理）
+    Normal = 1,   // 默认
+    Low = 2,      // 批处理（例如后台压缩）
+};
+
+inline constexpr size_t task_priority_count = 3;
+
+// ThreadPool 的构造参数
+//
+// 使用方式:
+//   // 4 个工作线程，避开留给网卡中断的 CPU 0、1
+//   ThreadPoolOptions options;
+//   options.num_threads = 4;
+//   options.cpus = {2, 3, 4, 5};
+//   ThreadPool pool(options);
+struct ThreadPoolOptions {
+    // 工作线程数；为 0 时取 cpus.size()，cpus 也为空时取 hardware_concurrency()
+    size_t num_threads = 0;
+
+    // 第 i 个工作线程绑定到 cpus[i % cpus.size()]；为空时不绑定
+    // 绑定失败（例如 CPU 不在 cgroup 允许的范围内）不影响正确性，忽略
+    std::vector<int> cpus;
+
+    // 第 i 个工作线程所属的 NUMA 节点（numa_nodes[i % numa_nodes.size()]）；
+    // 为空时按绑定的 CPU 从 sysfs 读取，没有绑定时视为同一个节点
+    std::vector<int> numa_nodes;
+
+    // 找不到任务时休眠前的自旋时间；为负时使用默认值：
+    // 多核机器 20us，单核机器不自旋（自旋会占住提交任务的线程需要的 CPU）
+    // 延迟敏感的部署可以调大，批处理部署可以设为 0
+    std::chrono::nanoseconds spin_time{-1};
+
+    // 每隔多少次调度按 Low -> High 的顺序找一次任务，保证低优先级任务在
+    // 高优先级负载饱和时仍然能前进；为 0 时严格按优先级
+    uint32_t starvation_interval = 32;
+};
+
+// 单个工作线程的指标快照
+struct WorkerMetrics {
+    uint64_t tasks_run = 0;              // 执行的任务数（协程恢复 + 可调用对象）
+    uint64_t steals = 0;                 // 其中从其他线程窃取到的任务数
+    uint64_t parks = 0;                  // 进入休眠的次数
+    std::chrono::nanoseconds idle_time{0};  // 累计休眠时间
+};
+
+// ThreadPool 的指标快照（各项分别读取，彼此之间不保证一致）
+struct ThreadPoolMetrics {
+    std::vector<WorkerMetrics> workers;
+    uint64_t wakeups = 0;                // 提交任务时唤醒休眠线程的次数
+    uint64_t pending_tasks = 0;          // 排队中的任务数（近似值）
+
+    // 转成 Prometheus 文本格式，每个工作线程一组 worker="i" 标签
+    std::string to_prometheus(std::string_view prefix = "zlcoro_thread_pool") const {
+        std::string out;
+        std::string prefix_str(prefix);
+        auto per_worker = [&](const char* name, const char* type, auto value_of) {
+            std::string metric = prefix_str + name;
+            append_prometheus_header(out, metric, type);
+            for (size_t i = 0; i < workers.size(); ++i) {
+                append_prometheus_sample(out, metric, "", "worker=\"" + std::to_string(i) + "\"",
+                                         value_of(workers[i]));
+            }
+        };
+        per_worker("_tasks_run_total", "counter",
+                   [](const WorkerMetrics& w) { return w.tasks_run; });
+        per_worker("_steals_total", "counter", [](const WorkerMetrics& w) { return w.steals; });
+        per_worker("_parks_total", "counter", [](const WorkerMetrics& w) { return w.parks; });
+        per_worker("_idle_seconds_total", "counter", [](const WorkerMetrics& w) {
+            return std::chrono::duration<double>(w.idle_time).count();
+        });
+
+        append_prometheus_header(out, prefix_str + "_wakeups_total", "counter");
+        append_prometheus_sample(out, prefix_str + "_wakeups_total", "", "", wakeups);
+        append_prometheus_header(out, prefix_str + "_pending_tasks", "gauge");
+        append_prometheus_sample(out, prefix_str + "_pending_tasks", "", "", pending_tasks);
+        return out;
+    }
+};
+
+class ThreadPool : public Executor {
 public:
     // 任务类型：无参数、无返回值的可调用对象
     using Task = std::function<void()>;
 
     // 构造函数：创建指定数量的工作线程
     explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency())
+        : ThreadPool(options_with_threads(num_threads)) {}
+
+    // 按 options 创建工作线程（线程数、CPU 绑定、NUMA 分组）
+    explicit ThreadPool(const ThreadPoolOptions& options)
         : stop_(false) {
-        
+        size_t num_threads = options.num_threads;
+        if (num_threads == 0) {
+            num_threads = options.cpus.empty() ? std::thread::hardware_concurrency()
+                                               : options.cpus.size();
+        }
         if (num_threads == 0) {
             num_threads = 1;
         }
 
-        // 创建工作线程
+        starvation_interval_ = options.starvation_interval;
+        spin_time_ = options.spin_time;
+        if (spin_time_ < std::chrono::nanoseconds::zero()) {
+            spin_time_ = std::thread::hardware_concurrency() > 1 ? std::chrono::microseconds(20)
+                                                                 : std::chrono::nanoseconds::zero();
+        }
+        // 最多一半的线程同时自旋，避免所有空闲线程一起空转
+        max_spinning_ = std::max<size_t>(1, num_threads / 2);
+        idle_workers_.reserve(num_threads);  // 休眠路径上不分配内存
+        deadline_heap_.reserve(256);
+
+        // 先创建所有本地队列，再启动线程（线程启动后会立即尝试窃取）
+        local_queues_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            auto local = std::make_unique<LocalQueue>();
+            if (!options.cpus.empty()) {
+                local->cpu = options.cpus[i % options.cpus.size()];
+            }
+            if (!options.numa_nodes.empty()) {
+                local->numa_node = options.numa_nodes[i % options.numa_nodes.size()];
+            } else if (local->cpu >= 0) {
+                local->numa_node = numa_node_of_cpu(local->cpu);
+            }
+            local_queues_.push_back(std::move(local));
+        }
+
+        // 窃取顺序：同节点的其他线程在前，其他节点的线程在后
+        for (size_t i = 0; i < num_threads; ++i) {
+            LocalQueue& local = *local_queues_[i];
+            for (size_t j = 0; j < num_threads; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                if (local_queues_[j]->numa_node == local.numa_node) {
+                    local.near_victims.push_back(j);
+                } else {
+                    local.far_victims.push_back(j);
+                }
+            }
+        }
+
+        // 创建工作线程；追踪缓冲区在这里预先分配，工作线程执行任务时不分配内存
         workers_.reserve(num_threads);
         for (size_t i = 0; i < num_threads; ++i) {
-            workers_.emplace_back(&ThreadPool::worker_thread, this, i);
+            workers_.emplace_back([this, i, ring = detail::trace_prepare_thread()]() mutable {
+                detail::trace_adopt_thread(std::move(ring));
+                worker_thread(i);
+            });
         }
     }
 
@@ -52,7 +258,7 @@ public:
         shutdown();
     }
 
-    // 提交任务到线程池
+    // 提交任务到线程池（慢速通道：进入可调用对象队列）
     void submit(Task task) {
         {
             std::lock_guard<std::mutex> lock(queue_mutex_);
@@ -60,9 +266,50 @@ public:
                 return;  // 已关闭，拒绝新任务
             }
             task_queue_.push_back(std::move(task));
+            queued_closures_.fetch_add(1, std::memory_order_relaxed);
         }
-        // 唤醒一个等待的线程
-        condition_.notify_one();
+        on_task_queued();
+    }
+
+    // 提交一个协程句柄（快速通道：全程不做堆分配）
+    // 在本线程池的工作线程中调用时压入该优先级的本地队列，否则进入无锁注入队列
+    void submit(std::coroutine_handle<> coro, TaskPriority priority = TaskPriority::Normal) {
+        auto lane = static_cast<size_t>(priority);
+        if (current_pool_ == this) {
+            local_queues_[current_index_]->lanes[lane].push(coro);
+            on_task_queued();
+            return;
+        }
+
+        inject(coro, lane);
+    }
+
+    // Executor 接口：排到 Normal 通道注入队列的尾部。
+    // 与 submit 不同，工作线程内调用也不进入本地（LIFO）队列，
+    // 用于 yield()：让同一线程上已经排队的任务先执行
+    void execute(std::coroutine_handle<> coro) override {
+        inject(coro, static_cast<size_t>(TaskPriority::Normal));
+    }
+
+    // 带 Promise 类型的句柄：避免与 std::function 重载产生歧义
+    template <typename Promise>
+    void submit(std::coroutine_handle<Promise> coro, TaskPriority priority = TaskPriority::Normal) {
+        submit(static_cast<std::coroutine_handle<>>(coro), priority);
+    }
+
+    // 提交一个带截止时间的协程句柄：先于所有优先级通道执行，
+    // 截止时间早的先执行（相同截止时间按提交顺序）
+    void submit_before(std::coroutine_handle<> coro, std::chrono::steady_clock::time_point deadline) {
+        {
+            std::lock_guard<std::mutex> lock(deadline_mutex_);
+            if (stop_.load(std::memory_order_relaxed)) {
+                return;  // 已关闭，拒绝新任务
+            }
+            deadline_heap_.push_back(DeadlineTask{deadline, deadline_seq_++, coro});
+            std::push_heap(deadline_heap_.begin(), deadline_heap_.end(), DeadlineTask::later);
+            deadlined_.fetch_add(1, std::memory_order_relaxed);
+        }
+        on_task_queued();
     }
 
     // 获取线程数量
@@ -70,10 +317,42 @@ public:
         return workers_.size();
     }
 
-    // 获取当前队列中的任务数量
+    // 第 index 个工作线程绑定的 CPU（未绑定时为 -1）
+    int worker_cpu(size_t index) const {
+        return local_queues_.at(index)->cpu;
+    }
+
+    // 第 index 个工作线程所属的 NUMA 节点
+    int worker_numa_node(size_t index) const {
+        return local_queues_.at(index)->numa_node;
+    }
+
+    // 获取当前排队的任务数量（近似值，不加锁）
     size_t pending_tasks() const {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        return task_queue_.size();
+        int64_t n = queued_.load(std::memory_order_relaxed);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    // 读取指标快照（任意线程，不加锁）
+    ThreadPoolMetrics metrics() const {
+        ThreadPoolMetrics result;
+        result.workers.reserve(local_queues_.size());
+        for (const auto& local : local_queues_) {
+            WorkerMetrics worker;
+            worker.tasks_run = local->tasks_run.load();
+            worker.steals = local->steals.load();
+            worker.parks = local->parks.load();
+            worker.idle_time = std::chrono::nanoseconds(local->idle_ns.load());
+            result.workers.push_back(worker);
+        }
+        result.wakeups = wakeups_.load();
+        result.pending_tasks = pending_tasks();
+        return result;
+    }
+
+    // 当前线程是否是本线程池的工作线程
+    bool is_worker_thread() const noexcept {
+        return current_pool_ == this;
     }
 
     // 停止线程池
@@ -87,7 +366,8 @@ public:
         }
         
         // 唤醒所有线程
-        condition_.notify_all();
+        while (unpark_one()) {
+        }
         
         // 等待所有线程结束
         for (auto& worker : workers_) {
@@ -100,58 +380,430 @@ public:
     }
 
 private:
+    // 每个工作线程的本地队列，按缓存行对齐避免伪共享
+    // 指标计数器只由对应的工作线程写入
+    struct alignas(64) LocalQueue {
+        std::array<WorkStealingQueue<std::coroutine_handle<>>, task_priority_count> lanes;
+        uint32_t dispatches = 0;            // 执行过的任务数（防饥饿计数，只由所属线程访问）
+        MetricCounter tasks_run;
+        MetricCounter steals;
+        MetricCounter parks;
+        MetricCounter idle_ns;
+
+        // 休眠标志：1 表示在 parked.wait(1) 中（或即将进入），唤醒者置 0
+        std::atomic<uint32_t> parked{0};
+
+        // 构造时确定，之后只读
+        int cpu = -1;                       // 绑定的 CPU（-1 表示不绑定）
+        int numa_node = 0;
+        std::vector<size_t> near_victims;   // 同一 NUMA 节点上的其他线程
+        std::vector<size_t> far_victims;    // 其他节点上的线程
+    };
+
+    // 任务入队后调用：计数，没有线程在自旋时唤醒一个休眠的线程
+    //
+    // 与 park_or_run() 配对（都是 seq_cst）：这里先增加 queued_ 再读取
+    // spinning_ / sleeping_，工作线程先减少 spinning_、增加 sleeping_ 再读取
+    // queued_。要么这里看到对方仍在自旋或已经休眠，要么对方看到新任务。
+    void on_task_queued() {
+        queued_.fetch_add(1, std::memory_order_seq_cst);
+        if (spinning_.load(std::memory_order_seq_cst) > 0) {
+            return;  // 自旋中的线程会取走任务
+        }
+        if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+            unpark_one();
+        }
+    }
+
+    // 唤醒一个休眠的线程，没有休眠的线程时返回 false
+    bool unpark_one() {
+        LocalQueue* local;
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            if (idle_workers_.empty()) {
+                return false;
+            }
+            local = local_queues_[idle_workers_.back()].get();
+            idle_workers_.pop_back();
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+            wakeups_.add();  // 锁内递增：仍然只有一个写者
+            local->parked.store(0, std::memory_order_release);
+        }
+        local->parked.notify_one();
+        return true;
+    }
+
+    // 自旋等待任务，最长 spin_time_；在 spinning_ 计数期间提交的任务
+    // 不会唤醒其他线程。返回 true 表示找到并执行了一个任务
+    bool spin(size_t thread_id) {
+        if (spin_time_ <= std::chrono::nanoseconds::zero()) {
+            return false;
+        }
+        if (spinning_.fetch_add(1, std::memory_order_seq_cst) >= max_spinning_) {
+            spinning_.fetch_sub(1, std::memory_order_seq_cst);
+            return false;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + spin_time_;
+        for (uint32_t i = 1;; ++i) {
+            if (queued_.load(std::memory_order_relaxed) > 0) {
+                // 先退出自旋状态再执行：如果这是最后一个自旋的线程，
+                // 期间被跳过的唤醒由这里补上
+                if (spinning_.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+                    queued_.load(std::memory_order_seq_cst) > 1 &&
+                    sleeping_.load(std::memory_order_seq_cst) > 0) {
+                    unpark_one();
+                }
+                if (run_next(thread_id)) {
+                    return true;
+                }
+                // 任务被别的线程抢走了，重新进入自旋
+                if (spinning_.fetch_add(1, std::memory_order_seq_cst) >= max_spinning_) {
+                    spinning_.fetch_sub(1, std::memory_order_seq_cst);
+                    return false;
+                }
+            }
+            detail::cpu_relax();
+            if (i % 64 == 0 && std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        spinning_.fetch_sub(1, std::memory_order_seq_cst);
+        return false;
+    }
+
+    // 在本线程的休眠标志上等待，直到被 unpark_one() 唤醒或发现新任务
+    void park(size_t thread_id) {
+        LocalQueue& local = *local_queues_[thread_id];
+        local.parks.add();
+        auto idle_start = metrics_now();
+
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            local.parked.store(1, std::memory_order_relaxed);
+            idle_workers_.push_back(thread_id);
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        if (stop_.load(std::memory_order_seq_cst) || queued_.load(std::memory_order_seq_cst) > 0) {
+            // 登记之后发现了任务：撤销登记（如果已被唤醒，唤醒已经消耗在这里）
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            auto it = std::find(idle_workers_.begin(), idle_workers_.end(), thread_id);
+            if (it != idle_workers_.end()) {
+                idle_workers_.erase(it);
+                sleeping_.fetch_sub(1, std::memory_order_relaxed);
+                local.parked.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        while (local.parked.load(std::memory_order_acquire) != 0) {
+            local.parked.wait(1, std::memory_order_acquire);
+        }
+
+        if constexpr (metrics_enabled) {
+            local.idle_ns.add(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(metrics_now() - idle_start)
+                    .count()));
+        }
+    }
+
     // 工作线程函数
-    void worker_thread([[maybe_unused]] size_t thread_id) {
+    void worker_thread(size_t thread_id) {
+        current_pool_ = this;
+        current_index_ = thread_id;
+        CurrentScope executor_scope(this);
+        rng_state_ = 0x9E3779B97F4A7C15ull * (thread_id + 1);
+
+        if (int cpu = local_queues_[thread_id]->cpu; cpu >= 0) {
+            pin_current_thread(cpu);
+        }
+
         while (true) {
-            std::optional<Task> task;
-            
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                
-                // 等待任务或停止信号
-                condition_.wait(lock, [this] {
-                    return stop_ || !task_queue_.empty();
-                });
-                
-                // 如果停止且队列为空，退出
-                if (stop_ && task_queue_.empty()) {
-                    return;
-                }
-                
-                // 取出任务
-                if (!task_queue_.empty()) {
-                    task = std::move(task_queue_.front());
-                    task_queue_.pop_front();
+            if (run_next(thread_id)) {
+                continue;
+            }
+
+            // 如果停止且所有队列为空，退出
+            if (stop_.load(std::memory_order_seq_cst) &&
+                queued_.load(std::memory_order_seq_cst) <= 0) {
+                break;
+            }
+
+            if (spin(thread_id)) {
+                continue;
+            }
+
+            // 等待任务或停止信号
+            park(thread_id);
+        }
+
+        current_pool_ = nullptr;
+    }
+
+    // 按 截止时间（EDF）-> 各优先级通道（本地队列 -> 注入队列，Normal 通道
+    // 之后是可调用对象）-> 窃取 的顺序找一个任务执行。
+    // 每 starvation_interval_ 次调度反过来从 Low 通道开始找，截止时间最后。
+    // 返回 false 表示没有找到任何任务
+    bool run_next(size_t thread_id) {
+        LocalQueue& local = *local_queues_[thread_id];
+        bool reverse = starvation_interval_ != 0 &&
+                       (local.dispatches + 1) % starvation_interval_ == 0;
+
+        if (!reverse) {
+            if (auto coro = pop_deadline()) {
+                run_coroutine(local, *coro);
+                return true;
+            }
+        }
+
+        for (size_t i = 0; i < task_priority_count; ++i) {
+            size_t lane = reverse ? task_priority_count - 1 - i : i;
+            // 空通道先用只读检查跳过：pop() 即使为空也要写 bottom_ 并执行 seq_cst 栅栏
+            if (!local.lanes[lane].empty()) {
+                if (auto coro = local.lanes[lane].pop()) {
+                    run_coroutine(local, *coro);
+                    return true;
                 }
             }
-            
-            // 执行任务（在锁外执行）
-            if (task) {
-                try {
-                    (*task)();
-                } catch (...) {
-                    // 捕获并忽略异常，防止线程崩溃
-                    // 实际应用中应该记录日志
+            if (auto coro = pop_injected(lane)) {
+                run_coroutine(local, *coro);
+                return true;
+            }
+            if (lane == static_cast<size_t>(TaskPriority::Normal)) {
+                if (auto task = pop_closure()) {
+                    queued_.fetch_sub(1, std::memory_order_relaxed);
+                    local.tasks_run.add();
+                    ++local.dispatches;
+                    try {
+                        (*task)();
+                    } catch (...) {
+                        // 捕获并忽略异常，防止线程崩溃
+                        // 实际应用中应该记录日志
+                    }
+                    return true;
                 }
             }
         }
+
+        if (reverse) {
+            if (auto coro = pop_deadline()) {
+                run_coroutine(local, *coro);
+                return true;
+            }
+        }
+
+        if (auto coro = steal(thread_id)) {
+            local.steals.add();
+            run_coroutine(local, *coro);
+            return true;
+        }
+
+        return false;
+    }
+
+    // 放入全局注入队列
+    void inject(std::coroutine_handle<> coro, size_t lane) {
+        if (stop_.load(std::memory_order_relaxed)) {
+            return;  // 已关闭，拒绝新任务
+        }
+
+        InjectionLane& injection = injection_lanes_[lane];
+        if (!injection.queue.try_push(coro)) {
+            // 注入队列已满：退化到有锁的溢出队列
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            injection.overflow.push_back(coro);
+            injection.overflowed.fetch_add(1, std::memory_order_relaxed);
+        }
+        on_task_queued();
+    }
+
+    void run_coroutine(LocalQueue& local, std::coroutine_handle<> coro) {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        local.tasks_run.add();
+        ++local.dispatches;
+        resume(coro);
+    }
+
+    std::optional<std::coroutine_handle<>> pop_injected(size_t lane) {
+        InjectionLane& injection = injection_lanes_[lane];
+        if (!injection.queue.empty_approx()) {
+            if (auto coro = injection.queue.try_pop()) {
+                return coro;
+            }
+        }
+
+        if (injection.overflowed.load(std::memory_order_relaxed) == 0) {
+            return std::nullopt;  // 快速路径：不碰锁
+        }
+
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (injection.overflow.empty()) {
+            return std::nullopt;
+        }
+        auto coro = injection.overflow.front();
+        injection.overflow.pop_front();
+        injection.overflowed.fetch_sub(1, std::memory_order_relaxed);
+        return coro;
+    }
+
+    // 取出截止时间最早的任务
+    std::optional<std::coroutine_handle<>> pop_deadline() {
+        if (deadlined_.load(std::memory_order_relaxed) == 0) {
+            return std::nullopt;  // 快速路径：不碰锁
+        }
+
+        std::lock_guard<std::mutex> lock(deadline_mutex_);
+        if (deadline_heap_.empty()) {
+            return std::nullopt;
+        }
+        std::pop_heap(deadline_heap_.begin(), deadline_heap_.end(), DeadlineTask::later);
+        auto coro = deadline_heap_.back().coro;
+        deadline_heap_.pop_back();
+        deadlined_.fetch_sub(1, std::memory_order_relaxed);
+        return coro;
+    }
+
+    std::optional<Task> pop_closure() {
+        if (queued_closures_.load(std::memory_order_relaxed) == 0) {
+            return std::nullopt;  // 快速路径：不碰锁
+        }
+
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (task_queue_.empty()) {
+            return std::nullopt;
+        }
+        Task task = std::move(task_queue_.front());
+        task_queue_.pop_front();
+        queued_closures_.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    // 按优先级从高到低窃取；同一优先级先窃取同一 NUMA 节点上的线程，
+    // 再窃取其他节点（跨节点访问远端缓存更贵）
+    std::optional<std::coroutine_handle<>> steal(size_t thread_id) {
+        const LocalQueue& local = *local_queues_[thread_id];
+        for (size_t lane = 0; lane < task_priority_count; ++lane) {
+            if (auto coro = steal_from(local.near_victims, lane)) {
+                return coro;
+            }
+            if (auto coro = steal_from(local.far_victims, lane)) {
+                return coro;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // 从随机受害者开始，依次尝试窃取 victims 中该优先级的本地队列
+    std::optional<std::coroutine_handle<>> steal_from(const std::vector<size_t>& victims,
+                                                      size_t lane) {
+        const size_t n = victims.size();
+        if (n == 0) {
+            return std::nullopt;
+        }
+
+        size_t start = static_cast<size_t>(next_random() % n);
+        for (size_t i = 0; i < n; ++i) {
+            if (auto coro = local_queues_[victims[(start + i) % n]]->lanes[lane].steal()) {
+                return coro;
+            }
+        }
+        return std::nullopt;
+    }
+
+    static ThreadPoolOptions options_with_threads(size_t num_threads) {
+        ThreadPoolOptions options;
+        options.num_threads = num_threads == 0 ? 1 : num_threads;
+        return options;
+    }
+
+    static void pin_current_thread(int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        // 绑定失败（例如受 cgroup 限制）不影响正确性，忽略
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    static void resume(std::coroutine_handle<> coro) {
+        if (coro && !coro.done()) {
+            coro.resume();
+        }
+    }
+
+    // xorshift64，只用于选择窃取起点
+    static uint64_t next_random() noexcept {
+        uint64_t x = rng_state_;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        rng_state_ = x;
+        return x;
     }
 
 private:
     // 工作线程
     std::vector<std::thread> workers_;
+
+    // 每个工作线程的本地队列（下标与 thread_id 对应）
+    std::vector<std::unique_ptr<LocalQueue>> local_queues_;
     
-    // 任务队列
+    // 每个优先级一个全局注入队列：外部提交的协程句柄（预分配的无锁环形队列）
+    // 注入队列满时进入溢出队列（极少使用，queue_mutex_ 保护）
+    struct InjectionLane {
+        BoundedMpmcQueue<std::coroutine_handle<>> queue{4096};
+        std::deque<std::coroutine_handle<>> overflow;
+        std::atomic<size_t> overflowed{0};
+    };
+    std::array<InjectionLane, task_priority_count> injection_lanes_;
+
+    // 带截止时间的任务：按 (deadline, seq) 排列的最小堆
+    struct DeadlineTask {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t seq;
+        std::coroutine_handle<> coro;
+
+        static bool later(const DeadlineTask& a, const DeadlineTask& b) noexcept {
+            return a.deadline != b.deadline ? a.deadline > b.deadline : a.seq > b.seq;
+        }
+    };
+    std::mutex deadline_mutex_;
+    std::vector<DeadlineTask> deadline_heap_;
+    uint64_t deadline_seq_ = 0;
+    std::atomic<size_t> deadlined_{0};
+
+    // 可调用对象队列（慢速通道）
     std::deque<Task> task_queue_;
+    std::atomic<size_t> queued_closures_{0};
     
-    // 互斥锁保护任务队列
+    // 互斥锁保护慢速通道、溢出队列和停止标志的设置
     mutable std::mutex queue_mutex_;
-    
-    // 条件变量用于线程唤醒
-    std::condition_variable condition_;
+
+    // 休眠中的线程下标（只在休眠和唤醒时加锁）
+    std::mutex idle_mutex_;
+    std::vector<size_t> idle_workers_;
+
+    // 所有队列中的任务总数（入队后加、出队后减，可能短暂为负）
+    std::atomic<int64_t> queued_{0};
+
+    // 正在休眠 / 自旋的线程数
+    std::atomic<size_t> sleeping_{0};
+    std::atomic<size_t> spinning_{0};
+
+    // 防饥饿间隔与自旋参数（构造时确定）
+    uint32_t starvation_interval_ = 32;
+    std::chrono::nanoseconds spin_time_{0};
+    size_t max_spinning_ = 1;
+
+    // 唤醒休眠线程的次数（在 idle_mutex_ 内递增）
+    MetricCounter wakeups_;
     
     // 停止标志
     std::atomic<bool> stop_;
+
+    // 当前线程所属的线程池及其下标（非工作线程为 nullptr）
+    static inline thread_local ThreadPool* current_pool_ = nullptr;
+    static inline thread_local size_t current_index_ = 0;
+    static inline thread_local uint64_t rng_state_ = 0x9E3779B97F4A7C15ull;
 };
 
 } // namespace zlcoro
@@ -0,0 +1,366 @@
+#pragma once
+
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/scheduler/scheduler.hpp"
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// when_all / when_any - 并发等待多个 Task
+// =============================================================================
+//
+// 子任务全部提交到调度器并发执行：
+// - when_all：计数器和子任务都存放在返回的 Awaiter 中，即 co_await 它的
+//   父协程帧中；子任务结束时通过 TaskCompletion 回调递减计数，最后一个
+//   结束的子任务通过对称转移直接恢复父协程。除子任务自身的帧外没有任何
+//   堆分配
+// - when_any：第一个结束的子任务恢复父协程。其余子任务不会被取消，它们
+//   继续执行，结束后由共享状态自行销毁（每次 when_any 一次分配）
+// - 子任务继承父协程的取消令牌（见 cancellation.hpp）
+//
+// 使用方式:
+//   auto [a, b] = co_await when_all(fetch_a(), fetch_b());
+//
+//   std::vector<Task<int>> tasks = ...;
+//   std::vector<int> results = co_await when_all(std::move(tasks));
+//
+//   auto first = co_await when_any(std::move(tasks));
+//   // first.index 是最先完成的子任务，first.value 是它的结果
+//
+// 注意：
+// - 返回的是 Awaiter 而不是 Task，需要直接 co_await
+// - 子任务的异常在 co_await 时重新抛出（when_all 按参数顺序抛出第一个）
+// - 父协程在最后（when_any 为第一个）结束的子任务所在的工作线程中恢复
+// =============================================================================
+
+namespace detail {
+
+// void 结果在 tuple / vector 中用 std::monostate 占位
+template <typename T>
+using when_all_value_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+// 取出已完成 Task 的结果（异常会被重新抛出）
+template <typename T>
+when_all_value_t<T> take_result(Task<T>& task) {
+    if constexpr (std::is_void_v<T>) {
+        task.result();
+        return {};
+    } else if constexpr (std::is_reference_v<T>) {
+        return task.result();
+    } else {
+        return std::move(task).result();
+    }
+}
+
+// 在调度器上启动子任务，结束时通知 completion；子任务继承 parent 的取消令牌
+template <typename T, typename Promise>
+void start_child(Task<T>& task, TaskCompletion* completion, std::coroutine_handle<Promise> parent) {
+    task.handle().promise().set_completion(completion);
+    inherit_stop_token(task.handle().promise(), parent);
+    Scheduler::instance().schedule(std::coroutine_handle<>(task.handle()));
+}
+
+// =============================================================================
+// WhenAllCounter - 子任务完成计数
+// =============================================================================
+//
+// 计数初始为 count + 1：多出的 1 由父协程在启动完所有子任务后递减，
+// 避免子任务在 await_suspend 返回之前恢复父协程。
+// =============================================================================
+
+class WhenAllCounter : public TaskCompletion {
+public:
+    explicit WhenAllCounter(size_t count) noexcept
+        : TaskCompletion{&on_child_complete}, remaining_(count + 1) {}
+
+    WhenAllCounter(const WhenAllCounter&) = delete;
+    WhenAllCounter& operator=(const WhenAllCounter&) = delete;
+
+    void set_parent(std::coroutine_handle<> parent) noexcept {
+        parent_ = parent;
+    }
+
+    // 启动完所有子任务后调用：返回 true 表示父协程需要挂起
+    bool try_suspend() noexcept {
+        return remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+private:
+    static std::coroutine_handle<> on_child_complete(TaskCompletion* self,
+                                                     std::coroutine_handle<>) noexcept {
+        auto* counter = static_cast<WhenAllCounter*>(self);
+        if (counter->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            return counter->parent_;  // 最后一个：对称转移到父协程
+        }
+        return std::noop_coroutine();
+    }
+
+    std::atomic<size_t> remaining_;
+    std::coroutine_handle<> parent_;
+};
+
+// =============================================================================
+// WhenAllAwaiter - 固定数量、类型各异的子任务
+// =============================================================================
+
+template <typename... Ts>
+class WhenAllAwaiter {
+public:
+    using result_type = std::tuple<when_all_value_t<Ts>...>;
+
+    explicit WhenAllAwaiter(Task<Ts>... tasks)
+        : tasks_(std::move(tasks)...), counter_(sizeof...(Ts)) {}
+
+    // 计数器的地址交给了子任务，不能移动
+    WhenAllAwaiter(const WhenAllAwaiter&) = delete;
+    WhenAllAwaiter& operator=(const WhenAllAwaiter&) = delete;
+
+    bool await_ready() const noexcept {
+        return sizeof...(Ts) == 0;
+    }
+
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> parent) {
+        counter_.set_parent(parent);
+        std::apply([this, parent](auto&... tasks) { (start_child(tasks, &counter_, parent), ...); },
+                   tasks_);
+        return counter_.try_suspend();
+    }
+
+    result_type await_resume() {
+        // 花括号初始化保证按参数顺序取结果
+        return std::apply([](auto&... tasks) { return result_type{take_result(tasks)...}; },
+                          tasks_);
+    }
+
+private:
+    std::tuple<Task<Ts>...> tasks_;
+    WhenAllCounter counter_;
+};
+
+// =============================================================================
+// WhenAllRangeAwaiter - 数量在运行期确定、类型相同的子任务
+// =============================================================================
+
+template <typename T>
+class WhenAllRangeAwaiter {
+public:
+    using result_type = std::conditional_t<std::is_void_v<T>, void,
+                                           std::vector<when_all_value_t<T>>>;
+
+    explicit WhenAllRangeAwaiter(std::vector<Task<T>> tasks)
+        : tasks_(std::move(tasks)), counter_(tasks_.size()) {}
+
+    WhenAllRangeAwaiter(const WhenAllRangeAwaiter&) = delete;
+    WhenAllRangeAwaiter& operator=(const WhenAllRangeAwaiter&) = delete;
+
+    bool await_ready() const noexcept {
+        return tasks_.empty();
+    }
+
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> parent) {
+        counter_.set_parent(parent);
+        for (auto& task : tasks_) {
+            start_child(task, &counter_, parent);
+        }
+        return counter_.try_suspend();
+    }
+
+    result_type await_resume() {
+        if constexpr (std::is_void_v<T>) {
+            for (auto& task : tasks_) {
+                task.result();
+            }
+        } else {
+            result_type results;
+            results.reserve(tasks_.size());
+            for (auto& task : tasks_) {
+                results.push_back(take_result(task));
+            }
+            return results;
+        }
+    }
+
+private:
+    std::vector<Task<T>> tasks_;
+    WhenAllCounter counter_;
+};
+
+} // namespace detail
+
+// 并发执行所有子任务，全部完成后返回结果 tuple（void 对应 std::monostate）
+template <typename... Ts>
+detail::WhenAllAwaiter<Ts...> when_all(Task<Ts>... tasks) {
+    return detail::WhenAllAwaiter<Ts...>(std::move(tasks)...);
+}
+
+// 并发执行 vector 中的子任务，全部完成后按顺序返回结果（Task<void> 时返回 void）
+template <typename T>
+detail::WhenAllRangeAwaiter<T> when_all(std::vector<Task<T>> tasks) {
+    return detail::WhenAllRangeAwaiter<T>(std::move(tasks));
+}
+
+// =============================================================================
+// when_any
+// =============================================================================
+
+// when_any 的结果：最先完成的子任务下标及其结果
+template <typename T>
+struct WhenAnyResult {
+    size_t index;
+    detail::when_all_value_t<T> value;
+};
+
+namespace detail {
+
+// when_any 的共享状态：父协程和每个子任务各持有一个引用，
+// 最后一个释放者销毁状态（连同所有子任务的帧）
+template <typename T>
+class WhenAnyState : public TaskCompletion {
+public:
+    explicit WhenAnyState(std::vector<Task<T>> tasks)
+        : TaskCompletion{&on_child_complete},
+          tasks_(std::move(tasks)),
+          refs_(tasks_.size() + 1) {}
+
+    template <typename Promise>
+    void start(std::coroutine_handle<Promise> parent) {
+        parent_ = parent;
+        for (auto& task : tasks_) {
+            start_child(task, this, parent);
+        }
+    }
+
+    // 父协程启动完所有子任务后调用：返回 true 表示需要挂起
+    bool try_suspend() noexcept {
+        return arrivals_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    // 父协程恢复后取结果并释放自己的引用
+    WhenAnyResult<T> take() {
+        struct Release {
+            WhenAnyState* state;
+            ~Release() {
+                state->release();
+            }
+        } guard{this};
+
+        Task<T>& task = tasks_[winner_];
+        if constexpr (std::is_void_v<T>) {
+            task.result();
+            return {winner_, {}};
+        } else {
+            return {winner_, take_result(task)};
+        }
+    }
+
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+private:
+    static std::coroutine_handle<> on_child_complete(TaskCompletion* self,
+                                                     std::coroutine_handle<> task) noexcept {
+        auto* state = static_cast<WhenAnyState*>(self);
+        std::coroutine_handle<> next = std::noop_coroutine();
+
+        if (!state->won_.exchange(true, std::memory_order_acq_rel)) {
+            for (size_t i = 0; i < state->tasks_.size(); ++i) {
+                if (state->tasks_[i].handle().address() == task.address()) {
+                    state->winner_ = i;
+                    break;
+                }
+            }
+            // 父协程的 await_suspend 也已经结束时才恢复它
+            if (state->arrivals_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                next = state->parent_;
+            }
+        }
+
+        // 父协程仍持有引用，胜者的帧在 take() 之前不会被销毁；
+        // 最后一个结束的失败者在这里销毁状态（包括它自己已挂起的帧）
+        state->release();
+        return next;
+    }
+
+    std::vector<Task<T>> tasks_;
+    std::atomic<size_t> refs_;
+    std::atomic<size_t> arrivals_{2};   // 胜者 + 父协程的 await_suspend
+    std::atomic<bool> won_{false};
+    size_t winner_ = 0;
+    std::coroutine_handle<> parent_;
+};
+
+template <typename T>
+class WhenAnyAwaiter {
+public:
+    explicit WhenAnyAwaiter(std::vector<Task<T>> tasks) {
+        if (tasks.empty()) {
+            throw std::invalid_argument("when_any: no tasks");
+        }
+        state_ = new WhenAnyState<T>(std::move(tasks));
+    }
+
+    WhenAnyAwaiter(const WhenAnyAwaiter&) = delete;
+    WhenAnyAwaiter& operator=(const WhenAnyAwaiter&) = delete;
+
+    ~WhenAnyAwaiter() {
+        if (state_ && !started_) {
+            delete state_;  // 从未被 co_await：子任务没有启动
+        }
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> parent) {
+        started_ = true;
+        state_->start(parent);
+        return state_->try_suspend();
+    }
+
+    WhenAnyResult<T> await_resume() {
+        return state_->take();
+    }
+
+private:
+    WhenAnyState<T>* state_ = nullptr;
+    bool started_ = false;
+};
+
+} // namespace detail
+
+// 并发执行 vector 中的子任务，返回最先完成的一个
+template <typename T>
+detail::WhenAnyAwaiter<T> when_any(std::vector<Task<T>> tasks) {
+    return detail::WhenAnyAwaiter<T>(std::move(tasks));
+}
+
+// 同上，子任务类型必须相同
+template <typename T, typename... Rest>
+detail::WhenAnyAwaiter<T> when_any(Task<T> first, Task<Rest>... rest) {
+    static_assert((std::is_same_v<T, Rest> && ...), "when_any: all tasks must have the same type");
+    std::vector<Task<T>> tasks;
+    tasks.reserve(1 + sizeof...(Rest));
+    tasks.push_back(std::move(first));
+    (tasks.push_back(std::move(rest)), ...);
+    return detail::WhenAnyAwaiter<T>(std::move(tasks));
+}
+
+} // namespace zlcoro
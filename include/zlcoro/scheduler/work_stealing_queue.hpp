@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace zlcoro {
+
+// =============================================================================
+// WorkStealingQueue<T> - Chase-Lev 工作窃取双端队列
+// =============================================================================
+//
+// 每个工作线程独占一个队列：
+// - 所有者线程在底部 push / pop（LIFO，刚恢复的协程还在缓存里）
+// - 其他线程从顶部 steal（FIFO，偷走最老的任务）
+//
+// 实现参考 "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (Lê, Pop, Cohen, Nardelli, PPoPP 2013) 的 C11 版本。
+//
+// 限制：
+// - T 必须是可平凡复制的小对象（例如 std::coroutine_handle<>、指针）
+// - push / pop 只能由所有者线程调用，steal 可由任意线程调用
+// =============================================================================
+
+template <typename T>
+class WorkStealingQueue {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "WorkStealingQueue<T> requires a trivially copyable T");
+
+public:
+    explicit WorkStealingQueue(size_t initial_capacity = 256)
+        : top_(0), bottom_(0) {
+        // 容量向上取整到 2 的幂，便于用掩码取模
+        size_t capacity = 1;
+        while (capacity < initial_capacity) {
+            capacity <<= 1;
+        }
+        auto buffer = std::make_unique<Buffer>(capacity);
+        buffer_.store(buffer.get(), std::memory_order_relaxed);
+        buffers_.push_back(std::move(buffer));
+    }
+
+    // 禁止拷贝
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+    // 所有者线程：压入底部
+    void push(T item) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+        if (b - t > static_cast<int64_t>(buffer->capacity) - 1) {
+            buffer = grow(buffer, t, b);
+        }
+
+        buffer->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // 所有者线程：从底部弹出（LIFO）
+    std::optional<T> pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // 队列为空，恢复 bottom
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        T item = buffer->get(b);
+        if (t == b) {
+            // 最后一个元素，和窃取者竞争
+            if (!top_.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;  // 被偷走了
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // 任意线程：从顶部窃取（FIFO）
+    // 返回 nullopt 表示队列为空或与其他窃取者竞争失败
+    std::optional<T> steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return std::nullopt;
+        }
+
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        T item = buffer->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    // 近似大小（并发情况下仅供参考）
+    size_t size() const noexcept {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // 当前缓冲区容量
+    size_t capacity() const noexcept {
+        return buffer_.load(std::memory_order_relaxed)->capacity;
+    }
+
+private:
+    // 环形缓冲区，元素以原子方式读写（窃取者可能与所有者并发访问同一槽位）
+    struct Buffer {
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Buffer(size_t cap)
+            : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+        T get(int64_t index) const noexcept {
+            return slots[static_cast<size_t>(index) & mask].load(
+                std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item) noexcept {
+            slots[static_cast<size_t>(index) & mask].store(
+                item, std::memory_order_relaxed);
+        }
+    };
+
+    // 容量翻倍。旧缓冲区不能立即释放（窃取者可能还在读），
+    // 保留到队列析构，扩容只发生 O(log n) 次
+    Buffer* grow(Buffer* old, int64_t top, int64_t bottom) {
+        auto bigger = std::make_unique<Buffer>(old->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Buffer* raw = bigger.get();
+        buffers_.push_back(std::move(bigger));
+        buffer_.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+private:
+    // top_ 和 bottom_ 分别被窃取者和所有者频繁修改，放在不同的缓存行
+    alignas(64) std::atomic<int64_t> top_;
+    alignas(64) std::atomic<int64_t> bottom_;
+    alignas(64) std::atomic<Buffer*> buffer_;
+    std::vector<std::unique_ptr<Buffer>> buffers_;  // 所有分配过的缓冲区（仅所有者访问）
+};
+
+} // namespace zlcoro
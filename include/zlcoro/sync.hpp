@@ -0,0 +1,9 @@
+#pragma once
+
+// 协程同步原语
+
+#include "sync/async_mutex.hpp"
+#include "sync/async_semaphore.hpp"
+#include "sync/async_event.hpp"
+#include "sync/async_latch.hpp"
+#include "sync/channel.hpp"
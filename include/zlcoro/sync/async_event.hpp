@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+
+namespace zlcoro {
+
+// =============================================================================
+// AsyncManualResetEvent - 协程手动重置事件
+// =============================================================================
+//
+// co_await event 在事件未设置时挂起协程；set() 恢复所有等待者，之后的
+// co_await 直接通过，直到 reset()。
+// - 无锁：state_ 为 this（已设置）、nullptr（未设置、无等待者），或者指向
+//   等待者栈顶（节点是 Awaiter 本身，不需要堆分配）
+// - 等待者在调用 set() 的线程中同步恢复
+//
+// 使用方式:
+//   AsyncManualResetEvent ready;
+//   Task<void> consumer() { co_await ready; ... }
+//   void producer() { ...; ready.set(); }
+// =============================================================================
+
+class AsyncManualResetEvent {
+public:
+    explicit AsyncManualResetEvent(bool initially_set = false) noexcept
+        : state_(initially_set ? static_cast<void*>(this) : nullptr) {}
+
+    AsyncManualResetEvent(const AsyncManualResetEvent&) = delete;
+    AsyncManualResetEvent& operator=(const AsyncManualResetEvent&) = delete;
+
+    class Awaiter {
+    public:
+        explicit Awaiter(const AsyncManualResetEvent& event) noexcept : event_(event) {}
+
+        bool await_ready() const noexcept {
+            return event_.is_set();
+        }
+
+        // 返回 false 表示入栈前事件已经被设置
+        bool await_suspend(std::coroutine_handle<> coro) noexcept {
+            coro_ = coro;
+            const void* set_state = &event_;
+            void* old_state = event_.state_.load(std::memory_order_acquire);
+            do {
+                if (old_state == set_state) {
+                    return false;
+                }
+                next_ = static_cast<Awaiter*>(old_state);
+            } while (!event_.state_.compare_exchange_weak(old_state, this,
+                                                          std::memory_order_release,
+                                                          std::memory_order_acquire));
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        friend class AsyncManualResetEvent;
+
+        const AsyncManualResetEvent& event_;
+        std::coroutine_handle<> coro_;
+        Awaiter* next_ = nullptr;
+    };
+
+    Awaiter operator co_await() const noexcept {
+        return Awaiter{*this};
+    }
+
+    bool is_set() const noexcept {
+        return state_.load(std::memory_order_acquire) == this;
+    }
+
+    // 设置事件并恢复所有等待者
+    void set() noexcept {
+        void* old_state = state_.exchange(this, std::memory_order_acq_rel);
+        if (old_state == this) {
+            return;  // 已经设置过
+        }
+        auto* waiter = static_cast<Awaiter*>(old_state);
+        while (waiter) {
+            Awaiter* next = waiter->next_;  // 恢复后节点可能已失效
+            waiter->coro_.resume();
+            waiter = next;
+        }
+    }
+
+    // 重置为未设置（不影响已经恢复的等待者）
+    void reset() noexcept {
+        void* old_state = this;
+        state_.compare_exchange_strong(old_state, nullptr, std::memory_order_relaxed);
+    }
+
+private:
+    // 已设置时指向 this；co_await 是 const 操作，但要修改等待者栈
+    mutable std::atomic<void*> state_;
+};
+
+} // namespace zlcoro
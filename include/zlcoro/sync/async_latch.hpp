@@ -0,0 +1,51 @@
+#pragma once
+
+#include "async_event.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace zlcoro {
+
+// =============================================================================
+// AsyncLatch - 协程门闩（一次性倒计数）
+// =============================================================================
+//
+// 计数减到 0 时恢复所有等待者，之后的 co_await 直接通过。
+// 等待者在把计数减到 0 的 count_down() 调用所在线程中恢复。
+//
+// 使用方式:
+//   AsyncLatch done(n);
+//   // n 个任务各自在结束时调用 done.count_down()
+//   co_await done;
+// =============================================================================
+
+class AsyncLatch {
+public:
+    explicit AsyncLatch(std::ptrdiff_t count) noexcept
+        : count_(count), event_(count <= 0) {}
+
+    AsyncLatch(const AsyncLatch&) = delete;
+    AsyncLatch& operator=(const AsyncLatch&) = delete;
+
+    // 计数减 n，减到 0 时恢复所有等待者
+    void count_down(std::ptrdiff_t n = 1) noexcept {
+        if (count_.fetch_sub(n, std::memory_order_acq_rel) - n <= 0) {
+            event_.set();
+        }
+    }
+
+    bool is_ready() const noexcept {
+        return event_.is_set();
+    }
+
+    AsyncManualResetEvent::Awaiter operator co_await() const noexcept {
+        return event_.operator co_await();
+    }
+
+private:
+    std::atomic<std::ptrdiff_t> count_;
+    AsyncManualResetEvent event_;
+};
+
+} // namespace zlcoro
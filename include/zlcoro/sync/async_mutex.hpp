@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <utility>
+
+namespace zlcoro {
+
+class AsyncMutex;
+
+// =============================================================================
+// AsyncMutexLock - AsyncMutex 的 RAII 锁（析构时解锁）
+// =============================================================================
+
+class AsyncMutexLock {
+public:
+    explicit AsyncMutexLock(AsyncMutex& mutex, std::adopt_lock_t) noexcept : mutex_(&mutex) {}
+
+    AsyncMutexLock(const AsyncMutexLock&) = delete;
+    AsyncMutexLock& operator=(const AsyncMutexLock&) = delete;
+
+    AsyncMutexLock(AsyncMutexLock&& other) noexcept
+        : mutex_(std::exchange(other.mutex_, nullptr)) {}
+
+    AsyncMutexLock& operator=(AsyncMutexLock&& other) noexcept;
+
+    ~AsyncMutexLock();
+
+    // 提前解锁
+    void unlock() noexcept;
+
+private:
+    AsyncMutex* mutex_;
+};
+
+// =============================================================================
+// AsyncMutex - 协程互斥锁
+// =============================================================================
+//
+// co_await lock() 在锁被占用时挂起协程而不是阻塞线程。
+// - 等待者链表无锁：state_ 为 not_locked、locked_no_waiters，或者指向
+//   新等待者组成的栈（LIFO）
+// - unlock 时持有者把新等待者栈反转后接到自己的 FIFO 队列，按到达顺序把锁
+//   直接交给队首（FIFO 交接，锁不会被后来者插队）
+// - 等待者节点就是 Awaiter 本身（位于等待协程的帧中），不需要堆分配
+// - 被交接的协程在调用 unlock() 的线程中同步恢复
+//
+// 使用方式:
+//   AsyncMutex mutex;
+//   Task<void> work() {
+//       auto lock = co_await mutex.scoped_lock();
+//       // 临界区（可以 co_await）
+//   }
+// =============================================================================
+
+class AsyncMutex {
+public:
+    AsyncMutex() noexcept : state_(not_locked), waiters_(nullptr) {}
+
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+    // 等待者节点 / co_await lock() 的 Awaiter
+    class LockAwaiter {
+    public:
+        explicit LockAwaiter(AsyncMutex& mutex) noexcept : mutex_(mutex) {}
+
+        bool await_ready() noexcept {
+            return mutex_.try_lock();
+        }
+
+        // 返回 false 表示挂起前已经拿到锁
+        bool await_suspend(std::coroutine_handle<> coro) noexcept {
+            coro_ = coro;
+            uintptr_t old_state = mutex_.state_.load(std::memory_order_acquire);
+            while (true) {
+                if (old_state == not_locked) {
+                    if (mutex_.state_.compare_exchange_weak(old_state, locked_no_waiters,
+                                                            std::memory_order_acquire,
+                                                            std::memory_order_relaxed)) {
+                        return false;
+                    }
+                } else {
+                    // 压入新等待者栈
+                    next_ = old_state == locked_no_waiters
+                                ? nullptr
+                                : reinterpret_cast<LockAwaiter*>(old_state);
+                    if (mutex_.state_.compare_exchange_weak(old_state,
+                                                            reinterpret_cast<uintptr_t>(this),
+                                                            std::memory_order_release,
+                                                            std::memory_order_relaxed)) {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        void await_resume() noexcept {}
+
+    protected:
+        friend class AsyncMutex;
+
+        AsyncMutex& mutex_;
+        std::coroutine_handle<> coro_;
+        LockAwaiter* next_ = nullptr;
+    };
+
+    // co_await scoped_lock() 的 Awaiter：结果为 AsyncMutexLock
+    class ScopedLockAwaiter : public LockAwaiter {
+    public:
+        using LockAwaiter::LockAwaiter;
+
+        [[nodiscard]] AsyncMutexLock await_resume() noexcept {
+            return AsyncMutexLock(mutex_, std::adopt_lock);
+        }
+    };
+
+    // 尝试加锁（不挂起）
+    bool try_lock() noexcept {
+        uintptr_t expected = not_locked;
+        return state_.compare_exchange_strong(expected, locked_no_waiters,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    // co_await lock()：获得锁后恢复，需要手动 unlock()
+    [[nodiscard]] LockAwaiter lock() noexcept {
+        return LockAwaiter{*this};
+    }
+
+    // co_await scoped_lock()：返回析构时自动解锁的 AsyncMutexLock
+    [[nodiscard]] ScopedLockAwaiter scoped_lock() noexcept {
+        return ScopedLockAwaiter{*this};
+    }
+
+    // 解锁：有等待者时把锁交给最早的等待者，并在当前线程中恢复它
+    void unlock() noexcept {
+        LockAwaiter* head = waiters_;
+        if (head == nullptr) {
+            uintptr_t old_state = locked_no_waiters;
+            if (state_.compare_exchange_strong(old_state, not_locked,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+                return;  // 没有等待者
+            }
+
+            // 取走新等待者栈，按到达顺序反转成 FIFO 队列
+            old_state = state_.exchange(locked_no_waiters, std::memory_order_acquire);
+            auto* node = reinterpret_cast<LockAwaiter*>(old_state);
+            while (node != nullptr) {
+                LockAwaiter* next = node->next_;
+                node->next_ = head;
+                head = node;
+                node = next;
+            }
+        }
+
+        // 锁保持在加锁状态，直接交给队首
+        waiters_ = head->next_;
+        head->coro_.resume();
+    }
+
+private:
+    static constexpr uintptr_t not_locked = 1;
+    static constexpr uintptr_t locked_no_waiters = 0;
+
+    std::atomic<uintptr_t> state_;   // not_locked / locked_no_waiters / 新等待者栈顶
+    LockAwaiter* waiters_;            // 持有者独占的 FIFO 等待队列
+};
+
+inline AsyncMutexLock& AsyncMutexLock::operator=(AsyncMutexLock&& other) noexcept {
+    if (this != &other) {
+        unlock();
+        mutex_ = std::exchange(other.mutex_, nullptr);
+    }
+    return *this;
+}
+
+inline AsyncMutexLock::~AsyncMutexLock() {
+    unlock();
+}
+
+inline void AsyncMutexLock::unlock() noexcept {
+    if (mutex_) {
+        std::exchange(mutex_, nullptr)->unlock();
+    }
+}
+
+} // namespace zlcoro
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace zlcoro {
+
+// =============================================================================
+// AsyncSemaphore - 协程计数信号量
+// =============================================================================
+//
+// co_await acquire() 在没有可用许可时挂起协程而不是阻塞线程。
+// - 快速路径：许可数大于 0 时用一次 CAS 取走许可，不加锁
+// - 慢速路径：等待者按 FIFO 排队（节点是 Awaiter 本身，不需要堆分配），
+//   队列由一个短临界区的 std::mutex 保护，只在许可耗尽时才会用到
+// - release 时优先把许可直接交给队首等待者，并在当前线程中恢复它
+//
+// 使用方式:
+//   AsyncSemaphore slots(8);            // 最多 8 个并发请求
+//   Task<void> call_backend() {
+//       co_await slots.acquire();
+//       ...
+//       slots.release();
+//   }
+// =============================================================================
+
+class AsyncSemaphore {
+public:
+    explicit AsyncSemaphore(std::size_t initial_count = 0) noexcept
+        : count_(static_cast<int64_t>(initial_count)) {}
+
+    AsyncSemaphore(const AsyncSemaphore&) = delete;
+    AsyncSemaphore& operator=(const AsyncSemaphore&) = delete;
+
+    class AcquireAwaiter {
+    public:
+        explicit AcquireAwaiter(AsyncSemaphore& semaphore) noexcept : semaphore_(semaphore) {}
+
+        bool await_ready() noexcept {
+            return semaphore_.try_acquire();
+        }
+
+        // 返回 false 表示入队前已经拿到许可
+        bool await_suspend(std::coroutine_handle<> coro) {
+            coro_ = coro;
+            std::lock_guard<std::mutex> lock(semaphore_.mutex_);
+            if (semaphore_.try_acquire()) {
+                return false;
+            }
+            if (semaphore_.tail_) {
+                semaphore_.tail_->next_ = this;
+            } else {
+                semaphore_.head_ = this;
+            }
+            semaphore_.tail_ = this;
+            return true;
+        }
+
+        void await_resume() noexcept {}
+
+    private:
+        friend class AsyncSemaphore;
+
+        AsyncSemaphore& semaphore_;
+        std::coroutine_handle<> coro_;
+        AcquireAwaiter* next_ = nullptr;
+    };
+
+    // 尝试取一个许可（不挂起）
+    bool try_acquire() noexcept {
+        int64_t count = count_.load(std::memory_order_acquire);
+        while (count > 0) {
+            if (count_.compare_exchange_weak(count, count - 1, std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // co_await acquire()：取得一个许可后恢复
+    [[nodiscard]] AcquireAwaiter acquire() noexcept {
+        return AcquireAwaiter{*this};
+    }
+
+    // 归还 n 个许可：先交给排队的等待者，剩余的加回计数
+    void release(std::size_t n = 1) {
+        AcquireAwaiter* resumed = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            AcquireAwaiter** link = &resumed;
+            while (n > 0 && head_) {
+                AcquireAwaiter* waiter = head_;
+                head_ = waiter->next_;
+                if (!head_) {
+                    tail_ = nullptr;
+                }
+                waiter->next_ = nullptr;
+                *link = waiter;
+                link = &waiter->next_;
+                --n;
+            }
+            // 在锁内增加计数：与 await_suspend 中的检查互斥，不会漏掉等待者
+            if (n > 0) {
+                count_.fetch_add(static_cast<int64_t>(n), std::memory_order_release);
+            }
+        }
+
+        // 在锁外恢复（被恢复的协程可能再次 acquire / release）
+        while (resumed) {
+            AcquireAwaiter* next = resumed->next_;
+            resumed->coro_.resume();
+            resumed = next;
+        }
+    }
+
+    // 当前可用的许可数（近似值）
+    std::size_t available() const noexcept {
+        int64_t count = count_.load(std::memory_order_relaxed);
+        return count > 0 ? static_cast<std::size_t>(count) : 0;
+    }
+
+private:
+    std::atomic<int64_t> count_;       // 可用许可数
+    std::mutex mutex_;                 // 保护等待队列
+    AcquireAwaiter* head_ = nullptr;   // FIFO 等待队列
+    AcquireAwaiter* tail_ = nullptr;
+};
+
+} // namespace zlcoro
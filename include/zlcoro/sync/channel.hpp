@@ -0,0 +1,416 @@
+#pragma once
+
+#include "zlcoro/io/event_loop.hpp"
+#include "zlcoro/scheduler/mpmc_queue.hpp"
+#include "zlcoro/scheduler/scheduler.hpp"
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace zlcoro {
+
+// =============================================================================
+// Channel<T> - 有界多生产者多消费者协程通道
+// =============================================================================
+//
+// 用于在事件循环和工作线程之间搭建流水线：
+// - 缓冲区是无锁环形队列（BoundedMpmcQueue），容量向上取整到 2 的幂；
+//   环形队列至少需要 2 个槽位，容量小于 2 时构造抛出 std::invalid_argument
+// - try_send / try_recv / try_recv_batch 永远不挂起，缓冲区有空位/元素时
+//   不加锁
+// - send 在缓冲区满时挂起发送者（背压），recv / recv_batch 在缓冲区空时
+//   挂起接收者；等待者节点就是 Awaiter 本身，不需要堆分配
+// - 等待队列由一个短临界区的 std::mutex 保护，只在需要挂起或唤醒时使用
+// - 被唤醒的协程回到它挂起时所在的 EventLoop（通过 EventLoop::schedule），
+//   不在事件循环中挂起的协程交给 Scheduler
+//
+// close() 之后 send 返回 false；接收者先取完缓冲区中剩余的元素，
+// 之后 recv 返回 std::nullopt，recv_batch 返回 0。
+//
+// 使用方式:
+//   Channel<Request> requests(256);
+//
+//   // 生产者（例如事件循环中的连接协程）
+//   co_await requests.send(std::move(req));
+//
+//   // 消费者（工作线程）
+//   std::array<Request, 32> batch;
+//   while (size_t n = co_await requests.recv_batch(batch)) {
+//       handle(std::span(batch).first(n));
+//   }
+//
+// 注意：
+// - 挂起的等待者按 FIFO 顺序被满足，但不挂起的 try_* 调用可能先于它们
+//   取得空位/元素
+// - 销毁 Channel 之前必须保证没有挂起的等待者
+// =============================================================================
+
+template <typename T>
+class Channel {
+public:
+    explicit Channel(size_t capacity) : buffer_(check_capacity(capacity)) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+private:
+    // 等待者公共部分：挂起的协程和恢复它的位置
+    struct Waiter {
+        std::coroutine_handle<> coro;
+        EventLoop* loop = nullptr;
+        Waiter* next = nullptr;
+
+        void resume() {
+            if (loop) {
+                loop->schedule(coro);
+            } else {
+                Scheduler::instance().schedule(coro);
+            }
+        }
+    };
+
+    // 侵入式 FIFO 等待队列
+    struct WaiterList {
+        Waiter* head = nullptr;
+        Waiter* tail = nullptr;
+
+        void push(Waiter* waiter) noexcept {
+            waiter->next = nullptr;
+            if (tail) {
+                tail->next = waiter;
+            } else {
+                head = waiter;
+            }
+            tail = waiter;
+        }
+
+        Waiter* pop() noexcept {
+            Waiter* waiter = head;
+            head = waiter->next;
+            if (!head) {
+                tail = nullptr;
+            }
+            waiter->next = nullptr;
+            return waiter;
+        }
+
+        bool empty() const noexcept {
+            return head == nullptr;
+        }
+    };
+
+    struct SendWaiter : Waiter {
+        T* value = nullptr;      // 待发送的元素（位于 SendAwaiter 中）
+        bool sent = false;
+    };
+
+    struct RecvWaiter : Waiter {
+        std::optional<T> value;  // 交付给接收者的元素；关闭时为空
+    };
+
+public:
+    // =========================================================================
+    // co_await send(value)：缓冲区满时挂起，返回 false 表示通道已关闭
+    // =========================================================================
+
+    class SendAwaiter {
+    public:
+        SendAwaiter(Channel& channel, T value)
+            : channel_(channel), value_(std::move(value)) {}
+
+        bool await_ready() {
+            if (channel_.is_closed()) {
+                return true;
+            }
+            waiter_.sent = channel_.try_send(std::move(value_));
+            return waiter_.sent;
+        }
+
+        bool await_suspend(std::coroutine_handle<> coro) {
+            waiter_.coro = coro;
+            waiter_.loop = EventLoop::current();
+            waiter_.value = &value_;
+            return channel_.suspend_sender(&waiter_);
+        }
+
+        bool await_resume() const noexcept {
+            return waiter_.sent;
+        }
+
+    private:
+        Channel& channel_;
+        T value_;
+        SendWaiter waiter_;
+    };
+
+    // =========================================================================
+    // co_await recv()：缓冲区空时挂起，通道关闭且取完后返回 std::nullopt
+    // =========================================================================
+
+    class RecvAwaiter {
+    public:
+        explicit RecvAwaiter(Channel& channel) noexcept : channel_(channel) {}
+
+        bool await_ready() {
+            waiter_.value = channel_.try_recv();
+            return waiter_.value.has_value();
+        }
+
+        bool await_suspend(std::coroutine_handle<> coro) {
+            waiter_.coro = coro;
+            waiter_.loop = EventLoop::current();
+            return channel_.suspend_receiver(&waiter_);
+        }
+
+        std::optional<T> await_resume() {
+            return std::move(waiter_.value);
+        }
+
+    private:
+        Channel& channel_;
+        RecvWaiter waiter_;
+    };
+
+    // =========================================================================
+    // co_await recv_batch(out)：至少取到一个元素后恢复，一次尽量填满 out
+    // =========================================================================
+    //
+    // 返回写入 out 的元素个数；通道关闭且取完后返回 0。
+
+    class RecvBatchAwaiter {
+    public:
+        RecvBatchAwaiter(Channel& channel, std::span<T> out) noexcept
+            : channel_(channel), out_(out) {}
+
+        bool await_ready() {
+            if (out_.empty()) {
+                return true;
+            }
+            count_ = channel_.try_recv_batch(out_);
+            return count_ > 0;
+        }
+
+        bool await_suspend(std::coroutine_handle<> coro) {
+            waiter_.coro = coro;
+            waiter_.loop = EventLoop::current();
+            return channel_.suspend_receiver(&waiter_);
+        }
+
+        size_t await_resume() {
+            if (count_ == 0 && waiter_.value) {
+                // 挂起期间交付的第一个元素，其余的直接从缓冲区取
+                out_[0] = std::move(*waiter_.value);
+                count_ = 1 + channel_.try_recv_batch(out_.subspan(1));
+            }
+            return count_;
+        }
+
+    private:
+        Channel& channel_;
+        std::span<T> out_;
+        size_t count_ = 0;
+        RecvWaiter waiter_;
+    };
+
+    // 尝试发送（不挂起）：缓冲区满或通道已关闭时返回 false，value 保持不变
+    template <typename U>
+    bool try_send(U&& value) {
+        if (is_closed() || !buffer_.try_push(std::forward<U>(value))) {
+            return false;
+        }
+        notify(receivers_waiting_);
+        return true;
+    }
+
+    // 尝试接收（不挂起）
+    std::optional<T> try_recv() {
+        std::optional<T> value = buffer_.try_pop();
+        if (value) {
+            notify(senders_waiting_);
+        }
+        return value;
+    }
+
+    // 尝试批量接收（不挂起），返回写入 out 的元素个数
+    size_t try_recv_batch(std::span<T> out) {
+        size_t count = 0;
+        while (count < out.size()) {
+            std::optional<T> value = buffer_.try_pop();
+            if (!value) {
+                break;
+            }
+            out[count++] = std::move(*value);
+        }
+        if (count > 0) {
+            notify(senders_waiting_);
+        }
+        return count;
+    }
+
+    [[nodiscard]] SendAwaiter send(T value) {
+        return SendAwaiter{*this, std::move(value)};
+    }
+
+    [[nodiscard]] RecvAwaiter recv() noexcept {
+        return RecvAwaiter{*this};
+    }
+
+    [[nodiscard]] RecvBatchAwaiter recv_batch(std::span<T> out) noexcept {
+        return RecvBatchAwaiter{*this, out};
+    }
+
+    // 关闭通道：唤醒所有等待者（发送者得到 false，空手的接收者得到 nullopt）
+    void close() {
+        WaiterList woken;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+            transfer_locked(woken);
+            while (!receivers_.empty()) {
+                receivers_waiting_.fetch_sub(1, std::memory_order_relaxed);
+                woken.push(receivers_.pop());
+            }
+            while (!senders_.empty()) {
+                senders_waiting_.fetch_sub(1, std::memory_order_relaxed);
+                woken.push(senders_.pop());
+            }
+        }
+        resume_all(woken, nullptr);
+    }
+
+    bool is_closed() const noexcept {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept {
+        return buffer_.capacity();
+    }
+
+    // 缓冲区中的元素数（并发情况下仅供参考）
+    size_t size_approx() const noexcept {
+        return buffer_.size_approx();
+    }
+
+private:
+    static size_t check_capacity(size_t capacity) {
+        // capacity 为 1 时队列实际会缓冲 2 个元素，背压上限与请求的不符
+        if (capacity < 2) {
+            throw std::invalid_argument("Channel capacity must be at least 2");
+        }
+        return capacity;
+    }
+
+    // 快速路径之后检查对端是否有等待者。
+    // 与 suspend_* 中"先登记等待者，再检查缓冲区"配对（两侧都有 seq_cst 栅栏）：
+    // 要么等待者看到新的元素/空位，要么这里看到等待者，不会丢失唤醒
+    void notify(std::atomic<size_t>& waiting) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        WaiterList woken;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            transfer_locked(woken);
+        }
+        resume_all(woken, nullptr);
+    }
+
+    // 返回 true 表示发送者需要挂起
+    bool suspend_sender(SendWaiter* self) {
+        WaiterList woken;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (is_closed()) {
+                return false;
+            }
+            senders_.push(self);
+            senders_waiting_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            transfer_locked(woken);
+        }
+        return !resume_all(woken, self);
+    }
+
+    // 返回 true 表示接收者需要挂起
+    bool suspend_receiver(RecvWaiter* self) {
+        WaiterList woken;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (is_closed()) {
+                self->value = buffer_.try_pop();  // 关闭后只取剩余元素
+                return false;
+            }
+            receivers_.push(self);
+            receivers_waiting_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            transfer_locked(woken);
+        }
+        return !resume_all(woken, self);
+    }
+
+    // 在锁内让等待者和缓冲区互相满足：把元素交给排队的接收者，
+    // 把排队的发送者的元素放入腾出的空位，直到双方都无法推进
+    void transfer_locked(WaiterList& woken) {
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            while (!receivers_.empty()) {
+                std::optional<T> value = buffer_.try_pop();
+                if (!value) {
+                    break;
+                }
+                auto* receiver = static_cast<RecvWaiter*>(receivers_.pop());
+                receivers_waiting_.fetch_sub(1, std::memory_order_relaxed);
+                receiver->value = std::move(value);
+                woken.push(receiver);
+                progress = true;
+            }
+            while (!senders_.empty()) {
+                auto* sender = static_cast<SendWaiter*>(senders_.head);
+                if (!buffer_.try_push(std::move(*sender->value))) {
+                    break;
+                }
+                senders_.pop();
+                senders_waiting_.fetch_sub(1, std::memory_order_relaxed);
+                sender->sent = true;
+                woken.push(sender);
+                progress = true;
+            }
+        }
+    }
+
+    // 在锁外恢复被唤醒的等待者；self 是正在挂起的协程，
+    // 它已经被满足时不调度，返回 true 让 await_suspend 直接继续执行
+    static bool resume_all(WaiterList& woken, Waiter* self) {
+        bool self_woken = false;
+        while (!woken.empty()) {
+            Waiter* waiter = woken.pop();
+            if (waiter == self) {
+                self_woken = true;
+            } else {
+                waiter->resume();
+            }
+        }
+        return self_woken;
+    }
+
+private:
+    BoundedMpmcQueue<T> buffer_;                 // 元素缓冲区（无锁）
+    std::atomic<bool> closed_{false};
+    std::atomic<size_t> senders_waiting_{0};     // 快速路径用来判断是否需要唤醒
+    std::atomic<size_t> receivers_waiting_{0};
+
+    std::mutex mutex_;                           // 保护以下等待队列
+    WaiterList senders_;
+    WaiterList receivers_;
+};
+
+} // namespace zlcoro
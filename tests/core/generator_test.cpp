@@ -1,7 +1,14 @@
 #include "zlcoro/core/generator.hpp"
+#include "zlcoro/core/async_generator.hpp"
+#include "zlcoro/core/chunked_generator.hpp"
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/scheduler/async.hpp"
+#include "zlcoro/scheduler/scheduler.hpp"
 #include <gtest/gtest.h>
+#include <array>
 #include <vector>
 #include <string>
+#include <thread>
 
 using namespace zlcoro;
 
@@ -349,3 +356,208 @@ TEST(GeneratorTest, ManualIteration) {
     ++it;
     EXPECT_EQ(it, end);  // 迭代结束
 }
+
+// =============================================================================
+// 协程帧分配测试
+// =============================================================================
+
+Generator<int> arena_range(std::allocator_arg_t, ArenaAllocator<std::byte>, int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+// 测试 17: Generator 的帧从 allocator_arg 传入的 arena 分配
+TEST(GeneratorTest, ArenaAllocatedFrame) {
+    FrameArena arena;
+
+    std::vector<int> result;
+    for (int x : arena_range(std::allocator_arg, arena.allocator(), 4)) {
+        result.push_back(x);
+    }
+
+    EXPECT_EQ(result, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_GT(arena.bytes_used(), 0u);
+}
+
+// =============================================================================
+// AsyncGenerator 测试
+// =============================================================================
+
+// 测试 18: co_await next() 逐个取值
+TEST(AsyncGeneratorTest, NextYieldsInOrder) {
+    auto gen = []() -> AsyncGenerator<int> {
+        for (int i = 0; i < 5; ++i) {
+            co_yield i;
+        }
+    };
+    auto consume = [&]() -> Task<std::vector<int>> {
+        std::vector<int> result;
+        auto g = gen();
+        while (int* value = co_await g.next()) {
+            result.push_back(*value);
+        }
+        EXPECT_TRUE(g.done());
+        co_return result;
+    };
+
+    EXPECT_EQ(consume().sync_wait(), (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+// 测试 19: 生成器体内 co_await，迭代器形式遍历，消费者可以移动走值
+TEST(AsyncGeneratorTest, BodyCanAwait) {
+    std::thread::id consumer_thread;
+    auto gen = []() -> AsyncGenerator<std::string> {
+        for (int i = 0; i < 3; ++i) {
+            co_await schedule();  // 切换到调度器的工作线程
+            co_yield "item" + std::to_string(i);
+        }
+    };
+    auto consume = [&]() -> Task<std::vector<std::string>> {
+        std::vector<std::string> result;
+        auto g = gen();
+        for (auto it = co_await g.begin(); it != g.end(); co_await ++it) {
+            result.push_back(std::move(*it));
+        }
+        consumer_thread = std::this_thread::get_id();
+        co_return result;
+    };
+
+    auto result = async_run(consume()).get();
+    EXPECT_EQ(result, (std::vector<std::string>{"item0", "item1", "item2"}));
+    EXPECT_NE(consumer_thread, std::this_thread::get_id());
+}
+
+// 测试 20: 生成器体内的异常在消费者处抛出
+TEST(AsyncGeneratorTest, ExceptionPropagates) {
+    auto gen = []() -> AsyncGenerator<int> {
+        co_yield 1;
+        throw std::runtime_error("broken stream");
+    };
+    auto consume = [&]() -> Task<int> {
+        auto g = gen();
+        int sum = 0;
+        try {
+            while (int* value = co_await g.next()) {
+                sum += *value;
+            }
+        } catch (const std::runtime_error&) {
+            sum += 100;
+        }
+        co_return sum;
+    };
+
+    EXPECT_EQ(consume().sync_wait(), 101);
+}
+
+// 测试 21: 提前停止迭代，生成器帧中的局部对象被正确析构
+TEST(AsyncGeneratorTest, EarlyDestruction) {
+    auto guard = std::make_shared<int>(0);
+    auto gen = [](std::shared_ptr<int>) -> AsyncGenerator<int> {
+        for (int i = 0;; ++i) {
+            co_yield i;
+        }
+    };
+    auto consume = [&]() -> Task<int> {
+        auto g = gen(guard);
+        int last = -1;
+        while (int* value = co_await g.next()) {
+            last = *value;
+            if (last == 3) {
+                break;
+            }
+        }
+        co_return last;
+    };
+
+    EXPECT_EQ(consume().sync_wait(), 3);
+    EXPECT_EQ(guard.use_count(), 1);
+}
+
+// =============================================================================
+// ChunkedGenerator 测试
+// =============================================================================
+
+ChunkedGenerator<int, 4> chunked_iota(int n, int* resumes = nullptr) {
+    for (int i = 0; i < n; ++i) {
+        if (resumes && i % 4 == 0) {
+            ++*resumes;  // 每个块开始时计数
+        }
+        co_yield i;
+    }
+}
+
+// 测试 22: 逐元素迭代跨越块边界
+TEST(ChunkedGeneratorTest, ElementIteration) {
+    std::vector<int> result;
+    for (int x : chunked_iota(10)) {
+        result.push_back(x);
+    }
+    EXPECT_EQ(result, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    int count = 0;
+    for (int x : chunked_iota(0)) {
+        count += x + 1;
+    }
+    EXPECT_EQ(count, 0);
+}
+
+// 测试 23: 按块消费，最后一块可以不满
+TEST(ChunkedGeneratorTest, ChunkSizes) {
+    std::vector<size_t> sizes;
+    chunked_iota(10).for_each_chunk([&](std::span<const int> chunk) {
+        sizes.push_back(chunk.size());
+        return true;
+    });
+    EXPECT_EQ(sizes, (std::vector<size_t>{4, 4, 2}));
+}
+
+// 测试 24: transform / filter / take 在块上融合
+TEST(ChunkedGeneratorTest, FusedAdaptors) {
+    int resumes = 0;
+    auto result = chunked_iota(1000, &resumes)
+                      .transform([](int x) { return x * 2; })
+                      .filter([](int x) { return x % 3 == 0; })
+                      .take(5)
+                      .to_vector();
+
+    EXPECT_EQ(result, (std::vector<int>{0, 6, 12, 18, 24}));
+    // 前 13 个元素已经足够，take 之后不再恢复上游（4 个块）
+    EXPECT_EQ(resumes, 4);
+
+    auto sum = chunked_iota(100).reduce(int64_t{0}, [](int64_t acc, int x) { return acc + x; });
+    EXPECT_EQ(sum, 4950);
+}
+
+// 测试 25: 生成器体内的异常在消费者处抛出
+TEST(ChunkedGeneratorTest, ExceptionPropagates) {
+    auto gen = []() -> ChunkedGenerator<int, 4> {
+        co_yield 1;
+        throw std::runtime_error("bad chunk");
+    };
+    EXPECT_THROW(gen().to_vector(), std::runtime_error);
+}
+
+// 测试 26: co_yield span 整块产生，与单个值混合时保持顺序
+TEST(ChunkedGeneratorTest, SpanYield) {
+    auto gen = []() -> ChunkedGenerator<int, 4> {
+        co_yield -1;
+        std::array<int, 10> block;
+        for (int i = 0; i < 10; ++i) {
+            block[i] = i;
+        }
+        co_yield std::span<const int>(block);
+        co_yield std::span<const int>();  // 空块被跳过
+        co_yield 10;
+    };
+
+    std::vector<size_t> sizes;
+    std::vector<int> values;
+    gen().for_each_chunk([&](std::span<const int> chunk) {
+        sizes.push_back(chunk.size());
+        values.insert(values.end(), chunk.begin(), chunk.end());
+        return true;
+    });
+    EXPECT_EQ(sizes, (std::vector<size_t>{1, 4, 4, 2, 1}));
+    EXPECT_EQ(values, (std::vector<int>{-1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+}
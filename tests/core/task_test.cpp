@@ -1,6 +1,13 @@
 #include "zlcoro/core/task.hpp"
+#include "zlcoro/core/inline_task.hpp"
+#include "zlcoro/core/shared_task.hpp"
+#include "zlcoro/core/single_flight.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <coroutine>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace zlcoro;
 
@@ -284,6 +291,274 @@ TEST(TaskTest, RecursiveCoroutine) {
     EXPECT_EQ(result, 120);  // 5! = 120
 }
 
+// ============================================================================
+// 协程帧分配测试
+// ============================================================================
+
+Task<int> arena_leaf(std::allocator_arg_t, ArenaAllocator<std::byte>, int value) {
+    co_return value + 1;
+}
+
+Task<int> arena_root(std::allocator_arg_t, ArenaAllocator<std::byte> alloc, int value) {
+    int a = co_await arena_leaf(std::allocator_arg, alloc, value);
+    int b = co_await arena_leaf(std::allocator_arg, alloc, a);
+    co_return b;
+}
+
+// 测试帧在同一线程上被复用
+TEST(TaskTest, FramePoolReusesFrames) {
+    if (!FramePool::enabled()) {
+        GTEST_SKIP() << "FramePool disabled in this build";
+    }
+
+    auto simple_task = [](int v) -> Task<int> {
+        co_return v;
+    };
+
+    void* first = nullptr;
+    {
+        auto task = simple_task(1);
+        first = task.handle().address();
+        EXPECT_EQ(task.sync_wait(), 1);
+    }
+    size_t cached = FramePool::cached_blocks();
+    EXPECT_GE(cached, 1u);
+
+    auto task = simple_task(2);
+    EXPECT_EQ(task.handle().address(), first);  // 刚释放的帧被重新使用
+    EXPECT_EQ(FramePool::cached_blocks(), cached - 1);
+    EXPECT_EQ(task.sync_wait(), 2);
+}
+
+// 测试通过 allocator_arg 传入 FrameArena
+TEST(TaskTest, ArenaAllocatedFrames) {
+    FrameArena arena;
+
+    {
+        auto task = arena_root(std::allocator_arg, arena.allocator(), 1);
+        EXPECT_EQ(task.sync_wait(), 3);
+    }
+
+    // 根协程和两个子协程的帧都来自 arena
+    EXPECT_GT(arena.bytes_used(), 0u);
+    size_t used = arena.bytes_used();
+
+    {
+        auto task = arena_leaf(std::allocator_arg, arena.allocator(), 10);
+        EXPECT_EQ(task.sync_wait(), 11);
+    }
+    EXPECT_GT(arena.bytes_used(), used);
+
+    arena.reset();
+    EXPECT_EQ(arena.bytes_used(), 0u);
+}
+
+// 测试标准分配器也可以通过 allocator_arg 使用
+TEST(TaskTest, StdAllocatorFrames) {
+    auto task = [](std::allocator_arg_t, std::allocator<char>, int v) -> Task<int> {
+        co_return v * 3;
+    }(std::allocator_arg, std::allocator<char>{}, 7);
+
+    EXPECT_EQ(task.sync_wait(), 21);
+}
+
+// ============================================================================
+// SharedTask / SingleFlight 测试
+// ============================================================================
+
+// 手动打开的挂起点：co_await gate.wait()，open() 恢复所有等待它的协程
+struct ManualGate {
+    struct Awaiter {
+        ManualGate* gate;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> coro) { gate->waiters.push_back(coro); }
+        void await_resume() const noexcept {}
+    };
+
+    std::vector<std::coroutine_handle<>> waiters;
+
+    Awaiter wait() noexcept {
+        return Awaiter{this};
+    }
+
+    void open() {
+        auto ready = std::move(waiters);
+        for (auto coro : ready) {
+            coro.resume();
+        }
+    }
+};
+
+// 测试多个等待者共享同一次执行，之后的等待不挂起
+TEST(SharedTaskTest, AwaitersShareOneExecution) {
+    ManualGate gate;
+    int runs = 0;
+    auto compute = [&]() -> SharedTask<int> {
+        ++runs;
+        co_await gate.wait();
+        co_return 42;
+    };
+    std::vector<int> results;
+    auto waiter = [&](SharedTask<int> shared) -> Task<void> {
+        results.push_back(co_await shared);
+    };
+
+    SharedTask<int> shared = compute();
+    EXPECT_EQ(runs, 0);  // 惰性启动
+
+    std::vector<Task<void>> waiters;
+    for (int i = 0; i < 3; ++i) {
+        waiters.push_back(waiter(shared));
+        waiters.back().handle().resume();
+    }
+    EXPECT_EQ(runs, 1);
+    EXPECT_TRUE(results.empty());
+    EXPECT_FALSE(shared.is_ready());
+
+    gate.open();
+    EXPECT_EQ(results, (std::vector<int>{42, 42, 42}));
+    EXPECT_TRUE(shared.is_ready());
+    for (auto& w : waiters) {
+        EXPECT_TRUE(w.handle().done());
+    }
+
+    auto late = waiter(shared);
+    late.handle().resume();
+    EXPECT_TRUE(late.handle().done());
+    EXPECT_EQ(results.size(), 4u);
+    EXPECT_EQ(runs, 1);
+}
+
+// 测试异常在每个等待者中重新抛出
+TEST(SharedTaskTest, ExceptionReachesEveryAwaiter) {
+    ManualGate gate;
+    auto fail = [&]() -> SharedTask<void> {
+        co_await gate.wait();
+        throw std::runtime_error("shared failure");
+    };
+    int caught = 0;
+    auto waiter = [&](SharedTask<void> shared) -> Task<void> {
+        try {
+            co_await shared;
+        } catch (const std::runtime_error&) {
+            ++caught;
+        }
+    };
+
+    SharedTask<void> shared = fail();
+    auto a = waiter(shared);
+    auto b = waiter(shared);
+    a.handle().resume();
+    b.handle().resume();
+    gate.open();
+
+    EXPECT_EQ(caught, 2);
+}
+
+// 测试同一个 key 的并发调用只执行一次，结束后再次调用会重新执行
+TEST(SingleFlightTest, MergesConcurrentCallsPerKey) {
+    SingleFlight<std::string, int> flights;
+    ManualGate gate;
+    int calls = 0;
+    auto fetch = [&](int value) -> Task<int> {
+        ++calls;
+        co_await gate.wait();
+        co_return value;
+    };
+    std::vector<int> results;
+    auto caller = [&](std::string key, int value) -> Task<void> {
+        results.push_back(co_await flights.run(key, [&] { return fetch(value); }));
+    };
+
+    std::vector<Task<void>> callers;
+    callers.push_back(caller("a", 1));
+    callers.push_back(caller("a", 2));  // 加入 "a" 进行中的调用
+    callers.push_back(caller("b", 3));
+    for (auto& c : callers) {
+        c.handle().resume();
+    }
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(flights.in_flight(), 2u);
+
+    gate.open();
+    std::sort(results.begin(), results.end());
+    EXPECT_EQ(results, (std::vector<int>{1, 1, 3}));
+    EXPECT_EQ(flights.in_flight(), 0u);
+
+    auto again = caller("a", 5);
+    again.handle().resume();
+    gate.open();
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(results.back(), 5);
+}
+
+// ============================================================================
+// InlineTask 测试
+// ============================================================================
+
+InlineTask<int> inline_chain(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return 1 + co_await inline_chain(depth - 1);
+}
+
+InlineTask<void> inline_fail() {
+    throw std::runtime_error("inline failure");
+    co_return;
+}
+
+InlineTask<void> inline_wait(ManualGate& gate) {
+    co_await gate.wait();
+}
+
+// 测试嵌套的 InlineTask 返回结果、传播异常，结束后栈回到原位
+TEST(InlineTaskTest, NestedChainReleasesStack) {
+    const size_t base = FrameStack::used();
+    auto root = []() -> Task<int> {
+        int depth = co_await inline_chain(10);
+        try {
+            co_await inline_fail();
+        } catch (const std::runtime_error&) {
+            depth += 100;
+        }
+        co_return depth;
+    };
+
+    EXPECT_EQ(root().sync_wait(), 110);
+    EXPECT_EQ(FrameStack::used(), base);
+}
+
+// 测试挂起期间其他协程压入新帧：先结束的下层帧等到上层帧释放后一起回退
+TEST(InlineTaskTest, OutOfOrderCompletion) {
+    if (!FramePool::enabled()) {
+        GTEST_SKIP() << "FrameStack disabled in this build";
+    }
+    ManualGate first;
+    ManualGate second;
+    auto root = [](ManualGate& gate) -> Task<void> {
+        co_await inline_wait(gate);
+    };
+
+    const size_t base = FrameStack::used();
+    auto a = root(first);
+    auto b = root(second);
+    a.handle().resume();
+    const size_t after_a = FrameStack::used();
+    b.handle().resume();
+    EXPECT_GT(after_a, base);
+    EXPECT_GT(FrameStack::used(), after_a);
+
+    first.open();
+    EXPECT_TRUE(a.handle().done());
+    EXPECT_GT(FrameStack::used(), after_a);  // a 的帧已经释放，但在 b 的帧之下
+
+    second.open();
+    EXPECT_TRUE(b.handle().done());
+    EXPECT_EQ(FrameStack::used(), base);
+}
+
 // 主函数
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,151 @@
+// 本测试以 ZLCORO_ENABLE_TRACING 编译（见 tests/CMakeLists.txt）
+#include "zlcoro/core/task.hpp"
+#include "zlcoro/core/trace.hpp"
+#include "zlcoro/scheduler/scheduler.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace zlcoro;
+
+namespace {
+
+// 所有线程中满足条件的事件
+template <typename Pred>
+std::vector<TraceEvent> collect(Pred pred) {
+    std::vector<TraceEvent> result;
+    for (const auto& thread : Tracer::instance().snapshot()) {
+        for (const auto& event : thread.events) {
+            if (pred(event)) {
+                result.push_back(event);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+static_assert(tracing_enabled, "trace_test must be built with ZLCORO_ENABLE_TRACING");
+
+// 测试 1: co_await 子任务记录父子关系和父协程的等待区间
+TEST(TraceTest, TaskAwaitRecordsParentChildLink) {
+    Tracer::instance().clear();
+
+    const void* child_frame = nullptr;
+    auto child = [&]() -> Task<int> {
+        co_return 42;
+    };
+    auto parent = [&]() -> Task<int> {
+        auto task = child();
+        child_frame = task.handle().address();
+        co_return co_await task;
+    };
+
+    auto task = parent();
+    const void* parent_frame = task.handle().address();
+    EXPECT_EQ(task.sync_wait(), 42);
+
+    auto start = collect([&](const TraceEvent& e) {
+        return e.type == TraceEventType::Start && e.coro == child_frame;
+    });
+    ASSERT_EQ(start.size(), 1u);
+    EXPECT_EQ(start[0].parent, parent_frame);
+
+    auto complete = collect([&](const TraceEvent& e) {
+        return e.type == TraceEventType::Complete && e.coro == child_frame;
+    });
+    ASSERT_EQ(complete.size(), 1u);
+    EXPECT_EQ(complete[0].parent, parent_frame);
+
+    auto waits = collect([&](const TraceEvent& e) {
+        return e.coro == parent_frame && std::string(e.name) == "co_await task";
+    });
+    ASSERT_EQ(waits.size(), 2u);
+    EXPECT_EQ(waits[0].type, TraceEventType::Suspend);
+    EXPECT_EQ(waits[1].type, TraceEventType::Resume);
+    EXPECT_LE(waits[0].timestamp_ns, waits[1].timestamp_ns);
+}
+
+// 测试 2: schedule() 的挂起和恢复分别记录在提交线程和工作线程上
+TEST(TraceTest, ScheduleRecordsQueueingOnBothThreads) {
+    Tracer::instance().clear();
+
+    auto task = []() -> Task<void> {
+        co_await schedule();
+    }();
+    const void* frame = task.handle().address();
+    task.sync_wait();
+
+    uint32_t suspend_thread = 0;
+    uint32_t resume_thread = 0;
+    for (const auto& thread : Tracer::instance().snapshot()) {
+        for (const auto& event : thread.events) {
+            if (event.coro != frame || std::string(event.name) != "schedule") {
+                continue;
+            }
+            if (event.type == TraceEventType::Suspend) {
+                suspend_thread = thread.thread_id;
+            } else if (event.type == TraceEventType::Resume) {
+                resume_thread = thread.thread_id;
+            }
+        }
+    }
+    EXPECT_NE(suspend_thread, 0u);
+    EXPECT_NE(resume_thread, 0u);
+    EXPECT_NE(suspend_thread, resume_thread);
+}
+
+// 测试 3: 已在工作线程上的 schedule() 不挂起，也不记录事件
+TEST(TraceTest, ScheduleFastPathRecordsNothing) {
+    Tracer::instance().clear();
+
+    auto task = []() -> Task<void> {
+        co_await schedule();
+        co_await schedule();   // 已在工作线程上：await_ready 跳过挂起
+    }();
+    const void* frame = task.handle().address();
+    task.sync_wait();
+
+    auto events = collect([&](const TraceEvent& e) {
+        return std::string(e.name) == "schedule";
+    });
+    ASSERT_EQ(events.size(), 2u);   // 只有第一次切换的 Suspend/Resume
+    for (const auto& event : events) {
+        EXPECT_EQ(event.coro, frame);
+    }
+}
+
+// 测试 4: 导出 Chrome trace JSON
+TEST(TraceTest, ChromeJsonExport) {
+    Tracer::instance().clear();
+
+    auto task = []() -> Task<void> {
+        co_await schedule();
+    }();
+    task.sync_wait();
+
+    std::string json = Tracer::instance().to_chrome_json();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"ph\":\"M\",\"name\":\"thread_name\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"b\",\"cat\":\"zlcoro\",\"name\":\"schedule\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"e\",\"cat\":\"zlcoro\",\"name\":\"schedule\""), std::string::npos);
+    EXPECT_EQ(std::count(json.begin(), json.end(), '{'), std::count(json.begin(), json.end(), '}'));
+}
+
+// 测试 5: 环形缓冲区满后只保留最新的事件
+TEST(TraceTest, RingKeepsNewestEvents) {
+    TraceRing ring(1);
+    for (uint64_t i = 0; i < TraceRing::capacity + 10; ++i) {
+        ring.push(TraceEvent{i, nullptr, nullptr, "x", TraceEventType::Suspend});
+    }
+
+    auto trace = ring.snapshot();
+    ASSERT_EQ(trace.events.size(), TraceRing::capacity);
+    EXPECT_EQ(trace.events.front().timestamp_ns, 10u);
+    EXPECT_EQ(trace.events.back().timestamp_ns, TraceRing::capacity + 9);
+
+    ring.clear();
+    EXPECT_TRUE(ring.snapshot().events.empty());
+}
@@ -3,6 +3,16 @@
 #include <gtest/gtest.h>
 #include <fstream>
 #include <filesystem>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <sys/resource.h>
 
 using namespace zlcoro;
 
@@ -93,6 +103,81 @@ TEST(AsyncFileTest, LargeFile) {
     std::filesystem::remove(test_file);
 }
 
+TEST(AsyncFileTest, ReadAtWriteAt) {
+    auto test_file = "/tmp/zlcoro_test_at.txt";
+
+    auto task = [&]() -> Task<std::string> {
+        AsyncFile file(test_file, AsyncFile::ReadWrite | AsyncFile::Create | AsyncFile::Truncate);
+        std::string head = "Hello, ";
+        std::string tail = "offsets!";
+        co_await file.write_at(static_cast<off_t>(head.size()), tail);
+        co_await file.write_at(0, head);
+        co_await file.fsync(true);
+
+        char buffer[32];
+        size_t n = co_await file.read_at(0, buffer);
+        EXPECT_EQ(co_await file.read_at(static_cast<off_t>(n), buffer), 0u);  // 文件末尾
+        co_return std::string(buffer, n);
+    };
+
+    EXPECT_EQ(async_run(task()).get(), "Hello, offsets!");
+    std::filesystem::remove(test_file);
+}
+
+TEST(AsyncFileTest, MapReadOnlyView) {
+    auto test_file = "/tmp/zlcoro_test_map.txt";
+    std::string content;
+    for (int i = 0; i < 2000; ++i) {
+        content += std::to_string(i) + ",";
+    }
+    {
+        std::ofstream out(test_file);
+        out << content;
+    }
+
+    AsyncFile file(test_file);
+    EXPECT_EQ(file.size(), content.size());
+
+    FileMapping whole = file.map();
+    EXPECT_EQ(whole.view(), content);
+
+    // 偏移不按页对齐，长度截断到文件末尾
+    FileMapping tail = file.map(5000, 1 << 20);
+    EXPECT_EQ(tail.view(), std::string_view(content).substr(5000));
+    EXPECT_TRUE(file.map(static_cast<off_t>(content.size())).empty());
+
+    file.close();
+    EXPECT_EQ(tail.view().substr(0, 10), content.substr(5000, 10));  // 映射不依赖文件保持打开
+    std::filesystem::remove(test_file);
+}
+
+// 在事件循环中调用：io_uring 后端直接提交，epoll 后端交给 BlockingPool，
+// 两种情况都必须回到原事件循环恢复
+class AsyncFileBackendTest : public ::testing::TestWithParam<IoBackend> {};
+
+TEST_P(AsyncFileBackendTest, ResumesOnOwningLoop) {
+    EventLoop loop(GetParam());
+    auto test_file = "/tmp/zlcoro_test_loop_file.txt";
+    std::string result;
+    bool on_loop = false;
+
+    auto task = [&]() -> Task<void> {
+        co_await write_file(test_file, "loop file");
+        result = co_await read_file(test_file);
+        on_loop = loop.is_in_loop_thread();
+        loop.stop();
+    };
+    loop.spawn(task());
+    loop.run();
+
+    EXPECT_EQ(result, "loop file");
+    EXPECT_TRUE(on_loop);
+    std::filesystem::remove(test_file);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, AsyncFileBackendTest,
+                         ::testing::Values(IoBackend::Epoll, IoBackend::IoUring));
+
 // =============================================================================
 // EpollPoller 基础测试
 // =============================================================================
@@ -126,6 +211,401 @@ TEST(EpollPollerTest, AddRemove) {
     close(pipefd[1]);
 }
 
+TEST(EpollPollerTest, HighFdDispatchReusesReadyVector) {
+    EpollPoller poller;
+    
+    int pipefd[2];
+    ASSERT_EQ(pipe(pipefd), 0);
+    // 移到跨页的大 fd 上，验证分页表按需扩展
+    int high_fd = fcntl(pipefd[0], F_DUPFD, 3000);
+    ASSERT_GE(high_fd, 3000);
+    
+    auto coro = std::noop_coroutine();
+    poller.add(high_fd, EpollPoller::Read, coro);
+    EXPECT_TRUE(poller.has(high_fd));
+    EXPECT_FALSE(poller.has(high_fd + 1));
+    
+    std::vector<std::coroutine_handle<>> ready;
+    EXPECT_EQ(poller.poll(0, ready), 0u);
+    
+    ASSERT_EQ(::write(pipefd[1], "x", 1), 1);
+    EXPECT_EQ(poller.poll(100, ready), 1u);
+    ASSERT_EQ(ready.size(), 1u);
+    EXPECT_EQ(ready[0], std::coroutine_handle<>(coro));
+    
+    // 移除后即使仍可读也不再分发
+    poller.remove(high_fd);
+    ready.clear();
+    EXPECT_EQ(poller.poll(0, ready), 0u);
+    
+    close(high_fd);
+    close(pipefd[0]);
+    close(pipefd[1]);
+}
+
+TEST(EpollPollerTest, PersistentWatchSeparateWaiters) {
+    EpollPoller poller;
+    
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv), 0);
+    
+    auto& handler = poller.watch(sv[0]);
+    EXPECT_TRUE(poller.has(sv[0]));
+    // 再次 watch 不重新注册
+    EXPECT_EQ(&poller.watch(sv[0]), &handler);
+    
+    // 初始可写的边沿没有等待者，缓存为就绪
+    std::vector<std::coroutine_handle<>> ready;
+    EXPECT_EQ(poller.poll(100, ready), 0u);
+    EXPECT_TRUE(handler.writer.consume_ready());
+    EXPECT_FALSE(handler.writer.consume_ready());
+    EXPECT_FALSE(handler.reader.consume_ready());
+    
+    // 读者挂起，数据到达后只唤醒读者
+    auto coro = std::noop_coroutine();
+    ASSERT_TRUE(handler.reader.park(coro));
+    ASSERT_EQ(::write(sv[1], "x", 1), 1);
+    EXPECT_EQ(poller.poll(100, ready), 1u);
+    ASSERT_EQ(ready.size(), 1u);
+    EXPECT_EQ(ready[0], std::coroutine_handle<>(coro));
+    
+    // 缓存的就绪事件让 park 失败，调用方不挂起
+    ASSERT_EQ(::write(sv[1], "y", 1), 1);
+    ready.clear();
+    EXPECT_EQ(poller.poll(100, ready), 0u);
+    EXPECT_FALSE(handler.reader.park(coro));
+    
+    poller.remove(sv[0]);
+    EXPECT_FALSE(poller.has(sv[0]));
+    
+    close(sv[0]);
+    close(sv[1]);
+}
+
+// =============================================================================
+// 定时器测试
+// =============================================================================
+
+TEST(TimerWheelTest, FiresInOrderAcrossLevels) {
+    using namespace std::chrono;
+    auto t0 = TimerWheel::Clock::now();
+    TimerWheel wheel(t0);
+    std::vector<int> fired;
+    std::vector<TimerWheel::Callback> expired;
+    auto run = [&](milliseconds at) {
+        expired.clear();
+        wheel.advance(t0 + at, expired);
+        for (auto& callback : expired) {
+            callback();
+        }
+    };
+
+    EXPECT_EQ(wheel.next_timeout(t0), -1);
+    wheel.add(t0 + milliseconds(5), [&] { fired.push_back(5); });
+    wheel.add(t0 + milliseconds(70), [&] { fired.push_back(70); });      // 第 1 层
+    wheel.add(t0 + milliseconds(5000), [&] { fired.push_back(5000); });  // 第 2 层
+    wheel.add(t0 + hours(10), [&] { fired.push_back(-1); });             // 超出范围
+    auto cancelled = wheel.add(t0 + milliseconds(6), [&] { fired.push_back(6); });
+    EXPECT_EQ(wheel.size(), 5u);
+    EXPECT_EQ(wheel.next_timeout(t0), 5);
+
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(TimerWheel::invalid_id));
+
+    run(milliseconds(4));
+    EXPECT_TRUE(fired.empty());
+    run(milliseconds(5));
+    EXPECT_EQ(fired, (std::vector<int>{5}));
+    run(milliseconds(69));
+    EXPECT_EQ(fired.size(), 1u);
+    run(milliseconds(4999));
+    EXPECT_EQ(fired, (std::vector<int>{5, 70}));
+    run(milliseconds(5000));
+    EXPECT_EQ(fired, (std::vector<int>{5, 70, 5000}));
+
+    // 剩下超出范围的定时器：超时不会晚于它的到期时间
+    EXPECT_EQ(wheel.size(), 1u);
+    EXPECT_GT(wheel.next_timeout(t0 + milliseconds(5000)), 0);
+    run(hours(10) - milliseconds(1));
+    EXPECT_EQ(fired.size(), 3u);
+    run(hours(10));
+    EXPECT_EQ(fired.back(), -1);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, CancelManyTimers) {
+    using namespace std::chrono;
+    auto t0 = TimerWheel::Clock::now();
+    TimerWheel wheel(t0);
+    int fired = 0;
+    std::vector<TimerWheel::TimerId> ids;
+    for (int i = 0; i < 10000; ++i) {
+        ids.push_back(wheel.add(t0 + milliseconds(1 + i % 3000), [&] { ++fired; }));
+    }
+    // 取消除每 100 个中的一个以外的全部定时器
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i % 100 != 0) {
+            EXPECT_TRUE(wheel.cancel(ids[i]));
+        }
+    }
+    EXPECT_EQ(wheel.size(), 100u);
+
+    std::vector<TimerWheel::Callback> expired;
+    wheel.advance(t0 + milliseconds(3000), expired);
+    EXPECT_EQ(expired.size(), 100u);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(EventLoopTimerTest, SleepForAndWithTimeout) {
+    using namespace std::chrono;
+    EventLoop loop;
+    bool slept = false;
+    int value = 0;
+    bool timed_out = false;
+
+    auto task = [&]() -> Task<void> {
+        auto start = steady_clock::now();
+        co_await sleep_for(milliseconds(20));
+        slept = steady_clock::now() - start >= milliseconds(20);
+
+        auto fast = []() -> Task<int> { co_return 42; };
+        value = co_await with_timeout(fast(), seconds(5));
+
+        auto slow = []() -> Task<void> { co_await sleep_for(milliseconds(100)); };
+        try {
+            co_await with_timeout(slow(), milliseconds(10));
+        } catch (const TimeoutError&) {
+            timed_out = true;
+        }
+
+        co_await sleep_for(milliseconds(150));  // 等待超时的任务结束
+        loop.stop();
+    };
+    loop.spawn(task());
+    loop.run();
+
+    EXPECT_TRUE(slept);
+    EXPECT_EQ(value, 42);
+    EXPECT_TRUE(timed_out);
+}
+
+TEST(EventLoopTimerTest, ForeignScheduleWakesIdleLoop) {
+    using namespace std::chrono;
+    EventLoop loop;
+    steady_clock::time_point scheduled_at;
+    steady_clock::duration latency{};
+
+    auto task = [&]() -> Task<void> {
+        latency = steady_clock::now() - scheduled_at;
+        loop.stop();
+        co_return;
+    };
+    auto t = task();
+
+    // 没有定时器时事件循环一直阻塞，只能被 eventfd 唤醒
+    std::thread other([&] {
+        std::this_thread::sleep_for(milliseconds(30));
+        scheduled_at = steady_clock::now();
+        loop.schedule(t.handle());
+    });
+    loop.run();
+    other.join();
+
+    EXPECT_LT(latency, milliseconds(50));
+}
+
+TEST(EventLoopTimerTest, ResumeOnLoopSkipsHopWhenAlreadyThere) {
+    EventLoop loop;
+    bool on_loop = false;
+    bool ready_on_loop = false;
+
+    auto task = [&]() -> Task<void> {
+        co_await resume_on(loop);  // 从其他线程切换到事件循环
+        on_loop = loop.is_in_loop_thread() && Executor::current() == &loop;
+        ready_on_loop = resume_on(loop).await_ready();
+        co_await yield();          // 排到就绪队列尾部，仍在本事件循环
+        loop.stop();
+    };
+    auto t = task();
+
+    std::thread other([&] { t.handle().resume(); });
+    loop.run();
+    other.join();
+
+    EXPECT_TRUE(on_loop);
+    EXPECT_TRUE(ready_on_loop);
+    EXPECT_TRUE(t.handle().done());
+}
+
+TEST(EventLoopTimerTest, StopTokenCancelsSleep) {
+    using namespace std::chrono;
+    EventLoop loop;
+    std::stop_source stop;
+    bool inherited = false;
+    bool cancelled = false;
+    bool cancelled_before_suspend = false;
+    steady_clock::duration elapsed{};
+
+    auto child = [&]() -> Task<void> {
+        std::stop_token token = co_await get_stop_token();
+        inherited = token.stop_possible();
+        co_await sleep_for(seconds(10));
+    };
+    auto task = [&]() -> Task<void> {
+        auto start = steady_clock::now();
+        try {
+            co_await child();  // 子任务继承令牌
+        } catch (const OperationCancelled&) {
+            cancelled = true;
+        }
+        elapsed = steady_clock::now() - start;
+
+        try {
+            co_await sleep_for(seconds(10));  // 已经请求停止：不挂起
+        } catch (const OperationCancelled&) {
+            cancelled_before_suspend = true;
+        }
+        loop.stop();
+    };
+    auto t = task();
+    t.set_stop_token(stop.get_token());
+    loop.spawn(std::move(t));
+
+    std::thread other([&] {
+        std::this_thread::sleep_for(milliseconds(20));
+        stop.request_stop();
+    });
+    loop.run();
+    other.join();
+
+    EXPECT_TRUE(inherited);
+    EXPECT_TRUE(cancelled);
+    EXPECT_TRUE(cancelled_before_suspend);
+    EXPECT_LT(elapsed, seconds(5));
+}
+
+TEST(EventLoopTimerTest, WithTimeoutCancelsTimedOutTask) {
+    using namespace std::chrono;
+    EventLoop loop;
+    bool timed_out = false;
+    bool slow_cancelled = false;
+
+    auto slow = [&]() -> Task<void> {
+        try {
+            co_await sleep_for(seconds(10));
+        } catch (const OperationCancelled&) {
+            slow_cancelled = true;
+        }
+    };
+    auto task = [&]() -> Task<void> {
+        try {
+            co_await with_timeout(slow(), milliseconds(10));
+        } catch (const TimeoutError&) {
+            timed_out = true;
+        }
+        co_await yield();  // 被取消的任务在下一轮恢复
+        loop.stop();
+    };
+    loop.spawn(task());
+    loop.run();
+
+    EXPECT_TRUE(timed_out);
+    EXPECT_TRUE(slow_cancelled);
+}
+
+TEST(EventLoopTimerTest, WithTimeoutOffLoopThread) {
+    // 在工作线程上调用 with_timeout：极短的超时可能在 await_suspend 返回
+    // 之前就在事件循环线程上恢复等待者
+    using namespace std::chrono;
+    EventLoop& loop = EventLoop::instance();
+    std::thread loop_thread([&] { loop.run(); });
+    while (!loop.is_running()) {
+        std::this_thread::yield();
+    }
+
+    ThreadPool pool(2);
+    auto slow = []() -> Task<void> {
+        co_await sleep_for(seconds(10));
+    };
+    auto task = [&](steady_clock::duration timeout) -> Task<bool> {
+        co_await resume_on(pool);
+        try {
+            co_await with_timeout(slow(), timeout);
+        } catch (const TimeoutError&) {
+            co_return true;
+        }
+        co_return false;
+    };
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_TRUE(task(i % 2 ? milliseconds(1) : milliseconds(0)).sync_wait());
+    }
+
+    loop.stop();
+    loop_thread.join();
+    pool.shutdown();
+}
+
+TEST(EventLoopTimerTest, MetricsSnapshot) {
+    EventLoop loop;
+    int fired = 0;
+    for (int i = 0; i < 3; ++i) {
+        loop.add_timer(1, [&] {
+            if (++fired == 3) {
+                loop.stop();
+            }
+        });
+    }
+    auto task = []() -> Task<void> { co_return; };
+    auto t = task();
+    loop.schedule(t.handle());
+    loop.run();
+
+    auto metrics = loop.metrics();
+    if constexpr (metrics_enabled) {
+        EXPECT_GT(metrics.iterations, 0u);
+        EXPECT_GT(metrics.polls, 0u);
+        EXPECT_EQ(metrics.timers_fired, 3u);
+        EXPECT_GE(metrics.tasks_run, 1u);
+        EXPECT_EQ(metrics.events_per_poll.count, metrics.polls);
+        EXPECT_GT(metrics.timer_lag.count, 0u);
+        EXPECT_GT(metrics.loop_latency.count, 0u);
+    }
+
+    auto text = metrics.to_prometheus("zlcoro_event_loop", "loop=\"0\"");
+    EXPECT_NE(text.find("zlcoro_event_loop_timers_fired_total{loop=\"0\"}"), std::string::npos);
+    EXPECT_NE(text.find("zlcoro_event_loop_loop_latency_seconds_bucket{loop=\"0\",le="),
+              std::string::npos);
+}
+
+TEST(EventLoopTimerTest, ForeignScheduleBurstOverflows) {
+    // 超过注入队列容量的跨线程调度：溢出队列中的协程也必须被执行
+    constexpr int count = 5000;
+    EventLoop loop;
+    int resumed = 0;
+
+    auto task = [&]() -> Task<void> {
+        if (++resumed == count) {
+            loop.stop();
+        }
+        co_return;
+    };
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < count; ++i) {
+        tasks.push_back(task());
+    }
+
+    std::thread other([&] {
+        for (auto& t : tasks) {
+            loop.schedule(t.handle());
+        }
+    });
+    loop.run();
+    other.join();
+
+    EXPECT_EQ(resumed, count);
+}
+
 // =============================================================================
 // 集成测试（需要事件循环）
 // =============================================================================
@@ -152,3 +632,674 @@ TEST(AsyncSocketTest, BindAndListen) {
     
     socket.close();
 }
+
+// =============================================================================
+// EventLoopGroup 测试
+// =============================================================================
+
+// 阻塞式客户端：连接、发送、读取回显（测试用）
+static std::string blocking_echo(int port, const std::string& message) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    timeval tv{2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    std::string reply;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        ::send(fd, message.data(), message.size(), 0);
+        char buf[256];
+        // 销毁 io_uring 时内核会向曾使用它的线程投递 task_work，
+        // 带超时的阻塞调用可能因此返回 EINTR
+        ssize_t n;
+        do {
+            n = ::recv(fd, buf, sizeof(buf), 0);
+        } while (n == -1 && errno == EINTR);
+        if (n > 0) {
+            reply.assign(buf, n);
+        }
+    }
+    ::close(fd);
+    return reply;
+}
+
+TEST(EventLoopGroupTest, SpawnRunsOnOwningLoop) {
+    EventLoopGroup group(2, false);
+    group.start();
+
+    std::atomic<int> matched{0};
+    // lambda 协程通过 this 访问捕获，lambda 对象必须比协程活得更久
+    auto check = [&matched](EventLoop& loop, size_t) -> Task<void> {
+        if (EventLoop::current() == &loop && loop.is_in_loop_thread()) {
+            matched++;
+        }
+        co_return;
+    };
+    group.run_on_each(check);
+
+    for (int i = 0; i < 100 && matched.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(matched.load(), 2);
+    EXPECT_EQ(EventLoop::current(), nullptr);  // 测试线程不在任何事件循环中
+
+    group.stop();
+}
+
+TEST(EventLoopGroupTest, StopRightAfterStart) {
+    // 线程还没进入事件循环就收到 stop()：不能丢失，否则 join 永远阻塞
+    for (int i = 0; i < 200; ++i) {
+        EventLoopGroup group(2, false);
+        group.start();
+        group.stop();
+    }
+    EventLoopGroup group(2, false);
+    group.start();  // 析构时停止
+}
+
+TEST(EventLoopGroupTest, ReusePortServe) {
+    EventLoopGroup group(2, false);
+    std::atomic<int> finished{0};
+
+    group.serve("127.0.0.1", 12346, [&finished](AsyncSocket conn) -> Task<void> {
+        // 连接必须绑定到当前运行的事件循环
+        if (EventLoop::current() == &conn.event_loop()) {
+            std::string data = co_await conn.read();
+            co_await conn.write(data);
+        }
+        finished++;
+    });
+    group.start();
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(blocking_echo(12346, "ping " + std::to_string(i)),
+                  "ping " + std::to_string(i));
+    }
+
+    // 等待连接协程全部结束再停止（stop 不会恢复仍挂起的协程）
+    for (int i = 0; i < 100 && finished.load() < 4; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(finished.load(), 4);
+    group.stop();
+}
+
+TEST(EventLoopGroupTest, SingleListenerServe) {
+    EventLoopGroup group(2, false);
+    std::atomic<int> finished{0};
+    std::atomic<int> on_second{0};
+
+    ServeOptions options;
+    options.reuse_port = false;
+    group.serve("127.0.0.1", 12353, [&](AsyncSocket conn) -> Task<void> {
+        // 转交的连接绑定到处理它的事件循环
+        if (EventLoop::current() == &conn.event_loop()) {
+            if (&conn.event_loop() == &group.loop(1)) {
+                on_second++;
+            }
+            std::string data = co_await conn.read();
+            co_await conn.write(data);
+        }
+        finished++;
+    }, options);
+    group.start();
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(blocking_echo(12353, "ping " + std::to_string(i)),
+                  "ping " + std::to_string(i));
+    }
+
+    for (int i = 0; i < 100 && finished.load() < 4; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(finished.load(), 4);
+    EXPECT_EQ(on_second.load(), 2);   // 轮询分发到两个事件循环
+    group.stop();
+}
+
+TEST(EventLoopGroupTest, AcceptSurvivesFdExhaustion) {
+    EventLoopGroup group(1, false);
+    std::atomic<int> finished{0};
+
+    ServeOptions options;
+    options.accept_retry_delay = std::chrono::milliseconds(5);
+    group.serve("127.0.0.1", 12358, [&finished](AsyncSocket conn) -> Task<void> {
+        std::string data = co_await conn.read();
+        co_await conn.write(data);
+        finished++;
+    }, options);
+    group.start();
+
+    // 客户端 socket 先创建好，再把 fd 上限压到当前最小空闲 fd：accept4 返回 EMFILE
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    timeval tv{2, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    int lowest_free = ::dup(client);
+    ::close(lowest_free);
+
+    rlimit saved{};
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &saved), 0);
+    rlimit limited = saved;
+    limited.rlim_cur = static_cast<rlim_t>(lowest_free);
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limited), 0);
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(12358);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    int rc = ::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+    for (int i = 0; i < 100 && group.accept_errors() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    uint64_t errors = group.accept_errors();
+    setrlimit(RLIMIT_NOFILE, &saved);
+    ASSERT_EQ(rc, 0);
+    EXPECT_GT(errors, 0u);
+
+    // 恢复上限后监听协程重试成功，连接被正常处理
+    std::string reply;
+    ::send(client, "still here", 10, 0);
+    char buf[64];
+    ssize_t n;
+    do {
+        n = ::recv(client, buf, sizeof(buf), 0);
+    } while (n == -1 && errno == EINTR);
+    if (n > 0) {
+        reply.assign(buf, n);
+    }
+    ::close(client);
+    EXPECT_EQ(reply, "still here");
+
+    for (int i = 0; i < 100 && finished.load() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(finished.load(), 1);
+    group.stop();
+}
+
+// =============================================================================
+// io_uring 后端测试
+// =============================================================================
+
+#if defined(ZLCORO_HAS_IO_URING)
+TEST(IoUringTest, FileWriteFsyncRead) {
+    EventLoop loop(IoBackend::IoUring);
+    if (loop.backend() != IoBackend::IoUring) {
+        GTEST_SKIP() << "io_uring not supported by this kernel";
+    }
+    const std::string path = "test_uring.txt";
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ASSERT_NE(fd, -1);
+
+    std::string result;
+    auto io = [&]() -> Task<void> {
+        const std::string content = "Hello, io_uring!";
+        int n = co_await loop.submit(IoUringPoller::make_write(
+            fd, content.data(), static_cast<unsigned>(content.size()), 0));
+        EXPECT_EQ(n, static_cast<int>(content.size()));
+        EXPECT_EQ(co_await loop.submit(IoUringPoller::make_fsync(fd)), 0);
+
+        std::string buffer(64, '\0');
+        n = co_await loop.submit(IoUringPoller::make_read(
+            fd, buffer.data(), static_cast<unsigned>(buffer.size()), 0));
+        buffer.resize(n < 0 ? 0 : n);
+        result = buffer;
+        loop.stop();
+    };
+    loop.spawn(io());
+    loop.run();
+
+    EXPECT_EQ(result, "Hello, io_uring!");
+    ::close(fd);
+    std::filesystem::remove(path);
+}
+
+TEST(IoUringTest, FullSubmissionQueueDoesNotSpin) {
+    // 远多于 SQ 和 CQ 容量的操作且不收割：enqueue 不能在锁内忙等，
+    // 内核暂时不接收的请求积压起来，收割之后全部完成
+    IoUringPoller ring(4);
+    constexpr int count = 64;
+    std::vector<IoUringPoller::Operation> ops(count);
+    for (auto& op : ops) {
+        op.coro = std::noop_coroutine();
+        op.result = -1;
+        ring.enqueue(IoUringPoller::Request{}, &op, false);   // IORING_OP_NOP
+    }
+
+    std::vector<std::coroutine_handle<>> resumed;
+    for (int i = 0; i < 1000 && resumed.size() < count; ++i) {
+        ring.submit();
+        ring.reap(resumed);
+    }
+    EXPECT_EQ(resumed.size(), static_cast<size_t>(count));
+    EXPECT_FALSE(ring.has_backlog());
+    EXPECT_EQ(ring.in_flight(), 0u);
+    for (const auto& op : ops) {
+        EXPECT_EQ(op.result, 0);
+    }
+}
+
+TEST(IoUringTest, BufferGroupIdsAreNotReused) {
+    EventLoop loop(IoBackend::IoUring);
+    if (loop.backend() != IoBackend::IoUring) {
+        GTEST_SKIP() << "io_uring not supported by this kernel";
+    }
+    IoUringPoller& ring = *loop.io_uring();
+    auto pool = std::make_unique<BufferPool>(loop, 64, 4);
+
+    // 占满其余的组 ID：新的池不能复用仍在使用的 ID
+    std::vector<uint16_t> taken;
+    while (taken.size() < UINT16_MAX) {
+        taken.push_back(ring.acquire_buffer_group());
+    }
+    EXPECT_THROW(BufferPool(loop, 64, 4), std::runtime_error);
+
+    pool.reset();   // 归还它的组 ID
+    EXPECT_NO_THROW(BufferPool(loop, 64, 4));
+    for (uint16_t group : taken) {
+        ring.release_buffer_group(group);
+    }
+}
+
+TEST(IoUringTest, ProvideBuffersFailureIsRecorded) {
+    EventLoop loop(IoBackend::IoUring);
+    if (loop.backend() != IoBackend::IoUring) {
+        GTEST_SKIP() << "io_uring not supported by this kernel";
+    }
+    IoUringPoller& ring = *loop.io_uring();
+    uint16_t group = ring.acquire_buffer_group();
+
+    // 内核地址空间中的缓冲区：PROVIDE_BUFFERS 以 EFAULT 失败
+    ring.provide_buffers(reinterpret_cast<void*>(0xffff800000000000ull), 64, 4, group, 0, true);
+    std::vector<std::coroutine_handle<>> resumed;
+    for (int i = 0; i < 100 && ring.in_flight() > 0; ++i) {
+        ring.reap(resumed);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(resumed.empty());   // 没有等待者
+    EXPECT_EQ(ring.buffer_group_error(group), EFAULT);
+    ring.release_buffer_group(group);
+
+    // 重新分配的组 ID 不带旧的错误
+    uint16_t again = ring.acquire_buffer_group();
+    EXPECT_EQ(ring.buffer_group_error(again), 0);
+    ring.release_buffer_group(again);
+}
+#endif
+
+// 同一个回显流程分别跑在 epoll 和 io_uring 后端上
+class EchoBackendTest : public ::testing::TestWithParam<IoBackend> {};
+
+TEST_P(EchoBackendTest, Echo) {
+    EventLoop loop(GetParam());
+    const int port = GetParam() == IoBackend::Epoll ? 12347 : 12348;
+
+    AsyncSocket listener(loop);
+    listener.create();
+    listener.set_reuse_addr(true);
+    listener.bind("127.0.0.1", port);
+    listener.listen();
+
+    std::atomic<bool> done{false};
+    std::string reply;
+
+    auto server = [&]() -> Task<void> {
+        AsyncSocket conn = co_await listener.accept();
+        std::string data = co_await conn.read();
+        co_await conn.write(data);
+    };
+    auto client = [&]() -> Task<void> {
+        AsyncSocket sock(loop);
+        sock.create();
+        co_await sock.connect("127.0.0.1", port);
+        co_await sock.write("echo over " + std::to_string(port));
+        reply = co_await sock.read();
+        done = true;
+        loop.stop();
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    std::thread watchdog([&] {
+        for (int i = 0; i < 200 && !done; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        loop.stop();
+    });
+    loop.run();
+    watchdog.join();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(reply, "echo over " + std::to_string(port));
+}
+
+// 服务端用 BufferPool 读取、span 写回；客户端用 writev 发送、readv 接收
+TEST_P(EchoBackendTest, PooledAndVectoredIo) {
+    EventLoop loop(GetParam());
+    const int port = GetParam() == IoBackend::Epoll ? 12349 : 12350;
+    auto pool = std::make_unique<BufferPool>(loop, 64, 4);
+
+    AsyncSocket listener(loop);
+    listener.create();
+    listener.set_reuse_addr(true);
+    listener.bind("127.0.0.1", port);
+    listener.listen();
+
+    std::atomic<bool> done{false};
+    std::string reply;
+    size_t in_use = 0;
+
+    auto server = [&]() -> Task<void> {
+        AsyncSocket conn = co_await listener.accept();
+        size_t total = 0;
+        while (total < 11) {
+            PooledBuffer buffer = co_await conn.read(*pool);
+            if (buffer.empty()) {
+                break;
+            }
+            in_use = std::max(in_use, pool->buffer_count() - pool->available());
+            total += co_await conn.write(buffer.data());
+        }
+    };
+    auto client = [&]() -> Task<void> {
+        AsyncSocket sock(loop);
+        co_await sock.connect("127.0.0.1", port);
+
+        char hello[] = "hello ";
+        char world[] = "world";
+        iovec out[] = {{hello, 6}, {world, 5}};
+        EXPECT_EQ(co_await sock.writev(out), 11u);
+
+        char first[4];
+        char second[16];
+        size_t total = 0;
+        while (total < 11) {
+            iovec in[] = {{first, sizeof(first)}, {second, sizeof(second)}};
+            size_t n = co_await sock.readv(in);
+            if (n == 0) {
+                break;
+            }
+            // 分散读按顺序填充：先填满 first，再填 second
+            std::string chunk(first, std::min(n, sizeof(first)));
+            if (n > sizeof(first)) {
+                chunk.append(second, n - sizeof(first));
+            }
+            reply += chunk;
+            total += n;
+        }
+        done = true;
+        loop.stop();
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    std::thread watchdog([&] {
+        for (int i = 0; i < 200 && !done; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        loop.stop();
+    });
+    loop.run();
+    watchdog.join();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(reply, "hello world");
+    EXPECT_GE(in_use, 1u);
+    EXPECT_EQ(pool->available(), pool->buffer_count());  // 缓冲区全部归还
+    pool.reset();
+}
+
+// 取消令牌撤销正在等待的 accept（其他线程请求停止）和 read（定时器中请求停止）
+TEST_P(EchoBackendTest, StopTokenCancelsAcceptAndRead) {
+    using namespace std::chrono;
+    EventLoop loop(GetParam());
+    const int port = GetParam() == IoBackend::Epoll ? 12351 : 12352;
+
+    AsyncSocket listener(loop);
+    listener.create();
+    listener.set_reuse_addr(true);
+    listener.bind("127.0.0.1", port);
+    listener.listen();
+    AsyncSocket client(loop);
+
+    std::stop_source stop_accept;
+    std::stop_source stop_read;
+    std::atomic<bool> done{false};
+    bool accept_cancelled = false;
+    bool read_cancelled = false;
+
+    auto connect = [&]() -> Task<void> {
+        co_await client.connect("127.0.0.1", port);  // 连接保持打开，不发送数据
+    };
+    auto server = [&]() -> Task<void> {
+        auto pending = listener.accept();
+        pending.set_stop_token(stop_accept.get_token());
+        try {
+            co_await pending;
+        } catch (const OperationCancelled&) {
+            accept_cancelled = true;
+        }
+
+        loop.spawn(connect());
+        AsyncSocket conn = co_await listener.accept();
+        auto read = conn.read();
+        read.set_stop_token(stop_read.get_token());
+        loop.add_timer(milliseconds(20), [&] { stop_read.request_stop(); });
+        try {
+            co_await read;
+        } catch (const OperationCancelled&) {
+            read_cancelled = true;
+        }
+        done = true;
+        loop.stop();
+    };
+    loop.spawn(server());
+
+    std::thread other([&] {
+        std::this_thread::sleep_for(milliseconds(20));
+        stop_accept.request_stop();
+        for (int i = 0; i < 200 && !done; ++i) {
+            std::this_thread::sleep_for(milliseconds(10));
+        }
+        loop.stop();
+    });
+    loop.run();
+    other.join();
+
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(accept_cancelled);
+    EXPECT_TRUE(read_cancelled);
+}
+
+// 对端以 RST 关闭连接：两种后端的 read 都抛出携带 errno 的 std::system_error
+TEST_P(EchoBackendTest, ReadErrorCarriesErrno) {
+    EventLoop loop(GetParam());
+    const int port = GetParam() == IoBackend::Epoll ? 12359 : 12360;
+
+    AsyncSocket listener(loop);
+    listener.create();
+    listener.set_reuse_addr(true);
+    listener.bind("127.0.0.1", port);
+    listener.listen();
+    AsyncSocket client(loop);
+
+    int error = 0;
+    bool done = false;
+
+    auto reset = [&]() -> Task<void> {
+        co_await client.connect("127.0.0.1", port);
+        linger lg{1, 0};
+        setsockopt(client.fd(), SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+        client.close();  // 零超时 linger：close 发送 RST
+    };
+    auto server = [&]() -> Task<void> {
+        loop.spawn(reset());
+        AsyncSocket conn = co_await listener.accept();
+        try {
+            co_await conn.read();
+        } catch (const std::system_error& e) {
+            error = e.code().value();
+        }
+        done = true;
+        loop.stop();
+    };
+    loop.spawn(server());
+    loop.run();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(error, ECONNRESET);
+}
+
+// 逐行回显：读缓冲很小，行和分隔符跨越环形缓冲区的回绕点；
+// 客户端同一轮的 10 次写入合并成一次 writev，大块数据绕过缓冲区
+TEST_P(EchoBackendTest, BufferedStreams) {
+    EventLoop loop(GetParam());
+    const int port = GetParam() == IoBackend::Epoll ? 12354 : 12355;
+
+    AsyncSocket listener(loop);
+    listener.create();
+    listener.set_reuse_addr(true);
+    listener.bind("127.0.0.1", port);
+    listener.listen();
+
+    std::atomic<bool> done{false};
+    std::vector<std::string> replies;
+    std::string payload(1000, 'x');
+    std::string payload_reply(payload.size(), '\0');
+    uint64_t client_flushes = 0;
+
+    auto server = [&]() -> Task<void> {
+        AsyncSocket conn = co_await listener.accept();
+        BufferedReader reader(conn, 16);
+        BufferedWriter writer(conn, 256);
+        std::string line;
+        while (co_await reader.read_until(line, "\r\n")) {
+            if (line == "payload\r\n") {
+                std::string data(payload.size(), '\0');
+                size_t n = co_await reader.read_exact(std::as_writable_bytes(std::span(data)));
+                EXPECT_EQ(n, data.size());
+                co_await writer.write(data);
+                break;
+            }
+            co_await writer.write(line);
+        }
+        co_await writer.flush();
+    };
+    auto client = [&]() -> Task<void> {
+        AsyncSocket sock(loop);
+        co_await sock.connect("127.0.0.1", port);
+        BufferedReader reader(sock);
+        BufferedWriter writer(sock);
+
+        for (int i = 0; i < 10; ++i) {
+            co_await writer.write("line " + std::to_string(i) + "\r\n");
+        }
+        co_await writer.flush();
+        client_flushes = writer.flush_count();
+
+        std::string line;
+        for (int i = 0; i < 10; ++i) {
+            if (!co_await reader.read_until(line, "\r\n")) {
+                break;
+            }
+            replies.push_back(line);
+        }
+
+        writer.cork();
+        co_await writer.write("payload\r\n");
+        co_await writer.write(payload);
+        writer.uncork();
+        co_await writer.flush();
+        co_await reader.read_exact(std::as_writable_bytes(std::span(payload_reply)));
+        done = true;
+        loop.stop();
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    std::thread watchdog([&] {
+        for (int i = 0; i < 200 && !done; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        loop.stop();
+    });
+    loop.run();
+    watchdog.join();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(client_flushes, 1u);
+    ASSERT_EQ(replies.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(replies[i], "line " + std::to_string(i) + "\r\n");
+    }
+    EXPECT_EQ(payload_reply, payload);
+}
+
+// 文件比 socket 缓冲区大得多：发送端多次等待可写后从中断处继续
+TEST_P(EchoBackendTest, SendFile) {
+    EventLoop loop(GetParam());
+    const int port = GetParam() == IoBackend::Epoll ? 12356 : 12357;
+    const std::string path = "/tmp/zlcoro_test_sendfile_" + std::to_string(port);
+
+    std::string content(4 << 20, '\0');
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+
+    AsyncSocket listener(loop);
+    listener.create();
+    listener.set_reuse_addr(true);
+    listener.bind("127.0.0.1", port);
+    listener.listen();
+
+    std::atomic<bool> done{false};
+    size_t sent = 0;
+    std::string received;
+
+    auto server = [&]() -> Task<void> {
+        AsyncSocket conn = co_await listener.accept();
+        AsyncFile file(path);
+        sent = co_await send_file(conn, file, 100, content.size());  // 超出文件末尾
+    };
+    auto client = [&]() -> Task<void> {
+        AsyncSocket sock(loop);
+        co_await sock.connect("127.0.0.1", port);
+        std::vector<std::byte> buffer(65536);
+        while (true) {
+            size_t n = co_await sock.read(std::span(buffer));
+            if (n == 0) {
+                break;   // 服务端发送完后关闭连接
+            }
+            received.append(reinterpret_cast<const char*>(buffer.data()), n);
+        }
+        done = true;
+        loop.stop();
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    std::thread watchdog([&] {
+        for (int i = 0; i < 500 && !done; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        loop.stop();
+    });
+    loop.run();
+    watchdog.join();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(sent, content.size() - 100);
+    EXPECT_TRUE(received == content.substr(100));
+    std::filesystem::remove(path);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, EchoBackendTest,
+                         ::testing::Values(IoBackend::Epoll, IoBackend::IoUring));
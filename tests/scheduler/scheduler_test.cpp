@@ -1,15 +1,48 @@
 #include "zlcoro/scheduler/thread_pool.hpp"
+#include "zlcoro/scheduler/work_stealing_queue.hpp"
+#include "zlcoro/scheduler/mpmc_queue.hpp"
 #include "zlcoro/scheduler/scheduler.hpp"
 #include "zlcoro/scheduler/async.hpp"
+#include "zlcoro/scheduler/blocking_pool.hpp"
+#include "zlcoro/scheduler/when_all.hpp"
 #include "zlcoro/core/task.hpp"
 #include <gtest/gtest.h>
 #include <atomic>
 #include <chrono>
 #include <thread>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
 
 using namespace zlcoro;
 
+// =============================================================================
+// 全局分配计数（用于验证协程恢复路径不做堆分配）
+// =============================================================================
+
+static std::atomic<size_t> g_allocations{0};
+
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
 // 辅助协程函数（避免 lambda 生命周期问题）
 Task<void> increment_counter(std::shared_ptr<std::atomic<int>> counter) {
     (*counter)++;
@@ -85,6 +118,410 @@ TEST(ThreadPoolTest, Shutdown) {
     EXPECT_EQ(counter.load(), 1);
 }
 
+TEST(ThreadPoolTest, MetricsSnapshot) {
+    ThreadPool pool(2);
+    std::atomic<int> counter{0};
+
+    for (int i = 0; i < 50; ++i) {
+        pool.submit([&counter] { counter++; });
+    }
+    while (counter.load() < 50) {
+        std::this_thread::yield();
+    }
+    // 等工作线程休眠，休眠次数和空闲时间才会增加
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto metrics = pool.metrics();
+    ASSERT_EQ(metrics.workers.size(), 2u);
+    uint64_t tasks_run = 0;
+    uint64_t parks = 0;
+    for (const auto& worker : metrics.workers) {
+        tasks_run += worker.tasks_run;
+        parks += worker.parks;
+    }
+    if constexpr (metrics_enabled) {
+        EXPECT_EQ(tasks_run, 50u);
+        EXPECT_GT(parks, 0u);
+    }
+    EXPECT_EQ(metrics.pending_tasks, 0u);
+
+    auto text = metrics.to_prometheus();
+    EXPECT_NE(text.find("# TYPE zlcoro_thread_pool_tasks_run_total counter"), std::string::npos);
+    EXPECT_NE(text.find("zlcoro_thread_pool_tasks_run_total{worker=\"1\"}"), std::string::npos);
+}
+
+TEST(MetricsTest, HistogramQuantilesAndExport) {
+    MetricHistogram histogram;
+    for (uint64_t v = 1; v <= 100; ++v) {
+        histogram.record(v);
+    }
+    auto snapshot = histogram.snapshot();
+    if constexpr (metrics_enabled) {
+        EXPECT_EQ(snapshot.count, 100u);
+        EXPECT_EQ(snapshot.sum, 5050u);
+        EXPECT_EQ(snapshot.quantile(0.5), 64u);   // 50 落在 (32, 64]
+        EXPECT_EQ(snapshot.quantile(1.0), 128u);  // 100 落在 (64, 128]
+    }
+
+    std::string text;
+    append_prometheus_header(text, "latency_seconds", "histogram");
+    append_prometheus_histogram(text, "latency_seconds", "", snapshot, 1e-9);
+    EXPECT_NE(text.find("latency_seconds_bucket{le=\"+Inf\"}"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_count"), std::string::npos);
+}
+
+TEST(ThreadPoolTest, PinnedWorkersRunOnConfiguredCpu) {
+    int cpu = available_cpus().front();
+    ThreadPoolOptions options;
+    options.num_threads = 2;
+    options.cpus = {cpu};
+    ThreadPool pool(options);
+
+    EXPECT_EQ(pool.thread_count(), 2u);
+    EXPECT_EQ(pool.worker_cpu(0), cpu);
+    EXPECT_EQ(pool.worker_cpu(1), cpu);
+
+    std::atomic<int> done{0};
+    std::atomic<int> wrong_cpu{0};
+    for (int i = 0; i < 20; ++i) {
+        pool.submit([&] {
+            if (sched_getcpu() != cpu) {
+                wrong_cpu++;
+            }
+            done++;
+        });
+    }
+    while (done.load() < 20) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(wrong_cpu.load(), 0);
+}
+
+TEST(ThreadPoolTest, NumaNodesStealLocalFirstThenRemote) {
+    ThreadPoolOptions options;
+    options.num_threads = 4;
+    options.numa_nodes = {0, 0, 1, 1};
+    ThreadPool pool(options);
+
+    EXPECT_EQ(pool.worker_numa_node(1), 0);
+    EXPECT_EQ(pool.worker_numa_node(2), 1);
+    EXPECT_EQ(pool.worker_cpu(0), -1);
+
+    // 所有子任务都在一个工作线程的本地队列中：其他节点的线程也能窃取到
+    constexpr int N = 100;
+    std::atomic<int> done{0};
+    auto child = [&]() -> Task<void> {
+        done++;
+        co_return;
+    };
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < N; ++i) {
+        tasks.push_back(child());
+    }
+    pool.submit([&] {
+        for (auto& task : tasks) {
+            pool.submit(task.handle());
+        }
+    });
+    for (int i = 0; i < 500 && done.load() < N; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(done.load(), N);
+    pool.shutdown();
+}
+
+TEST(ThreadPoolTest, SpinningWorkerSkipsWakeup) {
+    ThreadPoolOptions options;
+    options.num_threads = 1;
+    options.spin_time = std::chrono::milliseconds(200);
+    ThreadPool pool(options);
+
+    // 一问一答：每个任务完成后才提交下一个，工作线程在间隙中自旋
+    constexpr int N = 20;
+    std::atomic<int> done{0};
+    for (int i = 0; i < N; ++i) {
+        pool.submit([&done] { done++; });
+        while (done.load() <= i) {
+            std::this_thread::yield();
+        }
+    }
+
+    auto metrics = pool.metrics();
+    if constexpr (metrics_enabled) {
+        EXPECT_LT(metrics.wakeups, static_cast<uint64_t>(N / 2));
+    }
+    pool.shutdown();
+}
+
+TEST(ThreadPoolTest, SpinThenParkUnderLoad) {
+    ThreadPoolOptions options;
+    options.num_threads = 4;
+    options.spin_time = std::chrono::microseconds(50);
+    ThreadPool pool(options);
+
+    for (int round = 0; round < 20; ++round) {
+        constexpr int N = 100;
+        std::atomic<int> done{0};
+        for (int i = 0; i < N; ++i) {
+            pool.submit([&done] { done++; });
+        }
+        while (done.load() < N) {
+            std::this_thread::yield();
+        }
+        // 让部分线程进入休眠，下一轮需要重新唤醒
+        if (round % 4 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    pool.shutdown();
+}
+
+TEST(ThreadPoolTest, DeadlinesThenPriorityLanes) {
+    ThreadPoolOptions options;
+    options.num_threads = 1;
+    options.starvation_interval = 0;  // 严格按优先级
+    ThreadPool pool(options);
+
+    // 先用一个可调用对象占住唯一的工作线程，再按与期望相反的顺序提交
+    std::atomic<bool> release{false};
+    std::atomic<bool> blocked{false};
+    pool.submit([&] {
+        blocked = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!blocked.load()) {
+        std::this_thread::yield();
+    }
+
+    std::vector<int> order;
+    std::atomic<int> done{0};
+    auto record = [&](int id) -> Task<void> {
+        order.push_back(id);
+        done++;
+        co_return;
+    };
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<Task<void>> tasks;
+    for (int id : {5, 4, 3, 2, 1}) {
+        tasks.push_back(record(id));
+    }
+    pool.submit(tasks[0].handle(), TaskPriority::Low);
+    pool.submit(tasks[1].handle(), TaskPriority::Normal);
+    pool.submit(tasks[2].handle(), TaskPriority::High);
+    pool.submit_before(tasks[3].handle(), now + std::chrono::seconds(2));
+    pool.submit_before(tasks[4].handle(), now + std::chrono::seconds(1));
+
+    release = true;
+    while (done.load() < 5) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4, 5}));
+    pool.shutdown();
+}
+
+TEST(ThreadPoolTest, StarvationIntervalLetsLowPriorityRun) {
+    ThreadPoolOptions options;
+    options.num_threads = 1;
+    options.starvation_interval = 4;
+    ThreadPool pool(options);
+
+    std::atomic<bool> release{false};
+    std::atomic<bool> blocked{false};
+    pool.submit([&] {
+        blocked = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!blocked.load()) {
+        std::this_thread::yield();
+    }
+
+    constexpr int N = 20;
+    std::vector<int> order;
+    std::atomic<int> done{0};
+    auto record = [&](int id) -> Task<void> {
+        order.push_back(id);
+        done++;
+        co_return;
+    };
+
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < N; ++i) {
+        tasks.push_back(record(i));
+        pool.submit(tasks.back().handle(), TaskPriority::High);
+    }
+    tasks.push_back(record(-1));
+    pool.submit(tasks.back().handle(), TaskPriority::Low);
+
+    release = true;
+    while (done.load() < N + 1) {
+        std::this_thread::yield();
+    }
+    // 第 4 次调度（占位任务之后的第 3 个）反过来先找 Low 通道
+    auto pos = std::find(order.begin(), order.end(), -1) - order.begin();
+    EXPECT_EQ(pos, 2);
+    pool.shutdown();
+}
+
+TEST(ThreadPoolTest, NumaNodeOfCpuReadsSysfs) {
+    EXPECT_GE(numa_node_of_cpu(available_cpus().front()), 0);
+    EXPECT_EQ(numa_node_of_cpu(1 << 20), 0);  // 不存在的 CPU
+}
+
+// =============================================================================
+// WorkStealingQueue 测试
+// =============================================================================
+
+TEST(WorkStealingQueueTest, OwnerPopIsLifo) {
+    WorkStealingQueue<int*> queue;
+    int values[3] = {1, 2, 3};
+
+    for (auto& v : values) {
+        queue.push(&v);
+    }
+
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(*queue.pop(), &values[2]);
+    EXPECT_EQ(*queue.pop(), &values[1]);
+    EXPECT_EQ(*queue.pop(), &values[0]);
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(WorkStealingQueueTest, StealIsFifo) {
+    WorkStealingQueue<int*> queue;
+    int values[3] = {1, 2, 3};
+
+    for (auto& v : values) {
+        queue.push(&v);
+    }
+
+    EXPECT_EQ(*queue.steal(), &values[0]);
+    EXPECT_EQ(*queue.steal(), &values[1]);
+    EXPECT_EQ(*queue.pop(), &values[2]);
+    EXPECT_FALSE(queue.steal().has_value());
+}
+
+TEST(WorkStealingQueueTest, GrowsBeyondInitialCapacity) {
+    WorkStealingQueue<size_t> queue(4);
+
+    for (size_t i = 0; i < 1000; ++i) {
+        queue.push(i);
+    }
+
+    EXPECT_GE(queue.capacity(), 1000);
+    for (size_t i = 1000; i-- > 0;) {
+        EXPECT_EQ(*queue.pop(), i);
+    }
+}
+
+TEST(WorkStealingQueueTest, ConcurrentStealersSeeEachItemOnce) {
+    WorkStealingQueue<size_t> queue(16);
+    constexpr size_t N = 100000;
+
+    std::atomic<bool> producing{true};
+    std::vector<std::atomic<int>> seen(N);
+    std::atomic<size_t> taken{0};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            while (producing || !queue.empty()) {
+                if (auto item = queue.steal()) {
+                    seen[*item]++;
+                    taken++;
+                }
+            }
+        });
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        queue.push(i);
+        if (i % 3 == 0) {
+            if (auto item = queue.pop()) {
+                seen[*item]++;
+                taken++;
+            }
+        }
+    }
+    producing = false;
+
+    for (auto& t : thieves) {
+        t.join();
+    }
+    while (auto item = queue.pop()) {
+        seen[*item]++;
+        taken++;
+    }
+
+    EXPECT_EQ(taken.load(), N);
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "item " << i;
+    }
+}
+
+// =============================================================================
+// BoundedMpmcQueue 测试
+// =============================================================================
+
+TEST(BoundedMpmcQueueTest, FifoAndCapacity) {
+    BoundedMpmcQueue<int> queue(4);
+
+    EXPECT_EQ(queue.capacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(99));  // 满
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(*queue.try_pop(), i);
+    }
+    EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(BoundedMpmcQueueTest, ConcurrentProducersConsumers) {
+    BoundedMpmcQueue<size_t> queue(64);
+    constexpr size_t PerProducer = 5000;
+    constexpr size_t Producers = 3;
+
+    std::atomic<size_t> sum{0};
+    std::atomic<size_t> count{0};
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < Producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < PerProducer; ++i) {
+                size_t v = p * PerProducer + i;
+                while (!queue.try_push(v)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            while (count.load() < Producers * PerProducer) {
+                if (auto v = queue.try_pop()) {
+                    sum += *v;
+                    count++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    size_t n = Producers * PerProducer;
+    EXPECT_EQ(count.load(), n);
+    EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+}
+
 // =============================================================================
 // Scheduler 测试
 // =============================================================================
@@ -103,6 +540,11 @@ TEST(SchedulerTest, BasicSchedule) {
     EXPECT_TRUE(executed.load());
 }
 
+TEST(SchedulerTest, ConfigureAfterCreationThrows) {
+    Scheduler::instance();
+    EXPECT_THROW(Scheduler::configure(ThreadPoolOptions{}), std::logic_error);
+}
+
 TEST(SchedulerTest, CoroutineSchedule) {
     std::atomic<int> value{0};
     std::atomic<bool> done{false};
@@ -121,6 +563,111 @@ TEST(SchedulerTest, CoroutineSchedule) {
     EXPECT_TRUE(done.load());
 }
 
+TEST(SchedulerTest, WorkerSpawnedCoroutinesAreStolen) {
+    ThreadPool pool(4);
+
+    constexpr int N = 200;
+    std::atomic<int> done{0};
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    auto child = [&]() -> Task<void> {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        }
+        done++;
+        co_return;
+    };
+
+    std::vector<Task<void>> tasks;
+    tasks.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        tasks.push_back(child());
+    }
+
+    // 从一个工作线程内部提交：全部进入该线程的本地队列，其他线程只能靠窃取
+    pool.submit([&] {
+        for (auto& task : tasks) {
+            pool.submit(task.handle());
+        }
+    });
+
+    for (int i = 0; i < 500 && done.load() < N; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    EXPECT_EQ(done.load(), N);
+    EXPECT_GT(threads.size(), 1);
+    pool.shutdown();
+}
+
+// 切换到指定线程池的 awaiter（测试用）
+struct PoolHop {
+    ThreadPool& pool;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> coro) const { pool.submit(coro); }
+    void await_resume() const noexcept {}
+};
+
+TEST(SchedulerTest, ExternalResumeDoesNotAllocate) {
+    ThreadPool pool(2);
+
+    constexpr int N = 512;
+    std::atomic<int> done{0};
+
+    auto body = [&]() -> Task<void> {
+        done++;
+        co_return;
+    };
+
+    std::vector<Task<void>> tasks;
+    tasks.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        tasks.push_back(body());
+    }
+
+    size_t before = g_allocations.load();
+    for (auto& task : tasks) {
+        pool.submit(task.handle());
+    }
+    while (done.load() < N) {
+        std::this_thread::yield();
+    }
+    size_t after = g_allocations.load();
+
+    EXPECT_EQ(after - before, 0u);
+    pool.shutdown();
+}
+
+TEST(SchedulerTest, WorkerResumeDoesNotAllocate) {
+    ThreadPool pool(2);
+
+    std::atomic<size_t> allocations{~size_t{0}};
+    std::atomic<bool> done{false};
+
+    auto body = [&]() -> Task<void> {
+        co_await PoolHop{pool};  // 先切到工作线程
+        size_t before = g_allocations.load();
+        for (int i = 0; i < 10000; ++i) {
+            co_await PoolHop{pool};
+        }
+        allocations = g_allocations.load() - before;
+        done = true;
+    };
+
+    auto task = body();
+    task.handle().resume();
+    while (!done.load()) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_EQ(allocations.load(), 0u);
+    pool.shutdown();
+}
+
 // =============================================================================
 // ScheduleAwaiter 测试
 // =============================================================================
@@ -146,6 +693,92 @@ TEST(ScheduleAwaiterTest, CoAwaitSchedule) {
     EXPECT_EQ(step.load(), 2);
 }
 
+TEST(ScheduleAwaiterTest, PriorityAndDeadline) {
+    auto task = []() -> Task<int> {
+        co_await schedule(TaskPriority::High);
+        bool on_worker = Scheduler::instance().thread_pool().is_worker_thread();
+        co_await schedule(TaskPriority::Low);
+        co_await schedule_before(std::chrono::steady_clock::now() + std::chrono::milliseconds(1));
+        co_return on_worker && Scheduler::instance().thread_pool().is_worker_thread() ? 1 : 0;
+    };
+
+    EXPECT_EQ(task().sync_wait(), 1);
+}
+
+TEST(ScheduleAwaiterTest, SkipsHopOnWorker) {
+    EXPECT_FALSE(schedule().await_ready());  // 测试线程不是工作线程
+
+    auto task = []() -> Task<bool> {
+        co_await schedule();
+        // 已经在工作线程上：不挂起，也不需要入队
+        co_return schedule().await_ready() &&
+                  Executor::current() == &Scheduler::instance().thread_pool();
+    };
+    EXPECT_TRUE(task().sync_wait());
+}
+
+TEST(ScheduleAwaiterTest, ExplicitPriorityAlwaysRequeues) {
+    auto task = []() -> Task<bool> {
+        co_await schedule();
+        // 只有默认优先级可以跳过入队；显式优先级和截止时间要重新排序
+        bool ready = schedule().await_ready() &&
+                     !schedule(TaskPriority::Low).await_ready() &&
+                     !schedule(TaskPriority::High).await_ready() &&
+                     !schedule_before(std::chrono::steady_clock::now()).await_ready();
+        co_await schedule(TaskPriority::Low);
+        co_return ready && Scheduler::instance().thread_pool().is_worker_thread();
+    };
+    EXPECT_TRUE(task().sync_wait());
+}
+
+TEST(ScheduleAwaiterTest, YieldLetsQueuedWorkRunFirst) {
+    ThreadPool pool(1);
+    std::vector<std::string> order;
+    std::atomic<bool> done{false};
+
+    auto other = [&]() -> Task<void> {
+        order.push_back("other");
+        co_return;
+    };
+    auto other_task = other();
+
+    auto body = [&]() -> Task<void> {
+        co_await resume_on(pool);
+        order.push_back("before");
+        pool.submit(other_task.handle());  // 进入本地队列
+        co_await yield();                  // 排到 other 之后
+        order.push_back("after");
+        done = true;
+    };
+    auto task = body();
+    task.handle().resume();
+
+    while (!done.load()) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"before", "other", "after"}));
+    pool.shutdown();
+}
+
+TEST(ScheduleAwaiterTest, ResumeOnNewThreadReusesIdleThread) {
+    auto& dedicated = detail::DedicatedThreadPool::instance();
+    auto hop = []() -> Task<std::thread::id> {
+        co_await resume_on_new_thread();
+        co_return std::this_thread::get_id();
+    };
+
+    auto first = hop().sync_wait();
+    EXPECT_NE(first, std::this_thread::get_id());
+    for (int i = 0; i < 1000 && dedicated.idle_threads() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    size_t created = dedicated.threads_created();
+
+    auto second = hop().sync_wait();
+    EXPECT_EQ(second, first);  // 复用同一个空闲线程
+    EXPECT_EQ(dedicated.threads_created(), created);
+}
+
 // =============================================================================
 // async_run 测试
 // =============================================================================
@@ -213,6 +846,77 @@ TEST(AsyncRunTest, ChainedCoroutines) {
     EXPECT_EQ(result, 20);
 }
 
+TEST(AsyncRunTest, ReferenceReturn) {
+    static int value = 7;
+    auto coro = []() -> Task<int&> {
+        co_return value;
+    };
+    
+    int& result = async_run(coro()).get();
+    EXPECT_EQ(&result, &value);
+}
+
+TEST(AsyncRunTest, DroppedHandleDetaches) {
+    // JoinHandle 在任务完成前析构：任务继续执行，结束后自行销毁
+    std::atomic<bool> release{false};
+    std::atomic<bool> finished{false};
+    
+    auto coro = [&]() -> Task<void> {
+        co_await spawn_blocking([&] {
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+        finished = true;
+    };
+    
+    {
+        auto handle = async_run(coro());
+        EXPECT_FALSE(handle.is_ready());
+    }
+    release = true;
+    
+    for (int i = 0; i < 1000 && !finished.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(finished.load());
+}
+
+TEST(AsyncRunTest, GetThenDropRacesCompletion) {
+    // get() 返回后立即析构 JoinHandle，与驱动协程的唤醒并发：
+    // 帧必须等驱动协程唤醒完等待者之后才销毁（在 ASan/TSan 构建下才能暴露）
+    auto coro = [](int i) -> Task<int> {
+        co_return i;
+    };
+    for (int i = 0; i < 2000; ++i) {
+        EXPECT_EQ(async_run(coro(i)).get(), i);
+    }
+}
+
+TEST(SyncWaitTest, BlocksUntilResumedOnWorker) {
+    // 协程挂起后在工作线程上恢复，sync_wait 阻塞等待而不是自己恢复它
+    auto coro = []() -> Task<std::thread::id> {
+        co_await schedule();
+        co_return std::this_thread::get_id();
+    };
+    
+    auto task = coro();
+    auto worker = task.sync_wait();
+    EXPECT_NE(worker, std::this_thread::get_id());
+}
+
+TEST(SyncWaitTest, ReturnRacesCompletionOnWorker) {
+    // 工作线程设置完成标志后、notify 之前，sync_wait 可能已经返回并析构
+    // 通知协程：帧必须等 notify 之后才销毁（在 ASan/TSan 构建下才能暴露）
+    auto coro = [](int i) -> Task<int> {
+        co_await schedule();
+        co_return i;
+    };
+    for (int i = 0; i < 2000; ++i) {
+        EXPECT_EQ(coro(i).sync_wait(), i);
+    }
+}
+
 // =============================================================================
 // 并发测试
 // =============================================================================
@@ -220,7 +924,7 @@ TEST(AsyncRunTest, ChainedCoroutines) {
 TEST(ConcurrentTest, MultipleTasks) {
     // 使用 shared_ptr 确保 counter 的生命周期
     auto counter = std::make_shared<std::atomic<int>>(0);
-    std::vector<std::future<void>> futures;
+    std::vector<JoinHandle<void>> futures;
     
     for (int i = 0; i < 10; ++i) {
         // 使用独立的协程函数，避免 lambda 生命周期问题
@@ -239,7 +943,7 @@ TEST(ConcurrentTest, HeavyLoad) {
     
     // 使用 shared_ptr 确保生命周期正确
     auto completed = std::make_shared<std::atomic<int>>(0);
-    std::vector<std::future<void>> futures;
+    std::vector<JoinHandle<void>> futures;
     
     const int N = 10;
     futures.reserve(N);
@@ -258,3 +962,155 @@ TEST(ConcurrentTest, HeavyLoad) {
     // 验证所有任务都执行了
     EXPECT_EQ(completed->load(), N);
 }
+
+// =============================================================================
+// when_all / when_any 测试
+// =============================================================================
+
+TEST(WhenAllTest, MixedTypes) {
+    std::atomic<bool> void_ran{false};
+    auto number = []() -> Task<int> { co_return 1; };
+    auto text = []() -> Task<std::string> {
+        co_await schedule();
+        co_return "two";
+    };
+    auto nothing = [&]() -> Task<void> {
+        void_ran = true;
+        co_return;
+    };
+    
+    auto coro = [&]() -> Task<int> {
+        auto [a, b, c] = co_await when_all(number(), text(), nothing());
+        (void)c;
+        co_return a + static_cast<int>(b.size());
+    };
+    
+    EXPECT_EQ(async_run(coro()).get(), 4);
+    EXPECT_TRUE(void_ran.load());
+}
+
+TEST(WhenAllTest, VectorKeepsOrder) {
+    auto square = [](int x) -> Task<int> { co_return x * x; };
+    
+    auto coro = [&]() -> Task<std::vector<int>> {
+        std::vector<Task<int>> tasks;
+        for (int i = 0; i < 20; ++i) {
+            tasks.push_back(square(i));
+        }
+        co_return co_await when_all(std::move(tasks));
+    };
+    
+    auto results = async_run(coro()).get();
+    ASSERT_EQ(results.size(), 20u);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(results[i], i * i);
+    }
+}
+
+TEST(WhenAllTest, ExceptionAfterAllComplete) {
+    auto completed = std::make_shared<std::atomic<int>>(0);
+    auto ok = [](std::shared_ptr<std::atomic<int>> done) -> Task<void> {
+        ++*done;
+        co_return;
+    };
+    auto fail = []() -> Task<void> {
+        throw std::runtime_error("child failed");
+        co_return;
+    };
+    
+    auto coro = [&]() -> Task<void> {
+        std::vector<Task<void>> tasks;
+        tasks.push_back(ok(completed));
+        tasks.push_back(fail());
+        tasks.push_back(ok(completed));
+        co_await when_all(std::move(tasks));
+    };
+    
+    EXPECT_THROW(async_run(coro()).get(), std::runtime_error);
+    EXPECT_EQ(completed->load(), 2);
+}
+
+TEST(WhenAnyTest, FirstFinisherWins) {
+    auto slow = []() -> Task<int> {
+        co_await spawn_blocking([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        });
+        co_return 1;
+    };
+    auto fast = []() -> Task<int> { co_return 2; };
+    
+    auto coro = [&]() -> Task<WhenAnyResult<int>> {
+        co_return co_await when_any(slow(), fast());
+    };
+    
+    auto first = async_run(coro()).get();
+    EXPECT_EQ(first.index, 1u);
+    EXPECT_EQ(first.value, 2);
+    
+    // 失败的子任务继续执行到结束后自行销毁
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+// =============================================================================
+// BlockingPool 测试
+// =============================================================================
+
+TEST(BlockingPoolTest, SpawnBlockingRunsOffWorker) {
+    auto coro = []() -> Task<bool> {
+        auto caller = std::this_thread::get_id();
+        auto blocking_thread = co_await spawn_blocking([] {
+            return std::this_thread::get_id();
+        });
+        // 阻塞任务在专用线程上执行，完成后回到调度器
+        co_return blocking_thread != caller &&
+                  Scheduler::instance().thread_pool().is_worker_thread();
+    };
+
+    EXPECT_TRUE(async_run(coro()).get());
+}
+
+TEST(BlockingPoolTest, ExceptionPropagation) {
+    auto coro = []() -> Task<void> {
+        co_await spawn_blocking([] { throw std::runtime_error("blocking error"); });
+    };
+
+    EXPECT_THROW(async_run(coro()).get(), std::runtime_error);
+}
+
+TEST(BlockingPoolTest, SubmitAfterShutdownIsRejected) {
+    BlockingPool pool(1);
+    pool.shutdown();
+    EXPECT_FALSE(pool.submit([] {}));
+
+    // 挂起的协程不会被遗忘：co_await 直接抛出
+    bool ran = false;
+    auto coro = [&]() -> Task<void> {
+        co_await spawn_blocking(pool, [&] { ran = true; });
+    };
+    EXPECT_THROW(async_run(coro()).get(), std::runtime_error);
+    EXPECT_FALSE(ran);
+}
+
+TEST(BlockingPoolTest, GrowsUpToMaxThreads) {
+    BlockingPool pool(2);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> done{0};
+
+    for (int i = 0; i < 6; ++i) {
+        pool.submit([&] {
+            int now = ++running;
+            int expected = peak.load();
+            while (now > expected && !peak.compare_exchange_weak(expected, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            --running;
+            ++done;
+        });
+    }
+    pool.shutdown();  // 执行完已排队的任务
+
+    EXPECT_EQ(done.load(), 6);
+    EXPECT_LE(peak.load(), 2);
+    EXPECT_EQ(pool.thread_count(), 2u);
+}
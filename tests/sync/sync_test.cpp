@@ -0,0 +1,338 @@
+#include "zlcoro/sync.hpp"
+#include "zlcoro/io/event_loop.hpp"
+#include "zlcoro/scheduler/async.hpp"
+#include "zlcoro/scheduler/scheduler.hpp"
+#include "zlcoro/scheduler/when_all.hpp"
+#include "zlcoro/core/task.hpp"
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace zlcoro;
+
+// 在调用线程中启动协程，执行到第一个挂起点；协程帧由 keep 持有
+namespace {
+
+void run_inline(Task<void> task, std::vector<Task<void>>& keep) {
+    task.handle().resume();
+    keep.push_back(std::move(task));
+}
+
+} // namespace
+
+// =============================================================================
+// AsyncMutex 测试
+// =============================================================================
+
+TEST(AsyncMutexTest, TryLockAndUnlock) {
+    AsyncMutex mutex;
+    EXPECT_TRUE(mutex.try_lock());
+    EXPECT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(AsyncMutexTest, FifoHandoff) {
+    AsyncMutex mutex;
+    std::vector<int> order;
+    std::vector<Task<void>> tasks;
+
+    auto locker = [&](int id) -> Task<void> {
+        co_await mutex.lock();
+        order.push_back(id);
+        mutex.unlock();
+    };
+
+    ASSERT_TRUE(mutex.try_lock());
+    for (int i = 0; i < 4; ++i) {
+        run_inline(locker(i), tasks);  // 锁被占用：依次挂起
+    }
+    EXPECT_TRUE(order.empty());
+
+    // 解锁后按到达顺序交接
+    mutex.unlock();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(AsyncMutexTest, ExclusionAcrossWorkers) {
+    AsyncMutex mutex;
+    int counter = 0;  // 只在锁内访问，不需要原子
+    constexpr int tasks_count = 16;
+    constexpr int iterations = 200;
+
+    auto worker = [&]() -> Task<void> {
+        for (int i = 0; i < iterations; ++i) {
+            auto lock = co_await mutex.scoped_lock();
+            int value = counter;
+            co_await yield();  // 持有锁时挂起，让其他协程先运行
+            counter = value + 1;
+        }
+    };
+
+    auto coro = [&]() -> Task<void> {
+        std::vector<Task<void>> tasks;
+        for (int i = 0; i < tasks_count; ++i) {
+            tasks.push_back(worker());
+        }
+        co_await when_all(std::move(tasks));
+    };
+
+    async_run(coro()).get();
+    EXPECT_EQ(counter, tasks_count * iterations);
+}
+
+// =============================================================================
+// AsyncSemaphore 测试
+// =============================================================================
+
+TEST(AsyncSemaphoreTest, LimitsConcurrency) {
+    AsyncSemaphore slots(3);
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+
+    auto worker = [&]() -> Task<void> {
+        co_await slots.acquire();
+        int now = ++active;
+        int expected = peak.load();
+        while (now > expected && !peak.compare_exchange_weak(expected, now)) {
+        }
+        co_await yield();
+        --active;
+        slots.release();
+    };
+
+    auto coro = [&]() -> Task<void> {
+        std::vector<Task<void>> tasks;
+        for (int i = 0; i < 32; ++i) {
+            tasks.push_back(worker());
+        }
+        co_await when_all(std::move(tasks));
+    };
+
+    async_run(coro()).get();
+    EXPECT_LE(peak.load(), 3);
+    EXPECT_EQ(slots.available(), 3u);
+}
+
+TEST(AsyncSemaphoreTest, ReleaseWakesWaitersInOrder) {
+    AsyncSemaphore semaphore(0);
+    std::vector<int> order;
+    std::vector<Task<void>> tasks;
+
+    auto waiter = [&](int id) -> Task<void> {
+        co_await semaphore.acquire();
+        order.push_back(id);
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        run_inline(waiter(i), tasks);
+    }
+    EXPECT_TRUE(order.empty());
+
+    semaphore.release(2);
+    EXPECT_EQ(order, (std::vector<int>{0, 1}));
+    semaphore.release(2);  // 一个交给等待者，一个留作许可
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(semaphore.available(), 1u);
+}
+
+// =============================================================================
+// AsyncManualResetEvent / AsyncLatch 测试
+// =============================================================================
+
+TEST(AsyncEventTest, SetResumesAllWaiters) {
+    AsyncManualResetEvent event;
+    int resumed = 0;
+    std::vector<Task<void>> tasks;
+
+    auto waiter = [&]() -> Task<void> {
+        co_await event;
+        ++resumed;
+    };
+
+    run_inline(waiter(), tasks);
+    run_inline(waiter(), tasks);
+    EXPECT_EQ(resumed, 0);
+    EXPECT_FALSE(event.is_set());
+
+    event.set();
+    EXPECT_EQ(resumed, 2);
+
+    // 已设置：直接通过
+    run_inline(waiter(), tasks);
+    EXPECT_EQ(resumed, 3);
+
+    event.reset();
+    run_inline(waiter(), tasks);
+    EXPECT_EQ(resumed, 3);
+    event.set();
+    EXPECT_EQ(resumed, 4);
+}
+
+TEST(AsyncLatchTest, ResumesWhenCountReachesZero) {
+    AsyncLatch latch(3);
+    std::atomic<bool> released{false};
+
+    auto waiter = [&]() -> Task<void> {
+        co_await latch;
+        released = true;
+    };
+    auto counter = [&]() -> Task<void> {
+        co_await schedule();
+        latch.count_down();
+    };
+
+    auto coro = [&]() -> Task<void> {
+        co_await when_all(waiter(), counter(), counter(), counter());
+    };
+
+    async_run(coro()).get();
+    EXPECT_TRUE(released.load());
+    EXPECT_TRUE(latch.is_ready());
+}
+
+// =============================================================================
+// Channel 测试
+// =============================================================================
+
+TEST(ChannelTest, TryFastPaths) {
+    Channel<int> channel(2);
+    EXPECT_EQ(channel.capacity(), 2u);
+    EXPECT_TRUE(channel.try_send(1));
+    EXPECT_TRUE(channel.try_send(2));
+    EXPECT_FALSE(channel.try_send(3));  // 满
+
+    std::array<int, 4> out{};
+    EXPECT_EQ(channel.try_recv_batch(out), 2u);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[1], 2);
+    EXPECT_FALSE(channel.try_recv().has_value());
+
+    channel.close();
+    EXPECT_FALSE(channel.try_send(4));
+}
+
+TEST(ChannelTest, CapacityBelowTwoIsRejected) {
+    // 环形队列至少 2 个槽位：容量 1 无法保证背压上限，直接拒绝
+    EXPECT_THROW(Channel<int>(0), std::invalid_argument);
+    EXPECT_THROW(Channel<int>(1), std::invalid_argument);
+
+    Channel<int> channel(3);
+    EXPECT_EQ(channel.capacity(), 4u);  // 向上取整到 2 的幂
+}
+
+TEST(ChannelTest, BackpressureKeepsOrder) {
+    // 容量远小于元素数：发送者反复因背压挂起
+    Channel<int> channel(4);
+    constexpr int count = 2000;
+    std::vector<int> received;
+
+    auto producer = [&]() -> Task<void> {
+        for (int i = 0; i < count; ++i) {
+            EXPECT_TRUE(co_await channel.send(i));
+        }
+        channel.close();
+    };
+    auto consumer = [&]() -> Task<void> {
+        std::array<int, 16> batch;
+        while (size_t n = co_await channel.recv_batch(batch)) {
+            received.insert(received.end(), batch.begin(), batch.begin() + n);
+        }
+    };
+    auto coro = [&]() -> Task<void> {
+        co_await when_all(producer(), consumer());
+    };
+
+    async_run(coro()).get();
+    ASSERT_EQ(received.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+}
+
+TEST(ChannelTest, MultiProducerMultiConsumer) {
+    Channel<int> channel(8);
+    constexpr int producers = 4;
+    constexpr int per_producer = 500;
+    std::atomic<int64_t> sum{0};
+    std::atomic<int> items{0};
+
+    auto producer = [&](int base) -> Task<void> {
+        for (int i = 0; i < per_producer; ++i) {
+            co_await channel.send(base + i);
+        }
+    };
+    auto consumer = [&]() -> Task<void> {
+        while (auto value = co_await channel.recv()) {
+            sum += *value;
+            ++items;
+        }
+    };
+    auto produce_all = [&]() -> Task<void> {
+        std::vector<Task<void>> tasks;
+        for (int p = 0; p < producers; ++p) {
+            tasks.push_back(producer(p * per_producer));
+        }
+        co_await when_all(std::move(tasks));
+        channel.close();
+    };
+    auto coro = [&]() -> Task<void> {
+        co_await when_all(produce_all(), consumer(), consumer(), consumer());
+    };
+
+    async_run(coro()).get();
+    constexpr int total = producers * per_producer;
+    EXPECT_EQ(items.load(), total);
+    EXPECT_EQ(sum.load(), static_cast<int64_t>(total) * (total - 1) / 2);
+}
+
+TEST(ChannelTest, ReceiverResumesOnItsEventLoop) {
+    EventLoop loop;
+    Channel<int> channel(4);
+    int value = 0;
+    bool on_loop = false;
+
+    auto receiver = [&]() -> Task<void> {
+        auto item = co_await channel.recv();
+        value = item.value_or(-1);
+        on_loop = loop.is_in_loop_thread();
+        loop.stop();
+    };
+    auto t = receiver();
+    loop.schedule(t.handle());
+
+    std::thread other([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        channel.try_send(7);
+    });
+    loop.run();
+    other.join();
+
+    EXPECT_EQ(value, 7);
+    EXPECT_TRUE(on_loop);
+}
+
+TEST(ChannelTest, CloseWakesWaitingReceiver) {
+    Channel<int> channel(2);
+    bool got_nullopt = false;
+
+    auto receiver = [&]() -> Task<void> {
+        got_nullopt = !(co_await channel.recv()).has_value();
+    };
+    auto closer = [&]() -> Task<void> {
+        co_await schedule();
+        channel.close();
+    };
+    auto coro = [&]() -> Task<void> {
+        co_await when_all(receiver(), closer());
+    };
+
+    async_run(coro()).get();
+    EXPECT_TRUE(got_nullopt);
+}